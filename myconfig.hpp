@@ -81,6 +81,7 @@
 //#define LB_BOUNDARIES
 //#define LB_BOUNDARIES_GPU
 //#define LB_ELECTROHYDRODYNAMICS
+//#define LB_SINGLE_PRECISION
 //#define ELECTROKINETICS
 //#define EK_BOUNDARIES
 //#define EK_REACTION
@@ -197,6 +197,48 @@ proc tune_cells { { int_steps 1000 } { min_cells 1 } { max_cells 30 } { tol_cell
     return $msg_string
 }
 
+#
+# energy_drift
+# ------------
+#
+# Integrates steps time steps in samples chunks and measures the
+# total energy after each chunk. Returns the drift of the total
+# energy per particle and unit time from a linear fit and the rms
+# fluctuation of the total energy per particle around the fit. Meant
+# to check the energy conservation of the integrator settings, e.g.
+# of the time step or setmd kspace_interval, with the thermostat off.
+#
+#############################################################
+
+proc energy_drift { steps { samples 10 } } {
+    set n [setmd n_part]
+    set chunk [expr $steps/$samples]
+    if { $chunk < 1 } { set chunk 1 }
+    set t {}
+    set e {}
+    lappend t [setmd time]
+    lappend e [expr [analyze energy total]/$n]
+    for { set i 0 } { $i < $samples } { incr i } {
+	integrate $chunk
+	lappend t [setmd time]
+	lappend e [expr [analyze energy total]/$n]
+    }
+    # least squares fit e = a + b*t
+    set m [llength $t]
+    set st 0; set se 0; set stt 0; set ste 0
+    foreach ti $t ei $e {
+	set st [expr $st + $ti]; set se [expr $se + $ei]
+	set stt [expr $stt + $ti*$ti]; set ste [expr $ste + $ti*$ei]
+    }
+    set b [expr ($m*$ste - $st*$se)/($m*$stt - $st*$st)]
+    set a [expr ($se - $b*$st)/$m]
+    set dev 0
+    foreach ti $t ei $e {
+	set dev [expr $dev + pow($ei - $a - $b*$ti, 2)]
+    }
+    return [list $b [expr sqrt($dev/$m)]]
+}
+
 #
 # stop_particles
 # -------------
@@ -53,8 +53,15 @@ proc blockfile_write_particles {channel write particles {info "id pos v type"} {
 	    if {$end == "end"} {set end [setmd max_part]}
 	}
 	if {![string is integer $start] || ![string is integer $end]} {error "list boundaries must be integers"}
-	for {set p $start} {$p <= $end} {incr p} {
-	    set d [eval "part $p pr $info"]
+	# gather only the requested properties of the whole range at once,
+	# properties that "part bulk print" does not know are written one by one
+	set ids {}
+	for {set p $start} {$p <= $end} {incr p} { lappend ids $p }
+	if {[catch {eval [list part bulk print $ids] $info} data]} {
+	    set data {}
+	    foreach p $ids { lappend data [eval "part $p pr $info"] }
+	}
+	foreach d $data {
 	    if {$d != "na"} {puts $channel "\t{$d}"}
 	}
     }
@@ -41,6 +41,7 @@
 #include "lees_edwards_domain_decomposition.hpp"
 #include "nsquare.hpp"
 #include "layered.hpp"
+#include "particle_soa.hpp"
 
 /* Variables */
 
@@ -60,6 +61,35 @@ double max_range = 0.0;
 
 int rebuild_verletlist = 0;
 
+int cell_sort_period = 0;
+
+double locality_drift = 0.0;
+
+/** number of resorts since the last spatial reordering. */
+static int n_resorts_since_sort = 0;
+
+/** \name Locality statistics of this node, see \ref cells_spatial_order */
+/*@{*/
+/** pairs of particles neighboring in memory checked. */
+static int n_locality_pairs = 0;
+/** of these, pairs that were not in Morton order. */
+static int n_locality_misses = 0;
+/*@}*/
+
+/** Morton key and position of a particle in its cell, for \ref
+    cells_spatial_order. */
+typedef struct {
+  unsigned int key;
+  int index;
+} MortonKey;
+
+/** key buffer of \ref cells_spatial_order. */
+static MortonKey *morton_keys = NULL;
+/** particle buffer of \ref cells_spatial_order. */
+static Particle *morton_buffer = NULL;
+/** allocated size of \ref morton_keys and \ref morton_buffer. */
+static int max_morton_buffer = 0;
+
 /************************************************************/
 /** \name Privat Functions */
 /************************************************************/
@@ -328,6 +358,91 @@ static void dump_particle_ordering()
 
 /*************************************************/
 
+/** Morton key of a position inside the local box, with a resolution
+    of 10 bits per coordinate. */
+static unsigned int position_to_morton_key(double pos[3])
+{
+  unsigned int key = 0;
+
+  for (int d = 0; d < 3; d++) {
+    int x = (int)((pos[d] - my_left[d])/local_box_l[d]*1024.0);
+    if (x < 0)
+      x = 0;
+    else if (x > 1023)
+      x = 1023;
+    for (int b = 0; b < 10; b++)
+      key |= ((unsigned int)(x >> b) & 1u) << (3*b + d);
+  }
+  return key;
+}
+
+static int compare_morton_keys(const void *a, const void *b)
+{
+  const MortonKey *ka = static_cast<const MortonKey *>(a);
+  const MortonKey *kb = static_cast<const MortonKey *>(b);
+  if (ka->key != kb->key)
+    return (ka->key > kb->key) ? 1 : -1;
+  return ka->index - kb->index;
+}
+
+/** Update the locality statistics of the local cells, i.e. count the
+    particles that follow a particle in memory which is behind them
+    along the Morton curve. If sort is set, the particles of each cell
+    are afterwards reordered along the curve.
+    @param sort whether to reorder the particles. */
+static void cells_spatial_order(int sort)
+{
+  n_locality_pairs = n_locality_misses = 0;
+
+  for (int c = 0; c < local_cells.n; c++) {
+    Cell *cell  = local_cells.cell[c];
+    Particle *p = cell->part;
+    int np      = cell->n;
+
+    if (np < 2)
+      continue;
+
+    if (np > max_morton_buffer) {
+      max_morton_buffer = np;
+      morton_keys   = (MortonKey *)Utils::realloc(morton_keys, max_morton_buffer*sizeof(MortonKey));
+      morton_buffer = (Particle *)Utils::realloc(morton_buffer, max_morton_buffer*sizeof(Particle));
+    }
+
+    for (int i = 0; i < np; i++) {
+      morton_keys[i].key   = position_to_morton_key(p[i].r.p);
+      morton_keys[i].index = i;
+      if (i > 0 && morton_keys[i].key < morton_keys[i-1].key)
+        n_locality_misses++;
+    }
+    n_locality_pairs += np - 1;
+
+    if (!sort)
+      continue;
+
+    qsort(morton_keys, np, sizeof(MortonKey), compare_morton_keys);
+    /* the particles only move in memory, dynamically allocated
+       members like the bond lists simply go with them. */
+    for (int i = 0; i < np; i++)
+      memcpy(&morton_buffer[i], &p[morton_keys[i].index], sizeof(Particle));
+    memcpy(p, morton_buffer, np*sizeof(Particle));
+    update_local_particles(cell);
+  }
+}
+
+void cells_locality_statistics()
+{
+  int local[2], sum[2];
+
+  /* one pass over the current order, independent of the reordering */
+  cells_spatial_order(0);
+  local[0] = n_locality_pairs;
+  local[1] = n_locality_misses;
+
+  MPI_Reduce(local, sum, 2, MPI_INT, MPI_SUM, 0, comm_cart);
+  if (this_node == 0)
+    locality_drift = (sum[0] > 0) ? sum[1]/(double)sum[0] : 0.0;
+}
+
 void cells_resort_particles(int global_flag)
 {
   CELL_TRACE(fprintf(stderr, "%d: entering cells_resort_particles %d\n", this_node, global_flag));
@@ -349,6 +464,14 @@ void cells_resort_particles(int global_flag)
     break;
   }
 
+  /* the ghosts are created from the local cells below, so they
+     automatically follow a new particle order. Without reordering,
+     the Morton keys are not computed at all. */
+  if (cell_sort_period > 0 && ++n_resorts_since_sort >= cell_sort_period) {
+    cells_spatial_order(1);
+    n_resorts_since_sort = 0;
+  }
+
 #ifdef ADDITIONAL_CHECKS
   /* at the end of the day, everything should be consistent again */
   check_particle_consistency();
@@ -357,6 +480,8 @@ void cells_resort_particles(int global_flag)
   ghost_communicator(&cell_structure.ghost_cells_comm);
   ghost_communicator(&cell_structure.exchange_ghosts_comm);
 
+  soa_update_cells(SOA_UPDATE_ALL);
+
   resort_particles = 0;
   rebuild_verletlist = 1;
 
@@ -459,6 +584,11 @@ void check_resort_particles()
 
 /*************************************************/
 void cells_update_ghosts()
+{
+  cells_update_ghosts_start(0);
+}
+
+int cells_update_ghosts_start(int overlap)
 {
   /* if dd.use_vList is set, it so far means we want EXACT sorting of the particles.*/
   if (dd.use_vList == 0)
@@ -473,9 +603,23 @@ void cells_update_ghosts()
     cells_resort_particles(CELL_NEIGHBOR_EXCHANGE);
 #endif
   }
-  else
+  else if (overlap && cell_structure.update_ghost_pos_comm.async) {
+    /* Communication step: ghost information, completed later */
+    ghost_communicator_start(&cell_structure.update_ghost_pos_comm);
+    return 1;
+  }
+  else {
     /* Communication step: ghost information */
     ghost_communicator(&cell_structure.update_ghost_pos_comm);
+    soa_update_cells(SOA_UPDATE_POS);
+  }
+  return 0;
+}
+
+void cells_update_ghosts_finish()
+{
+  ghost_communicator_finish(&cell_structure.update_ghost_pos_comm);
+  soa_update_cells(SOA_UPDATE_POS);
 }
 
 /*************************************************/
@@ -195,6 +195,19 @@ extern double max_range;
     rebuilt. */
 extern int rebuild_verletlist;
 
+/** If positive, the particles in each local cell are reordered along
+    a Morton space filling curve in every cell_sort_period-th call of
+    \ref cells_resort_particles, so that particles that are close in
+    space stay close in memory. Zero disables the reordering. */
+extern int cell_sort_period;
+
+/** Fraction of the particles that follow a particle in memory which
+    lies behind them on the Morton curve, measured at the end of the
+    last integration. Zero means perfect locality, a random order
+    gives one half. Only valid on the master node, see \ref
+    cells_locality_statistics. */
+extern double locality_drift;
+
 /*@}*/
 
 /************************************************************/
@@ -260,6 +273,16 @@ void cells_on_geometry_change(int flags);
     also a resorting of the particles takes place. */
 void cells_update_ghosts();
 
+/** Like \ref cells_update_ghosts, but if \a overlap is set, no resort is
+    necessary and the position update is nonblocking (see \ref
+    ghost_enable_async), the update is only started.
+    @return whether the update has to be completed by \ref
+    cells_update_ghosts_finish. */
+int cells_update_ghosts_start(int overlap);
+
+/** Complete the ghost update started by \ref cells_update_ghosts_start. */
+void cells_update_ghosts_finish();
+
 /** Calculate and return the total number of particles on this
     node. */
 int cells_get_n_particles();
@@ -279,6 +302,10 @@ void check_resort_particles();
 /* Do a strict particle sorting, including order in the cells. */
 void local_sort_particles();
 
+/** Measure the locality of the current particle order on all nodes
+    and collect it into \ref locality_drift on the master node. */
+void cells_locality_statistics();
+
 /*@}*/
 
 #endif
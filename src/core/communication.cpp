@@ -22,6 +22,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #include "utils.hpp"
 #include "communication.hpp"
 #include "interaction_data.hpp"
@@ -107,6 +108,8 @@ static int terminated = 0;
   CB(mpi_send_ext_force_slave) \
   CB(mpi_send_ext_torque_slave) \
   CB(mpi_place_new_particle_slave) \
+  CB(mpi_send_particles_property_slave) \
+  CB(mpi_get_particles_properties_slave) \
   CB(mpi_remove_particle_slave) \
   CB(mpi_bcast_constraint_slave) \
   CB(mpi_random_seed_slave) \
@@ -135,6 +138,9 @@ static int terminated = 0;
   CB(mpi_send_fluid_slave) \
   CB(mpi_recv_fluid_slave) \
   CB(mpi_local_stress_tensor_slave) \
+  CB(mpi_rdf_slave) \
+  CB(mpi_gather_density_mesh_slave) \
+  CB(mpi_observable_local_slave) \
   CB(mpi_send_virtual_slave) \
   CB(mpi_iccp3m_iteration_slave) \
   CB(mpi_iccp3m_init_slave) \
@@ -492,6 +498,256 @@ void mpi_place_new_particle_slave(int pnode, int part)
   on_particle_change();
 }
 
+/****************** REQ_SET_PARTICLES_PROPERTY ************/
+
+/** Apply the received values of \ref mpi_send_particles_property to
+    the local particles. */
+static void local_set_particles_property(int property, int n, int *ids, double *values)
+{
+  int size = particles_property_size(property);
+
+  for (int i = 0; i < n; i++) {
+    double *val = values + i*size;
+    int part = ids[i];
+
+    if (property == PART_PROP_POS) {
+      if (part < 0)
+        local_place_particle(-part - 1, val, 1);
+      else
+        local_place_particle(part, val, 0);
+      continue;
+    }
+
+    Particle *p = local_particles[part];
+    switch (property) {
+    case PART_PROP_V:
+      memmove(p->m.v, val, 3*sizeof(double));
+      break;
+    case PART_PROP_F:
+      memmove(p->f.f, val, 3*sizeof(double));
+      break;
+#ifdef ELECTROSTATICS
+    case PART_PROP_Q:
+      p->p.q = val[0];
+      break;
+#endif
+    case PART_PROP_TYPE:
+      p->p.type = (int)val[0];
+      break;
+#ifdef MASS
+    case PART_PROP_MASS:
+      p->p.mass = val[0];
+      break;
+#endif
+    }
+  }
+}
+
+void mpi_send_particles_property(int property, int n, int *ids, int *pnodes, double *values)
+{
+  int size = particles_property_size(property);
+  int new_parts[2] = { 0, -1 };
+  std::vector<int> counts(n_nodes, 0), displs(n_nodes, 0), pos(n_nodes);
+  std::vector<int> vcounts(n_nodes), vdispls(n_nodes);
+  std::vector<int> sorted_ids(n + 1);
+  std::vector<double> sorted_values((size_t)n*size + 1);
+
+  mpi_call(mpi_send_particles_property_slave, property, n);
+
+  /* sort the particles by node */
+  for (int i = 0; i < n; i++) {
+    counts[pnodes[i]]++;
+    if (ids[i] < 0) {
+      new_parts[0]++;
+      new_parts[1] = imax(new_parts[1], -ids[i] - 1);
+    }
+  }
+  for (int node = 1; node < n_nodes; node++)
+    displs[node] = displs[node - 1] + counts[node - 1];
+  for (int node = 0; node < n_nodes; node++) {
+    pos[node] = displs[node];
+    vcounts[node] = counts[node]*size;
+    vdispls[node] = displs[node]*size;
+  }
+  for (int i = 0; i < n; i++) {
+    int j = pos[pnodes[i]]++;
+    sorted_ids[j] = ids[i];
+    memmove(&sorted_values[(size_t)j*size], values + (size_t)i*size, size*sizeof(double));
+  }
+
+  /* the new particles have to be known everywhere */
+  MPI_Bcast(new_parts, 2, MPI_INT, 0, comm_cart);
+  if (new_parts[0] > 0)
+    added_particles(new_parts[0], new_parts[1]);
+
+  int n_local;
+  MPI_Scatter(&counts[0], 1, MPI_INT, &n_local, 1, MPI_INT, 0, comm_cart);
+  MPI_Scatterv(&sorted_ids[0], &counts[0], &displs[0], MPI_INT,
+               MPI_IN_PLACE, n_local, MPI_INT, 0, comm_cart);
+  MPI_Scatterv(&sorted_values[0], &vcounts[0], &vdispls[0], MPI_DOUBLE,
+               MPI_IN_PLACE, n_local*size, MPI_DOUBLE, 0, comm_cart);
+
+  local_set_particles_property(property, n_local, &sorted_ids[0], &sorted_values[0]);
+
+  on_particle_change();
+}
+
+void mpi_send_particles_property_slave(int property, int n)
+{
+  int size = particles_property_size(property);
+  int new_parts[2], n_local;
+
+  MPI_Bcast(new_parts, 2, MPI_INT, 0, comm_cart);
+  if (new_parts[0] > 0)
+    added_particles(new_parts[0], new_parts[1]);
+
+  MPI_Scatter(NULL, 1, MPI_INT, &n_local, 1, MPI_INT, 0, comm_cart);
+  std::vector<int> ids(n_local + 1);
+  std::vector<double> values((size_t)n_local*size + 1);
+  MPI_Scatterv(NULL, NULL, NULL, MPI_INT,
+               &ids[0], n_local, MPI_INT, 0, comm_cart);
+  MPI_Scatterv(NULL, NULL, NULL, MPI_DOUBLE,
+               &values[0], n_local*size, MPI_DOUBLE, 0, comm_cart);
+
+  local_set_particles_property(property, n_local, &ids[0], &values[0]);
+
+  on_particle_change();
+}
+
+/****************** REQ_GET_PARTICLES_PROPERTIES ************/
+
+/** Pack the identity and the properties of the local particles for
+    \ref mpi_get_particles_properties. If selected is not empty, only
+    the particles with selected[identity] set are packed. */
+static void local_get_particles_properties(int n_props, const int *props,
+                                           const std::vector<char> &selected,
+                                           std::vector<double> &buf)
+{
+  for (int c = 0; c < local_cells.n; c++) {
+    Cell *cell = local_cells.cell[c];
+    for (int j = 0; j < cell->n; j++) {
+      Particle *p = &cell->part[j];
+      int id = p->p.identity;
+      if (!selected.empty() && (id >= (int)selected.size() || !selected[id]))
+        continue;
+
+      /* unfolded as in updatePartCfg */
+      double ppos[3], v[3];
+      int img[3];
+      memmove(ppos, p->r.p, 3*sizeof(double));
+      memmove(v, p->m.v, 3*sizeof(double));
+      memmove(img, p->l.i, 3*sizeof(int));
+      unfold_position(ppos, v, img);
+
+      buf.push_back(id);
+      for (int k = 0; k < n_props; k++) {
+        switch (props[k]) {
+        case PART_PROP_POS:
+          buf.insert(buf.end(), ppos, ppos + 3);
+          break;
+        case PART_PROP_V:
+          buf.insert(buf.end(), v, v + 3);
+          break;
+        case PART_PROP_F:
+          buf.insert(buf.end(), p->f.f, p->f.f + 3);
+          break;
+#ifdef ELECTROSTATICS
+        case PART_PROP_Q:
+          buf.push_back(p->p.q);
+          break;
+#endif
+        case PART_PROP_TYPE:
+          buf.push_back(p->p.type);
+          break;
+#ifdef MASS
+        case PART_PROP_MASS:
+          buf.push_back(p->p.mass);
+          break;
+#endif
+        }
+      }
+    }
+  }
+}
+
+/** Mark the particles to pack on this node, see \ref
+    local_get_particles_properties. */
+static void select_particles(int n, const int *ids, std::vector<char> &selected)
+{
+  int max_id = 0;
+  for (int i = 0; i < n; i++)
+    max_id = imax(max_id, ids[i]);
+  selected.assign(max_id + 1, 0);
+  for (int i = 0; i < n; i++)
+    selected[ids[i]] = 1;
+}
+
+void mpi_get_particles_properties(int n_props, const int *props, int n, const int *ids,
+                                  int all, double *values)
+{
+  int size = 0, n_local;
+  std::vector<char> selected;
+  std::vector<double> local;
+  std::vector<int> counts(n_nodes), displs(n_nodes, 0);
+
+  mpi_call(mpi_get_particles_properties_slave, n_props, all ? -1 : n);
+  MPI_Bcast((int *)props, n_props, MPI_INT, 0, comm_cart);
+  if (!all) {
+    MPI_Bcast((int *)ids, n, MPI_INT, 0, comm_cart);
+    select_particles(n, ids, selected);
+  }
+
+  local_get_particles_properties(n_props, props, selected, local);
+  n_local = local.size();
+  MPI_Gather(&n_local, 1, MPI_INT, &counts[0], 1, MPI_INT, 0, comm_cart);
+  for (int node = 1; node < n_nodes; node++)
+    displs[node] = displs[node - 1] + counts[node - 1];
+  int n_recv = displs[n_nodes - 1] + counts[n_nodes - 1];
+  std::vector<double> recv(n_recv + 1);
+  MPI_Gatherv(local.empty() ? NULL : &local[0], n_local, MPI_DOUBLE,
+              &recv[0], &counts[0], &displs[0], MPI_DOUBLE, 0, comm_cart);
+
+  /* sort the particles into the order of ids, which may contain
+     duplicates */
+  for (int k = 0; k < n_props; k++)
+    size += particles_property_size(props[k]);
+  int max_id = 0;
+  for (int i = 0; i < n; i++)
+    max_id = imax(max_id, ids[i]);
+  std::vector<int> first(max_id + 1, -1), next(n);
+  for (int i = n - 1; i >= 0; i--) {
+    next[i] = first[ids[i]];
+    first[ids[i]] = i;
+  }
+  for (int r = 0; r < n_recv; r += size + 1) {
+    int id = (int)recv[r];
+    if (id > max_id)
+      continue;
+    for (int i = first[id]; i != -1; i = next[i])
+      memmove(values + (size_t)i*size, &recv[r + 1], size*sizeof(double));
+  }
+}
+
+void mpi_get_particles_properties_slave(int n_props, int n)
+{
+  std::vector<int> props(n_props);
+  std::vector<char> selected;
+  std::vector<double> local;
+
+  MPI_Bcast(&props[0], n_props, MPI_INT, 0, comm_cart);
+  if (n >= 0) {
+    std::vector<int> ids(n + 1);
+    MPI_Bcast(&ids[0], n, MPI_INT, 0, comm_cart);
+    select_particles(n, &ids[0], selected);
+  }
+
+  local_get_particles_properties(n_props, &props[0], selected, local);
+  int n_local = local.size();
+  MPI_Gather(&n_local, 1, MPI_INT, NULL, 1, MPI_INT, 0, comm_cart);
+  MPI_Gatherv(local.empty() ? NULL : &local[0], n_local, MPI_DOUBLE,
+              NULL, NULL, NULL, MPI_DOUBLE, 0, comm_cart);
+}
+
 /****************** REQ_SET_V ************/
 void mpi_send_v(int pnode, int part, double v[3])
 {
@@ -1574,6 +1830,132 @@ void mpi_gather_stats_slave(int ana_num, int job)
   }
 }
 
+/*************** REQ_RDF ************/
+/** Histograms the pairs for \ref calc_rdf on all nodes, see \ref
+    mpi_rdf. Returns 0 on all nodes if one of them cannot do it. */
+static int mpi_rdf_local(int *p1_types, int n_p1, int *p2_types, int n_p2, int mixed_flag,
+                         double r_min, double r_max, int r_bins, double *hist, double cnt[3])
+{
+  int possible, all_possible;
+
+  on_observable_calc();
+  possible = calc_rdf_local_possible(r_max);
+  MPI_Allreduce(&possible, &all_possible, 1, MPI_INT, MPI_MIN, comm_cart);
+  if (!all_possible)
+    return 0;
+
+  calc_rdf_local(p1_types, n_p1, p2_types, n_p2, mixed_flag, r_min, r_max, r_bins, hist, cnt);
+  return 1;
+}
+
+int mpi_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2, int mixed_flag,
+            double r_min, double r_max, int r_bins, double *rdf, double *pairs)
+{
+  int ints[4] = {n_p1, n_p2, mixed_flag, r_bins};
+  double range[2] = {r_min, r_max}, cnt[3], sum_cnt[3];
+
+  mpi_call(mpi_rdf_slave, -1, 0);
+  MPI_Bcast(ints, 4, MPI_INT, 0, comm_cart);
+  MPI_Bcast(p1_types, n_p1, MPI_INT, 0, comm_cart);
+  MPI_Bcast(p2_types, n_p2, MPI_INT, 0, comm_cart);
+  MPI_Bcast(range, 2, MPI_DOUBLE, 0, comm_cart);
+
+  double *hist = (double*)Utils::malloc(r_bins*sizeof(double));
+  if (!mpi_rdf_local(p1_types, n_p1, p2_types, n_p2, mixed_flag, r_min, r_max, r_bins, hist, cnt)) {
+    free(hist);
+    return 0;
+  }
+  MPI_Reduce(hist, rdf, r_bins, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  MPI_Reduce(cnt, sum_cnt, 3, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  free(hist);
+
+  /* number of pairs of the normalization, the particle itself is
+     counted for mixed distributions as in the loop over partCfg */
+  if (mixed_flag)
+    *pairs = sum_cnt[0]*sum_cnt[1];
+  else
+    *pairs = 0.5*(sum_cnt[0]*sum_cnt[0] - sum_cnt[2]);
+  return 1;
+}
+
+void mpi_rdf_slave(int node, int param)
+{
+  int ints[4];
+  double range[2], cnt[3];
+
+  MPI_Bcast(ints, 4, MPI_INT, 0, comm_cart);
+  int *p1_types = (int*)Utils::malloc(ints[0]*sizeof(int));
+  int *p2_types = (int*)Utils::malloc(ints[1]*sizeof(int));
+  MPI_Bcast(p1_types, ints[0], MPI_INT, 0, comm_cart);
+  MPI_Bcast(p2_types, ints[1], MPI_INT, 0, comm_cart);
+  MPI_Bcast(range, 2, MPI_DOUBLE, 0, comm_cart);
+
+  double *hist = (double*)Utils::malloc(ints[3]*sizeof(double));
+  if (mpi_rdf_local(p1_types, ints[0], p2_types, ints[1], ints[2],
+                    range[0], range[1], ints[3], hist, cnt)) {
+    MPI_Reduce(hist, NULL, ints[3], MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+    MPI_Reduce(cnt, NULL, 3, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  }
+  free(hist);
+  free(p1_types);
+  free(p2_types);
+}
+
+/*************** REQ_DENSITY_MESH ************/
+int mpi_gather_density_mesh(int type, int mesh, int cao, double *rho)
+{
+  int ints[3] = {type, mesh, cao}, cnt, sum_cnt;
+
+  mpi_call(mpi_gather_density_mesh_slave, -1, 0);
+  MPI_Bcast(ints, 3, MPI_INT, 0, comm_cart);
+
+  on_observable_calc();
+  cnt = calc_density_mesh_local(type, mesh, cao, rho);
+  MPI_Reduce(MPI_IN_PLACE, rho, mesh*mesh*mesh, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  MPI_Reduce(&cnt, &sum_cnt, 1, MPI_INT, MPI_SUM, 0, comm_cart);
+  return sum_cnt;
+}
+
+void mpi_gather_density_mesh_slave(int node, int param)
+{
+  int ints[3], cnt;
+
+  MPI_Bcast(ints, 3, MPI_INT, 0, comm_cart);
+  double *rho = (double*)Utils::malloc(ints[1]*ints[1]*ints[1]*sizeof(double));
+
+  on_observable_calc();
+  cnt = calc_density_mesh_local(ints[0], ints[1], ints[2], rho);
+  MPI_Reduce(rho, NULL, ints[1]*ints[1]*ints[1], MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  MPI_Reduce(&cnt, NULL, 1, MPI_INT, MPI_SUM, 0, comm_cart);
+  free(rho);
+}
+
+/*************** REQ_OBSERVABLE_LOCAL ************/
+void mpi_observable_local(observable_local_params *par, int *ids, double *A)
+{
+  mpi_call(mpi_observable_local_slave, -1, 0);
+  MPI_Bcast(par, sizeof(observable_local_params), MPI_BYTE, 0, comm_cart);
+  MPI_Bcast(ids, par->n_ids, MPI_INT, 0, comm_cart);
+
+  observable_calc_local(par, ids, A);
+  MPI_Reduce(MPI_IN_PLACE, A, par->n, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+}
+
+void mpi_observable_local_slave(int node, int param)
+{
+  observable_local_params par;
+
+  MPI_Bcast(&par, sizeof(observable_local_params), MPI_BYTE, 0, comm_cart);
+  int *ids = (int*)Utils::malloc(par.n_ids*sizeof(int));
+  MPI_Bcast(ids, par.n_ids, MPI_INT, 0, comm_cart);
+  double *A = (double*)Utils::malloc(par.n*sizeof(double));
+
+  observable_calc_local(&par, ids, A);
+  MPI_Reduce(A, NULL, par.n, MPI_DOUBLE, MPI_SUM, 0, comm_cart);
+  free(A);
+  free(ids);
+}
+
 /*************** REQ_GET_LOCAL_STRESS_TENSOR ************/
 void mpi_local_stress_tensor(DoubleList *TensorInBin, int bins[3], int periodic[3], double range_start[3], double range[3]) {
   
@@ -2667,6 +3049,9 @@ void mpi_bcast_lb_params_slave(int node, int field)
 {
 #ifdef LB
   MPI_Bcast(&lbpar, sizeof(LB_Parameters), MPI_BYTE, 0, comm_cart);
+  /* the switch is only broadcast after all parameters are set, but the
+     nodes have to agree on it while the fluid is set up */
+  MPI_Bcast(&lattice_switch, 1, MPI_INT, 0, comm_cart);
   on_lb_params_change(field);
 #endif
 }
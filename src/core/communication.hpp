@@ -55,6 +55,7 @@
 #include "particle_data.hpp"
 #include "random.hpp"
 #include "topology.hpp"
+#include "statistics_observable.hpp"
 #include <mpi.h>
 #include "cuda_init.hpp"
 
@@ -139,6 +140,29 @@ void mpi_place_particle(int node, int id, double pos[3]);
 */
 void mpi_place_new_particle(int node, int id, double pos[3]);
 
+/** Set a property of many particles, see \ref set_particles_property.
+    \param property the property, one of the PART_PROP_ constants.
+    \param n      number of particles.
+    \param ids    the particles. New particles, which only occur for
+                  \ref PART_PROP_POS, are given as -id-1.
+    \param pnodes the nodes the particles are (to be) attached to.
+    \param values the values, \ref particles_property_size per particle.
+*/
+void mpi_send_particles_property(int property, int n, int *ids, int *pnodes, double *values);
+
+/** Get properties of many particles, see \ref get_particles_properties.
+    \param n_props number of properties.
+    \param props   the properties, PART_PROP_ constants.
+    \param n       number of particles.
+    \param ids     the particles.
+    \param all     if true, ids contains all particles and is not sent
+                   to the slaves.
+    \param values  the values, \ref particles_property_size per property
+                   and particle.
+*/
+void mpi_get_particles_properties(int n_props, const int *props, int n, const int *ids,
+                                  int all, double *values);
+
 /** Issue REQ_SET_V: send particle velocity.
     Also calls \ref on_particle_change.
     \param part the particle.
@@ -442,6 +466,47 @@ void mpi_gather_stats(int job, void *result, void *result_t, void *result_nb, vo
 
 void mpi_local_stress_tensor(DoubleList *TensorInBin, int bins[3], int periodic[3], double range_start[3], double range[3]);
 
+/** Issue REQ_RDF: histogram the pairs of the radial distribution
+    function on each node using the cells and ghosts, and sum up the
+    histograms on the master. This is only possible if the cells
+    reach up to r_max, see \ref calc_rdf_local_possible.
+    @param p1_types   types of the first particle of the pairs.
+    @param n_p1       length of p1_types.
+    @param p2_types   types of the second particle of the pairs.
+    @param n_p2       length of p2_types.
+    @param mixed_flag 0 if p1_types and p2_types are identical.
+    @param r_min      minimal distance.
+    @param r_max      maximal distance.
+    @param r_bins     number of bins.
+    @param rdf        the pair histogram (master only, size: r_bins).
+    @param pairs      total number of pairs for the normalization (master only).
+    @return 1 if the histogram was calculated, 0 if the particle
+    configuration has to be used instead.
+*/
+int mpi_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2, int mixed_flag,
+            double r_min, double r_max, int r_bins, double *rdf, double *pairs);
+
+/** Issue REQ_DENSITY_MESH: assign the particles of a type to a
+    density mesh on each node, see \ref calc_density_mesh_local, and
+    sum up the meshes on the master.
+    @param type  the type of the particles.
+    @param mesh  number of mesh points in each direction.
+    @param cao   charge assignment order (1 to 7).
+    @param rho   the density mesh (master only, size: mesh^3).
+    @return the number of particles of the type (master only).
+*/
+int mpi_gather_density_mesh(int type, int mesh, int cao, double *rho);
+
+/** Issue REQ_OBSERVABLE_LOCAL: accumulate an observable from the real
+    particles of each node, see \ref observable_calc_local, and sum up
+    the contributions on the master. Only the result is communicated,
+    not the particles.
+    @param par the parameters of the observable.
+    @param ids the particle ids (size: par->n_ids).
+    @param A   the result (master only, size: par->n).
+*/
+void mpi_observable_local(observable_local_params *par, int *ids, double *A);
+
 /** Issue REQ_GETPARTS: gather all particle informations (except bonds).
     This is slow and may use huge amounts of memory. If il is non-NULL, also
     the bonding information is also fetched and stored in a single intlist
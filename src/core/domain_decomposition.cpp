@@ -35,6 +35,8 @@
 #include "constraint.hpp"
 #include "initialize.hpp"
 #include "external_potential.hpp"
+#include "lattice.hpp"
+#include <vector>
 
 /************************************************/
 /** \name Defines */
@@ -44,6 +46,11 @@
 /** half the number of cell neighbors in 3 Dimensions. */
 #define CELLS_MAX_NEIGHBORS 14
 
+/** relative load imbalance below which the domains are not changed. */
+#define DD_BALANCE_TOLERANCE 0.05
+/** fraction of the boundary shift towards equal loads per balancing step. */
+#define DD_BALANCE_RELAXATION 0.5
+
 /*@}*/
 
 /************************************************/
@@ -54,12 +61,22 @@
 #ifdef LEES_EDWARDS
 le_dd_comms_manager le_mgr;
 #endif
-DomainDecomposition dd = { 1, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, NULL };
+DomainDecomposition dd = { 1, 0, 0, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, NULL };
 
 int max_num_cells = CELLS_MAX_NUM_CELLS;
 int min_num_cells = 1;
 double max_skin   = 0.0;
 
+int dd_balance_interval = 0;
+double load_imbalance = 1.0;
+double dd_force_time = 0.0;
+
+/** steps since the last load balancing. */
+static int dd_balance_steps = 0;
+/** cell size of the regular node grid, the minimal domain size for
+    the load balancing. */
+static double dd_regular_cell_range[3] = {0, 0, 0};
+
 /*@}*/
 
 /************************************************************/
@@ -109,7 +126,12 @@ double max_skin   = 0.0;
  *  Calculates the cell grid, based on \ref local_box_l and \ref
  *  max_range. If the number of cells is larger than \ref
  *  max_num_cells, it increases max_range until the number of cells is
- *  smaller or equal \ref max_num_cells. It sets: \ref
+ *  smaller or equal \ref max_num_cells. If the node domains are not
+ *  all equal (see \ref node_bounds), the cell size is determined for
+ *  the regular grid with an eighth of \ref max_num_cells, and each
+ *  node fits as many cells of at least that size as possible. The
+ *  neighboring nodes then agree on the cell planes they share, and the
+ *  load balancer keeps the domains below twice the regular size. It sets: \ref
  *  DomainDecomposition::cell_grid, \ref
  *  DomainDecomposition::ghost_cell_grid, \ref
  *  DomainDecomposition::cell_size, \ref
@@ -119,6 +141,17 @@ void dd_create_cell_grid()
 {
   int i,n_local_cells,new_cells,min_ind;
   double cell_range[3], min_size, scale, volume;
+  double cell_box[3];
+  int cell_budget = max_num_cells;
+  int regular = grid_is_regular();
+
+  for(i=0;i<3;i++)
+    cell_box[i] = local_box_l[i];
+  if (!regular) {
+    for(i=0;i<3;i++)
+      cell_box[i] = box_l[i]/node_grid[i];
+    cell_budget = imax(max_num_cells/8, 1);
+  }
   CELL_TRACE(fprintf(stderr, "%d: dd_create_cell_grid: max_range %f\n",this_node,max_range));
   CELL_TRACE(fprintf(stderr, "%d: dd_create_cell_grid: local_box %f-%f, %f-%f, %f-%f,\n",this_node,my_left[0],my_right[0],my_left[1],my_right[1],my_left[2],my_right[2]));
   
@@ -135,24 +168,26 @@ void dd_create_cell_grid()
 #else
     n_local_cells = dd.cell_grid[0] = dd.cell_grid[1] = dd.cell_grid[2]=1;
 #endif
+    for(i=0;i<3;i++)
+      dd_regular_cell_range[i] = cell_box[i];
   }
   else {
     /* Calculate initial cell grid */
-    volume = local_box_l[0];
-    for(i=1;i<3;i++) volume *= local_box_l[i];
-    scale = pow(max_num_cells/volume, 1./3.);
+    volume = cell_box[0];
+    for(i=1;i<3;i++) volume *= cell_box[i];
+    scale = pow(cell_budget/volume, 1./3.);
     for(i=0;i<3;i++) {
       /* this is at least 1 */
-      dd.cell_grid[i] = (int)ceil(local_box_l[i]*scale);
-      cell_range[i] = local_box_l[i]/dd.cell_grid[i];
+      dd.cell_grid[i] = (int)ceil(cell_box[i]*scale);
+      cell_range[i] = cell_box[i]/dd.cell_grid[i];
 
       if ( cell_range[i] < max_range ) {
 	/* ok, too many cells for this direction, set to minimum */
-	dd.cell_grid[i] = (int)floor(local_box_l[i]/max_range);
+	dd.cell_grid[i] = (int)floor(cell_box[i]/max_range);
 	if ( dd.cell_grid[i] < 1 ) {
 	  ostringstream msg;
 	  msg << "interaction range " << max_range << " in direction "
-	      << i << " is larger than the local box size " << local_box_l[i];
+	      << i << " is larger than the local box size " << cell_box[i];
 	  runtimeError(msg);
 	  dd.cell_grid[i] = 1;
 	}
@@ -160,12 +195,12 @@ void dd_create_cell_grid()
         if ( (i == 0) && (dd.cell_grid[0] < 2) ) {
 	  ostringstream msg;
 	  msg << "interaction range " << max_range << " in direction "
-	      << i << " is larger than half the local box size " << local_box_l[i] << "/2";
+	      << i << " is larger than half the local box size " << cell_box[i] << "/2";
 	  runtimeError(msg);
 	  dd.cell_grid[0] = 2;
         }
 #endif
-	cell_range[i] = local_box_l[i]/dd.cell_grid[i];
+	cell_range[i] = cell_box[i]/dd.cell_grid[i];
       }
     }
 
@@ -176,7 +211,7 @@ void dd_create_cell_grid()
       n_local_cells = dd.cell_grid[0] * dd.cell_grid[1] * dd.cell_grid[2];
 
       /* done */
-      if (n_local_cells <= max_num_cells)
+      if (n_local_cells <= cell_budget)
           break;
 
       /* find coordinate with the smallest cell range */
@@ -196,7 +231,24 @@ void dd_create_cell_grid()
       CELL_TRACE(fprintf(stderr, "%d: minimal coordinate %d, size %f, grid %d\n", this_node,min_ind, min_size, dd.cell_grid[min_ind]));
 
       dd.cell_grid[min_ind]--;
-      cell_range[min_ind] = local_box_l[min_ind]/dd.cell_grid[min_ind];
+      cell_range[min_ind] = cell_box[min_ind]/dd.cell_grid[min_ind];
+    }
+    for(i=0;i<3;i++)
+      dd_regular_cell_range[i] = cell_box[i]/dd.cell_grid[i];
+
+    if (!regular) {
+      /* the same cell size everywhere, but domain dependent numbers */
+      for(i=0;i<3;i++) {
+        dd.cell_grid[i] = (int)floor(local_box_l[i]/dd_regular_cell_range[i] + ROUND_ERROR_PREC);
+        if (dd.cell_grid[i] < 1) {
+          ostringstream msg;
+          msg << "interaction range " << max_range << " in direction "
+              << i << " is larger than the local box size " << local_box_l[i];
+          runtimeError(msg);
+          dd.cell_grid[i] = 1;
+        }
+      }
+      n_local_cells = dd.cell_grid[0] * dd.cell_grid[1] * dd.cell_grid[2];
     }
     CELL_TRACE(fprintf(stderr, "%d: final %d %d %d\n", this_node, dd.cell_grid[0], dd.cell_grid[1], dd.cell_grid[2]));
 
@@ -239,9 +291,34 @@ void dd_create_cell_grid()
   CELL_TRACE(fprintf(stderr, "%d: dd_create_cell_grid, n_cells=%d, local_cells.n=%d, ghost_cells.n=%d, dd.ghost_cell_grid=(%d,%d,%d)\n", this_node, n_cells,local_cells.n,ghost_cells.n,dd.ghost_cell_grid[0],dd.ghost_cell_grid[1],dd.ghost_cell_grid[2]));
 }
 
+/** Compare two cells by their position along a Morton (Z-order)
+    space filling curve through the cell grid, for qsort. The most
+    significant differing bit of the grid coordinates decides, with z
+    before y before x. */
+static int dd_compare_cells_morton(const void *a, const void *b)
+{
+  int pa[3], pb[3], d, msd = 2;
+  unsigned int x = 0, y;
+
+  get_grid_pos(*(Cell * const *)a - cells, &pa[0], &pa[1], &pa[2], dd.ghost_cell_grid);
+  get_grid_pos(*(Cell * const *)b - cells, &pb[0], &pb[1], &pb[2], dd.ghost_cell_grid);
+
+  for(d = 2; d >= 0; d--) {
+    y = pa[d] ^ pb[d];
+    if(x < y && x < (x ^ y)) {
+      msd = d;
+      x = y;
+    }
+  }
+  return (pa[msd] > pb[msd]) - (pa[msd] < pb[msd]);
+}
+
 /** Fill local_cells list and ghost_cells list for use with domain
     decomposition.  \ref cells::cells is assumed to be a 3d grid with size
-    \ref DomainDecomposition::ghost_cell_grid . */
+    \ref DomainDecomposition::ghost_cell_grid . The local cells are
+    ordered along a Morton curve, so that the cell loops visit
+    spatially close cells, and therefore mostly the same neighbor
+    cells, one after the other. */
 void dd_mark_cells()
 {
   int m,n,o,cnt_c=0,cnt_l=0,cnt_g=0;
@@ -259,6 +336,10 @@ void dd_mark_cells()
     else                        ghost_cells.cell[cnt_g++] = &cells[cnt_c++];
   } 
 
+#ifndef LEES_EDWARDS
+  /* the Lees-Edwards cell interactions rely on the grid order */
+  qsort(local_cells.cell, local_cells.n, sizeof(Cell *), dd_compare_cells_morton);
+#endif
 }
 
 /** Fill a communication cell pointer list. Fill the cell pointers of
@@ -499,11 +580,12 @@ void dd_update_communicators_w_boxl()
 /** Init cell interactions for cell system domain decomposition.
  * initializes the interacting neighbor cell list of a cell The
  * created list of interacting neighbor cells is used by the verlet
- * algorithm (see verlet.cpp) to build the verlet lists.
+ * algorithm (see verlet.cpp) to build the verlet lists. The lists
+ * are created in the order of \ref local_cells.
  */
 void dd_init_cell_interactions()
 {
-  int m,n,o,p,q,r,ind1,ind2,c_cnt=0,n_cnt;
+  int m,n,o,p,q,r,ind1,ind2,c_cnt,n_cnt;
  
   /* initialize cell neighbor structures */
   dd.cell_inter = (IA_Neighbor_List *) Utils::realloc(dd.cell_inter,local_cells.n*sizeof(IA_Neighbor_List));
@@ -513,11 +595,12 @@ void dd_init_cell_interactions()
   }
 
   /* loop all local cells */
-  DD_LOCAL_CELLS_LOOP(m,n,o) {
+  for(c_cnt=0; c_cnt<local_cells.n; c_cnt++) {
     dd.cell_inter[c_cnt].nList = (IA_Neighbor *) Utils::realloc(dd.cell_inter[c_cnt].nList, CELLS_MAX_NEIGHBORS*sizeof(IA_Neighbor));
 
     n_cnt=0;
-    ind1 = get_linear_index(m,n,o,dd.ghost_cell_grid);
+    ind1 = local_cells.cell[c_cnt] - cells;
+    get_grid_pos(ind1, &m, &n, &o, dd.ghost_cell_grid);
     /* loop all neighbor cells */
     for(p=o-1; p<=o+1; p++)        
       for(q=n-1; q<=n+1; q++)
@@ -538,22 +621,22 @@ void dd_init_cell_interactions()
 
 
     dd.cell_inter[c_cnt].n_neighbors = n_cnt; 
-    c_cnt++;
   }
 
 #ifdef CELL_DEBUG
   FILE *cells_fp;
   char cLogName[64];
-  int  c,nn,this_n;
+  int  c,nn,this_n,pos[3];
   double myPos[3];
   sprintf(cLogName, "cells_map%i.dat", this_node);
   cells_fp = fopen(cLogName,"w");
 
 
   for(c=0;c<c_cnt;c++){
-     myPos[0] = my_left[0] + dd.cell_size[0] * ( 1 + c % dd.cell_grid[0] );  
-     myPos[1] = my_left[1] + dd.cell_size[1] * ( 1 + (c / dd.cell_grid[0]) % dd.cell_grid[1]);  
-     myPos[2] = my_left[2] + dd.cell_size[2] * ( 1 + (c / (dd.cell_grid[0] * dd.cell_grid[1])));  
+     get_grid_pos(local_cells.cell[c] - cells, &pos[0], &pos[1], &pos[2], dd.ghost_cell_grid);
+     myPos[0] = my_left[0] + dd.cell_size[0] * pos[0];
+     myPos[1] = my_left[1] + dd.cell_size[1] * pos[1];
+     myPos[2] = my_left[2] + dd.cell_size[2] * pos[2];
 
      for(nn=0;nn<dd.cell_inter[c].n_neighbors;nn++){
         
@@ -755,6 +838,11 @@ void dd_on_geometry_change(int flags) {
         runtimeError(msg);
     }
 
+  /* The checks below are local, and with domains of different sizes,
+     the nodes could come to different conclusions. */
+  if (!grid_is_regular())
+    flags |= CELL_FLAG_GRIDCHANGED;
+
   /* A full resorting is necessary if the grid has changed. We simply
      don't have anything fast for this case. Probably also not
      necessary. */
@@ -820,6 +908,10 @@ void dd_topology_init(CellPList *old)
 
   /** broadcast the flag for using verlet list */
   MPI_Bcast(&dd.use_vList, 1, MPI_INT, 0, comm_cart);
+  /** and the one for the SoA particle mirror */
+  MPI_Bcast(&dd.use_soa, 1, MPI_INT, 0, comm_cart);
+  /** and the one for the nonblocking ghost communication */
+  MPI_Bcast(&dd.async_ghosts, 1, MPI_INT, 0, comm_cart);
  
   cell_structure.type             = CELL_STRUCTURE_DOMDEC;
   cell_structure.position_to_node = map_position_node_array;
@@ -859,6 +951,14 @@ void dd_topology_init(CellPList *old)
   dd_assign_prefetches(&cell_structure.update_ghost_pos_comm);
   dd_assign_prefetches(&cell_structure.collect_ghost_force_comm);
 
+#ifndef LEES_EDWARDS
+  /* the Lees-Edwards communicators change with the offset, so they stay blocking */
+  if (dd.async_ghosts) {
+    ghost_enable_async(&cell_structure.update_ghost_pos_comm);
+    ghost_enable_async(&cell_structure.collect_ghost_force_comm);
+  }
+#endif
+
 #ifdef LB
   dd_prepare_comm(&cell_structure.ghost_lbcoupling_comm, GHOSTTRANS_COUPLING) ;
   dd_assign_prefetches(&cell_structure.ghost_lbcoupling_comm) ;
@@ -1316,3 +1416,154 @@ void calculate_link_cell_virials(int v_comp)
 }
 
 /************************************************************/
+
+/************************************************************/
+/** \name Load balancing */
+/************************************************************/
+/*@{*/
+
+/** Whether the active methods allow node domains of different sizes.
+    Mesh and lattice based methods distribute their grids in the same
+    way as the regular node grid. */
+static int dd_balance_possible()
+{
+#ifdef LEES_EDWARDS
+  return 0;
+#else
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC)
+    return 0;
+#ifdef ELECTROSTATICS
+  if (coulomb.method != COULOMB_NONE && coulomb.method != COULOMB_DH &&
+      coulomb.method != COULOMB_RF && coulomb.method != COULOMB_INTER_RF)
+    return 0;
+#endif
+#ifdef DIPOLES
+  if (coulomb.Dmethod != DIPOLAR_NONE &&
+      coulomb.Dmethod != DIPOLAR_ALL_WITH_ALL_AND_NO_REPLICA)
+    return 0;
+#endif
+#if defined(LB) || defined(LB_GPU)
+  if (lattice_switch != LATTICE_OFF)
+    return 0;
+#endif
+#ifdef NPT
+  /* box changes would rebuild the cell system every step */
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    return 0;
+#endif
+  return 1;
+#endif
+}
+
+/** New domain boundaries in one direction. The load density within each
+    of the old domains is assumed to be constant, and the boundaries are
+    moved a fraction \ref DD_BALANCE_RELAXATION towards the positions
+    that split the load evenly. The domains are kept between \a w_min
+    and twice the regular size. */
+static void dd_balance_bounds(int n, double *load, double *old_b, double *new_b, double w_min)
+{
+  int j, k;
+  double total = 0, cum = 0, w_max = 2.0/n;
+
+  for (j = 0; j < n; j++)
+    total += load[j];
+
+  new_b[0] = 0;
+  new_b[n] = 1;
+  for (j = 0, k = 1; k < n; k++) {
+    double target = total*k/n, x;
+    while (j < n - 1 && cum + load[j] <= target)
+      cum += load[j++];
+    if (load[j] > 0)
+      x = old_b[j] + (target - cum)/load[j]*(old_b[j+1] - old_b[j]);
+    else
+      x = old_b[j];
+    new_b[k] = old_b[k] + DD_BALANCE_RELAXATION*(x - old_b[k]);
+  }
+
+  /* keep the domain sizes in range, and leave enough space for the rest */
+  for (k = 1; k < n; k++) {
+    double lo = dmax(new_b[k-1] + w_min, 1 - (n - k)*w_max);
+    double hi = dmin(new_b[k-1] + w_max, 1 - (n - k)*w_min);
+    new_b[k] = dmin(dmax(new_b[k], lo), hi);
+  }
+}
+
+/** Measure the load imbalance and shift the domain boundaries. */
+static void dd_balance()
+{
+  int d, k, off, n_slabs = node_grid[0] + node_grid[1] + node_grid[2];
+  std::vector<double> load(n_slabs, 0.0), slab_load(n_slabs);
+  double t_max, t_total = 0;
+  int changed = 0;
+
+  /* the loads of the planes of the node grid */
+  for (d = 0, off = 0; d < 3; off += node_grid[d], d++)
+    load[off + node_pos[d]] = dd_force_time;
+  MPI_Allreduce(&load[0], &slab_load[0], n_slabs, MPI_DOUBLE, MPI_SUM, comm_cart);
+  MPI_Allreduce(&dd_force_time, &t_max, 1, MPI_DOUBLE, MPI_MAX, comm_cart);
+  dd_force_time = 0;
+
+  /* every node is in exactly one x plane */
+  for (k = 0; k < node_grid[0]; k++)
+    t_total += slab_load[k];
+  load_imbalance = (t_total > 0) ? t_max*n_nodes/t_total : 1.0;
+
+  CELL_TRACE(fprintf(stderr, "%d: dd_balance: imbalance %f\n", this_node, load_imbalance));
+
+  if (!dd_balance_possible() || load_imbalance < 1 + DD_BALANCE_TOLERANCE)
+    return;
+
+  for (d = 0, off = 0; d < 3; off += node_grid[d], d++) {
+    int n = node_grid[d];
+    double w_min = (1 + 1e-6)*dd_regular_cell_range[d]/box_l[d];
+    std::vector<double> old_b(n + 1), new_b(n + 1);
+    double shift = 0;
+
+    if (n == 1 || w_min*n >= 1)
+      continue;
+    for (k = 0; k <= n; k++)
+      old_b[k] = node_bounds[d] ? node_bounds[d][k] : (double)k/n;
+    dd_balance_bounds(n, &slab_load[off], &old_b[0], &new_b[0], w_min);
+    for (k = 1; k < n; k++)
+      shift = dmax(shift, fabs(new_b[k] - old_b[k]));
+    /* not worth a new cell system */
+    if (shift*n < 0.01)
+      continue;
+    grid_set_bounds(d, &new_b[0]);
+    changed = 1;
+  }
+
+  if (changed) {
+    cells_on_geometry_change(CELL_FLAG_GRIDCHANGED);
+    cells_resort_particles(CELL_GLOBAL_EXCHANGE);
+  }
+}
+
+void dd_balance_step()
+{
+  if (dd_balance_interval <= 0 || cell_structure.type != CELL_STRUCTURE_DOMDEC)
+    return;
+  if (++dd_balance_steps < dd_balance_interval)
+    return;
+  dd_balance_steps = 0;
+  dd_balance();
+}
+
+void dd_balance_reset(int always)
+{
+  int d;
+
+  if (grid_is_regular() || (!always && dd_balance_possible()))
+    return;
+
+  for (d = 0; d < 3; d++)
+    grid_set_bounds(d, NULL);
+  /* rebuilds the cell system, and on_cell_structure_change sets up
+     all domain dependent methods again */
+  cells_on_geometry_change(CELL_FLAG_GRIDCHANGED);
+  cells_resort_particles(CELL_GLOBAL_EXCHANGE);
+  load_imbalance = 1.0;
+}
+
+/*@}*/
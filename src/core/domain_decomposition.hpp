@@ -51,6 +51,14 @@
  * communication! For single sided ghost communication one would need
  * some ghost-ghost cell interaction as well, which we do not need!
  *
+ * The local cells in \ref local_cells, and with them the neighbor
+ * lists in \ref DomainDecomposition::cell_inter, are ordered along a
+ * Morton (Z-order) space filling curve through the cell grid, so
+ * that consecutive cells share most of their neighbor cells and the
+ * cell and verlet list loops traverse the grid in cache friendly
+ * blocks. The verlet lists of the cell pairs store particle indices
+ * instead of pointers, see \ref PairList.
+ *
  *  For more information on cells,
  *  see \ref cells.hpp 
 */
@@ -106,6 +114,12 @@ typedef struct {
 typedef struct {
   /** flag for using Verlet List */
   int use_vList;
+  /** flag for using the packed SoA particle mirror in the force loop,
+      see \ref particle_soa.hpp */
+  int use_soa;
+  /** flag for the nonblocking ghost position update and force
+      collection, see \ref ghost_enable_async */
+  int async_ghosts;
   /** linked cell grid in nodes spatial domain. */
   int cell_grid[3];
   /** linked cell grid with ghost frame. */
@@ -149,6 +163,20 @@ extern int max_num_cells;
 */
 extern int min_num_cells;
 
+/** Number of integration steps between two adjustments of the domain
+    boundaries to the measured load, see \ref dd_balance_step. 0 switches
+    the load balancing off and restores the regular node grid. */
+extern int dd_balance_interval;
+
+/** Maximal time per node spent in the short ranged force loop during the
+    last balancing interval, relative to the average over the nodes. 1
+    means perfectly balanced. */
+extern double load_imbalance;
+
+/** Time spent in the short ranged force loop on this node since the
+    last balancing step. */
+extern double dd_force_time;
+
 /*@}*/
 
 /************************************************************/
@@ -234,6 +262,24 @@ Cell *dd_save_position_to_cell(double pos[3]);
 
 /** Of every two communication rounds, set the first receivers to prefetch and poststore */
 void dd_assign_prefetches(GhostCommunicator *comm);
+
+/** Load balancing, called after every integration step on all nodes.
+    Every \ref dd_balance_interval steps, the loads of the nodes are
+    compared (see \ref load_imbalance), and if they differ, the
+    boundaries between the planes of the node grid are shifted such that
+    each plane gets the same share of the measured force time. Since the
+    domains stay a rectilinear grid, the ghost communication does not
+    change. The particles are then redistributed by a global exchange. */
+void dd_balance_step();
+
+/** Restore the regular node grid if the load balancing has shifted the
+    domains, and either \a always is set or the active methods require
+    equal domains, like the mesh based electrostatics, the lattice
+    Boltzmann fluid or NpT. The methods that depend on the domains are
+    set up again by \ref on_cell_structure_change. Has to be called on
+    all nodes, before a method that needs equal domains is set up.
+    @param always restore the grid independent of the methods. */
+void dd_balance_reset(int always);
 /*@}*/
 
 #endif
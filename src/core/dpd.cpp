@@ -41,6 +41,25 @@ double dpd_tr_cut = 0.0;
 /* trans DPD weightfunction */
 int dpd_twf = 0;
 
+#if defined(DPD) || defined(INTER_DPD)
+/** The four uniform random numbers in [-0.5,0.5) of a pair from the
+    counter based generator. They depend only on the pair and the step,
+    and the last three, which are used as a vector, change sign with the
+    order of the particles, like the forces. */
+static void dpd_counter_noise(int stream, Particle *p1, Particle *p2, double rnd[4])
+{
+  int id1 = p1->p.identity, id2 = p2->p.identity;
+
+  counter_random_uniform(stream, imin(id1, id2), imax(id1, id2), 0, rnd);
+  for (int i = 0; i < 4; i++)
+    rnd[i] -= 0.5;
+  if (id1 > id2)
+    for (int i = 1; i < 4; i++)
+      rnd[i] = -rnd[i];
+}
+
+#endif
+
 #ifdef DPD
 
 /** Chatterjee 2007 proposes that for DPD with Lees Edwards BCs,
@@ -210,6 +229,10 @@ void add_dpd_thermo_pair_force(Particle * p1, Particle * p2, double d[3], double
 
 
   dist_inv = 1.0/dist;
+  double rnd[4];
+  int use_counter = rng_counter_mask & THERMO_DPD;
+  if (use_counter && (dist < dpd_r_cut || dist < dpd_tr_cut))
+    dpd_counter_noise(RNG_STREAM_DPD, p1, p2, rnd);
 
   if((dist < dpd_r_cut)&&(dpd_gamma > 0.0)) {
     if ( dpd_wf == 1 ) //w_R=1
@@ -229,7 +252,7 @@ void add_dpd_thermo_pair_force(Particle * p1, Particle * p2, double d[3], double
     for(j=0; j<3; j++)  vel12_dot_d12 += (p1->m.v[j] - p2->m.v[j]) * d[j];
     friction = dpd_pref1 * omega2 * vel12_dot_d12;
     // random force prefactor
-    noise    = dpd_pref2 * omega      * (d_random()-0.5);
+    noise    = dpd_pref2 * omega      * (use_counter ? rnd[0] : d_random()-0.5);
     for(j=0; j<3; j++) {
        p1->f.f[j] += ( tmp = (noise - friction)*d[j] );
        p2->f.f[j] -= tmp;
@@ -252,7 +275,7 @@ void add_dpd_thermo_pair_force(Particle * p1, Particle * p2, double d[3], double
       omega2   = SQR(omega);
       for (i=0;i<3;i++){
         //noise vector
-        noise_vec[i]=d_random()-0.5;
+        noise_vec[i]=use_counter ? rnd[i+1] : d_random()-0.5;
         // Projection Matrix
         for (j=0;j<3;j++){
           P_times_dist_sqr[i][j]-=d[i]*d[j];
@@ -419,6 +442,10 @@ void add_inter_dpd_pair_force(Particle *p1, Particle *p2, IA_parameters *ia_para
   P_times_dist_sqr[1][1]=dist2;
   P_times_dist_sqr[2][2]=dist2;
   dist_inv = 1.0/dist;
+  double rnd[4];
+  int use_counter = rng_counter_mask & THERMO_INTER_DPD;
+  if (use_counter && (dist < ia_params->dpd_r_cut || dist < ia_params->dpd_tr_cut))
+    dpd_counter_noise(RNG_STREAM_INTER_DPD, p1, p2, rnd);
   if((dist < ia_params->dpd_r_cut)&&(ia_params->dpd_gamma > 0.0)) {
     if ( dpd_wf == 1 )
     {
@@ -437,7 +464,7 @@ void add_inter_dpd_pair_force(Particle *p1, Particle *p2, IA_parameters *ia_para
     for(j=0; j<3; j++)  vel12_dot_d12 += (p1->m.v[j] - p2->m.v[j]) * d[j];
     friction = ia_params->dpd_pref1 * omega2 * vel12_dot_d12;
     // random force prefactor
-    noise    = ia_params->dpd_pref2 * omega      * (d_random()-0.5);
+    noise    = ia_params->dpd_pref2 * omega      * (use_counter ? rnd[0] : d_random()-0.5);
     for(j=0; j<3; j++) {
        p1->f.f[j] += ( tmp = (noise - friction)*d[j] );
        p2->f.f[j] -= tmp;
@@ -459,7 +486,7 @@ void add_inter_dpd_pair_force(Particle *p1, Particle *p2, IA_parameters *ia_para
       omega2   = SQR(omega);
       for (i=0;i<3;i++){
         //noise vector
-        noise_vec[i]=d_random()-0.5;
+        noise_vec[i]=use_counter ? rnd[i+1] : d_random()-0.5;
         // Projection Matrix
         for (j=0;j<3;j++){
           P_times_dist_sqr[i][j]-=d[i]*d[j];
@@ -32,6 +32,7 @@
 #include "external_potential.hpp"
 */
 #include "energy_inline.hpp"
+#include "particle_soa.hpp"
 #include "maggs.hpp"
 #include "initialize.hpp"
 #include "magnetic_non_p3m_methods.hpp"
@@ -125,7 +126,8 @@ void energy_calc(double *result)
     layered_calculate_energies();
     break;
   case CELL_STRUCTURE_DOMDEC: 
-    if(dd.use_vList) {
+    /* the SoA kernel does not maintain the normal verlet lists */
+    if(dd.use_vList && !soa_kernel_active) {
       if (rebuild_verletlist)  
 	build_verlet_lists();
       calculate_verlet_energies();
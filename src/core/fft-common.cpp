@@ -51,6 +51,13 @@ void fft_common_pre_init(fft_data_struct *fft)
   fft->send_buf = NULL;
   fft->recv_buf = NULL;
   fft->data_buf = NULL;
+
+  fft->comm = FFT_COMM_NONBLOCKING;
+  fft->group_send_buf = NULL;
+  fft->group_recv_buf = NULL;
+  fft->group_buf_size = 0;
+  fft->group_recv_off = (int*)Utils::malloc(n_nodes*sizeof(int));
+  fft->requests = (MPI_Request*)Utils::malloc(2*n_nodes*sizeof(MPI_Request));
 }
 
 void fft_pack_block(double *in, double *out, int start[3], int size[3], int dim[3], int element)
@@ -301,6 +308,71 @@ int fft_calc_send_block(int pos1[3], int grid1[3], int pos2[3], int grid2[3],
   return size;
 }
 
+void fft_grid_comm_nonblocking(fft_data_struct *fft, int g_size, int *group,
+			       void (*pack_function)(double*, double*, int*, int*, int*, int),
+			       double *in, int *s_block, int *s_size, int *s_dim,
+			       double *out, int *r_block, int *r_size, int *r_dim,
+			       int element, int tag)
+{
+  int i, s_total = 0, r_total = 0, off, self = -1, self_off = 0;
+  MPI_Request *s_req = fft->requests + g_size;
+
+  for(i=0;i<g_size;i++) {
+    s_total += s_size[i];
+    r_total += r_size[i];
+  }
+  if(s_total > fft->group_buf_size || r_total > fft->group_buf_size) {
+    fft->group_buf_size = imax(s_total, r_total);
+    fft->group_send_buf = (double *)Utils::realloc(fft->group_send_buf, fft->group_buf_size*sizeof(double));
+    fft->group_recv_buf = (double *)Utils::realloc(fft->group_recv_buf, fft->group_buf_size*sizeof(double));
+  }
+
+  /* post all receives first */
+  off = 0;
+  for(i=0;i<g_size;i++) {
+    fft->group_recv_off[i] = off;
+    if(group[i] != this_node)
+      MPI_Irecv(fft->group_recv_buf + off, r_size[i], MPI_DOUBLE,
+		group[i], tag, comm_cart, &fft->requests[i]);
+    else
+      fft->requests[i] = MPI_REQUEST_NULL;
+    off += r_size[i];
+  }
+
+  /* pack and send one block after the other, so that the first
+     messages are on their way while the others are packed */
+  off = 0;
+  for(i=0;i<g_size;i++) {
+    pack_function(in, fft->group_send_buf + off, &(s_block[6*i]),
+		  &(s_block[6*i+3]), s_dim, element);
+    if(group[i] != this_node)
+      MPI_Isend(fft->group_send_buf + off, s_size[i], MPI_DOUBLE,
+		group[i], tag, comm_cart, &s_req[i]);
+    else {
+      s_req[i] = MPI_REQUEST_NULL;
+      self = i;
+      self_off = off;
+    }
+    off += s_size[i];
+  }
+
+  /* the own block needs no communication */
+  if(self != -1)
+    fft_unpack_block(fft->group_send_buf + self_off, out, &(r_block[6*self]),
+		     &(r_block[6*self+3]), r_dim, element);
+
+  /* unpack the other blocks in the order they arrive */
+  for(;;) {
+    MPI_Waitany(g_size, fft->requests, &i, MPI_STATUS_IGNORE);
+    if(i == MPI_UNDEFINED)
+      break;
+    fft_unpack_block(fft->group_recv_buf + fft->group_recv_off[i], out,
+		     &(r_block[6*i]), &(r_block[6*i+3]), r_dim, element);
+  }
+
+  MPI_Waitall(g_size, s_req, MPI_STATUSES_IGNORE);
+}
+
 void fft_print_fft_plan(fft_forw_plan pl)
 {
   int i;
@@ -25,6 +25,7 @@
 #if defined(P3M) || defined(DP3M)
 
 #include <fftw3.h>
+#include <mpi.h>
 
 /************************************************
  * data types
@@ -116,6 +117,20 @@ typedef struct {
   double *recv_buf;
   /** Buffer for receive data. */
   double *data_buf;
+
+  /** communication scheme of the grid redistribution, one of the
+      FFT_COMM_ constants. */
+  int comm;
+  /** send buffer for the blocks of all nodes of a group (\ref FFT_COMM_NONBLOCKING). */
+  double *group_send_buf;
+  /** receive buffer for the blocks of all nodes of a group (\ref FFT_COMM_NONBLOCKING). */
+  double *group_recv_buf;
+  /** size of \ref group_send_buf and \ref group_recv_buf. */
+  int group_buf_size;
+  /** offsets of the receive blocks in \ref group_recv_buf. */
+  int *group_recv_off;
+  /** send and receive requests of the nonblocking communication. */
+  MPI_Request *requests;
 } fft_data_struct;
 
 /************************************************
@@ -132,6 +147,17 @@ typedef struct {
 /* Tag for wisdom file I/O */
 #  define FFTW_FAILURE 0
 
+/** \name Communication schemes for the grid redistribution of the FFT */
+/*@{*/
+/** blocking exchange with one node of the communication group after the other. */
+#define FFT_COMM_SENDRECV    0
+/** all blocks of a communication group are exchanged at the same
+    time. The sends are started while the remaining blocks are still
+    packed, and the received blocks are unpacked in the order in which
+    they arrive. */
+#define FFT_COMM_NONBLOCKING 1
+/*@}*/
+
 /** Initialize FFT data structure. */
 void fft_common_pre_init(fft_data_struct *fft);
 
@@ -293,6 +319,32 @@ void fft_pack_block_permute2(double *in, double *out, int start[3], int size[3],
 void fft_unpack_block(double *in, double *out, int start[3], int size[3], 
 		      int dim[3], int element);
 
+/** Redistribute the grid with nonblocking communication (\ref
+ *  FFT_COMM_NONBLOCKING). The node sends to group node i the block
+ *  s_block[6*i] of the in-grid, and receives the block r_block[6*i] of
+ *  the out-grid.
+ *
+ * \param fft           fft data structure, for the buffers.
+ * \param g_size        size of the communication group.
+ * \param group         node identities of the communication group.
+ * \param pack_function function to pack the send blocks.
+ * \param in            input grid.
+ * \param s_block       send block specifications.
+ * \param s_size        send block sizes.
+ * \param s_dim         dimensions of the input grid.
+ * \param out           output grid.
+ * \param r_block       receive block specifications.
+ * \param r_size        receive block sizes.
+ * \param r_dim         dimensions of the output grid.
+ * \param element       size of a grid element.
+ * \param tag           MPI tag.
+ */
+void fft_grid_comm_nonblocking(fft_data_struct *fft, int g_size, int *group,
+			       void (*pack_function)(double*, double*, int*, int*, int*, int),
+			       double *in, int *s_block, int *s_size, int *s_dim,
+			       double *out, int *r_block, int *r_size, int *r_dim,
+			       int element, int tag);
+
 /** Debug function to print global fft mesh. 
     Print a globaly distributed mesh contained in data. Element size is element. 
  * \param plan     fft/communication plan (see \ref fft_forw_plan).
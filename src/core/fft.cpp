@@ -407,6 +407,14 @@ void fft_forw_grid_comm(fft_forw_plan plan, double *in, double *out)
   MPI_Status status;
   double *tmp_ptr;
 
+  if(fft.comm == FFT_COMM_NONBLOCKING) {
+    fft_grid_comm_nonblocking(&fft, plan.g_size, plan.group, plan.pack_function,
+			      in, plan.send_block, plan.send_size, plan.old_mesh,
+			      out, plan.recv_block, plan.recv_size, plan.new_mesh,
+			      plan.element, REQ_FFT_FORW);
+    return;
+  }
+
   for(i=0;i<plan.g_size;i++) {   
     plan.pack_function(in, fft.send_buf, &(plan.send_block[6*i]), 
 		       &(plan.send_block[6*i+3]), plan.old_mesh, plan.element);
@@ -443,6 +451,14 @@ void fft_back_grid_comm(fft_forw_plan plan_f,  fft_back_plan plan_b, double *in,
      replace the recieve blocks by the send blocks and vice
      versa. Attention then also new_mesh and old_mesh are exchanged */
 
+  if(fft.comm == FFT_COMM_NONBLOCKING) {
+    fft_grid_comm_nonblocking(&fft, plan_f.g_size, plan_f.group, plan_b.pack_function,
+			      in, plan_f.recv_block, plan_f.recv_size, plan_f.new_mesh,
+			      out, plan_f.send_block, plan_f.send_size, plan_f.old_mesh,
+			      plan_f.element, REQ_FFT_BACK);
+    return;
+  }
+
   for(i=0;i<plan_f.g_size;i++) {
     
     plan_b.pack_function(in, fft.send_buf, &(plan_f.recv_block[6*i]), 
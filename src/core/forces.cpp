@@ -185,6 +185,10 @@ void calc_long_range_forces()
 #endif
 #ifdef P3M
   case COULOMB_P3M:
+    /* with kspace_interval > 1, the k-space forces are only calculated
+       every kspace_interval steps, as an impulse of kspace_interval steps */
+    if (kspace_step != 0)
+      break;
     FORCE_TRACE(printf("%d: Computing P3M forces.\n", this_node));
     p3m_charge_assign();
 #ifdef NPT
@@ -192,7 +196,7 @@ void calc_long_range_forces()
       nptiso.p_vir[0] += p3m_calc_kspace_forces(1,1);
     else
 #endif
-      p3m_calc_kspace_forces(1, 0);
+      p3m_calc_kspace_forces(kspace_interval, 0);
     break;
 #endif
   case COULOMB_MAGGS:
@@ -83,6 +83,7 @@
 #include "immersed_boundary/ibm_triel.hpp"
 #include "immersed_boundary/ibm_volume_conservation.hpp"
 #include "immersed_boundary/ibm_tribend.hpp"
+#include "particle_soa.hpp"
 
 using namespace std;
 
@@ -169,6 +170,25 @@ inline void init_local_particle_force(Particle *part) {
 #endif
 }
 
+/** Whether the ghost position update can run while the pair forces
+    within this node are calculated, see \ref
+    calculate_verlet_ia_overlapped. Everything in \ref force_calc before
+    the pair loop then has to work without the ghost positions. */
+inline int force_calc_can_overlap()
+{
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC || !dd.use_vList ||
+      soa_kernel_active || rebuild_verletlist)
+    return 0;
+#ifdef ELECTROSTATICS
+  if (iccp3m_initialized && iccp3m_cfg.set_flag)
+    return 0;
+  // Maggs works on the ghost cells
+  if (coulomb.method == COULOMB_MAGGS)
+    return 0;
+#endif
+  return 1;
+}
+
 /** Calculate forces.
  *
  *  A short list, what the function is doing:
@@ -194,13 +214,25 @@ inline void init_local_particle_force(Particle *part) {
  */
 inline void force_calc()
 {
-  // Communication step: distribute ghost positions
+  // a new time for the counter based random numbers
+  rng_counter_step++;
+
+  // Communication step: distribute ghost positions. If possible, the
+  // last update is completed in the pair loop
+  int ghosts_pending = 0;
+#ifdef VIRTUAL_SITES
   cells_update_ghosts();
 
   // VIRTUAL_SITES pos (and vel for DPD) update for security reason !!!
-#ifdef VIRTUAL_SITES
   update_mol_vel_pos();
-  ghost_communicator(&cell_structure.update_ghost_pos_comm);
+  if (force_calc_can_overlap())
+    ghosts_pending = cells_update_ghosts_start(1);
+  else {
+    ghost_communicator(&cell_structure.update_ghost_pos_comm);
+    soa_update_cells(SOA_UPDATE_POS);
+  }
+#else
+  ghosts_pending = cells_update_ghosts_start(force_calc_can_overlap());
 #endif
 
 #if defined(VIRTUAL_SITES_RELATIVE) && defined(LB)
@@ -245,14 +277,19 @@ espressoSystemInterface.update();
 
   calc_long_range_forces();
 
+  double t_short_range = MPI_Wtime();
   switch (cell_structure.type) {
   case CELL_STRUCTURE_LAYERED:
     layered_calculate_ia();
     break;
   case CELL_STRUCTURE_DOMDEC:
-    if(dd.use_vList) {
+    if (soa_kernel_active)
+      soa_calculate_ia();
+    else if(dd.use_vList) {
       if (rebuild_verletlist)
     build_verlet_lists_and_calc_verlet_ia();
+      else if (ghosts_pending)
+    calculate_verlet_ia_overlapped();
       else
     calculate_verlet_ia();
     }
@@ -263,6 +300,8 @@ espressoSystemInterface.update();
     nsq_calculate_ia();
 
   }
+  /* the load measure for the domain decomposition balancing */
+  dd_force_time += MPI_Wtime() - t_short_range;
 
 #ifdef OIF_GLOBAL_FORCES
     double area_volume[2]; //There are two global quantities that need to be evaluated: object's surface and object's volume. One can add another quantity.
@@ -323,79 +362,173 @@ espressoSystemInterface.update();
 }
 
 
-inline void 
-calc_non_bonded_pair_force_parts(const Particle * const p1, const Particle * const p2, IA_parameters *ia_params,
-                                 double d[3], double dist, double dist2, 
-                                 double force[3], 
-                                 double torque1[3] = NULL, double torque2[3] = NULL) {
-#ifdef NO_INTRA_NB
-  if (p1->p.mol_id==p2->p.mol_id) return;
-#endif
+/** Switch for the potentials in \ref calc_non_bonded_pair_force_kernel.
+    For the generic kernel, the active potentials are looked up at run
+    time, otherwise the set of potentials is fixed at compile time. */
+#define NONBONDED_KERNEL_HAS(flag) \
+  ((potentials & (flag)) && \
+   (potentials != NONBONDED_PAIR_FORCES || (ia_params->potentials & (flag))))
+
+/** Nonbonded pair forces of the potentials in the template parameter,
+    a combination of the NONBONDED_* flags. The checks and calls for
+    all other potentials are removed by the compiler, so that type
+    pairs with only one potential do not run through the whole chain
+    of potentials. With \ref NONBONDED_PAIR_FORCES, this is the generic
+    kernel that checks \ref IA_parameters::potentials. */
+template<int potentials>
+inline void
+calc_non_bonded_pair_force_kernel(const Particle * const p1, const Particle * const p2, IA_parameters *ia_params,
+                                  double d[3], double dist, double dist2,
+                                  double force[3],
+                                  double torque1[3], double torque2[3]) {
   /* lennard jones */
 #ifdef LENNARD_JONES
-  add_lj_pair_force(p1,p2,ia_params,d,dist, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_LJ))
+    add_lj_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
   /* lennard jones generic */
 #ifdef LENNARD_JONES_GENERIC
-  add_ljgen_pair_force(p1,p2,ia_params,d,dist, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_LJGEN))
+    add_ljgen_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
   /* smooth step */
 #ifdef SMOOTH_STEP
-  add_SmSt_pair_force(p1, p2, ia_params, d, dist, dist2, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_SMOOTH_STEP))
+    add_SmSt_pair_force(p1, p2, ia_params, d, dist, dist2, force);
 #endif
   /* Hertzian force */
 #ifdef HERTZIAN
-  add_hertzian_pair_force(p1, p2, ia_params, d, dist, dist2, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_HERTZIAN))
+    add_hertzian_pair_force(p1, p2, ia_params, d, dist, dist2, force);
 #endif
   /* Gaussian force */
 #ifdef GAUSSIAN
-  add_gaussian_pair_force(p1, p2, ia_params, d, dist, dist2, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_GAUSSIAN))
+    add_gaussian_pair_force(p1, p2, ia_params, d, dist, dist2, force);
 #endif
   /* BMHTF NaCl */
 #ifdef BMHTF_NACL
-  add_BMHTF_pair_force(p1,p2,ia_params,d,dist,dist2, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_BMHTF))
+    add_BMHTF_pair_force(p1,p2,ia_params,d,dist,dist2, force);
 #endif
   /* buckingham*/
 #ifdef BUCKINGHAM
-  add_buck_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_BUCKINGHAM))
+    add_buck_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* morse*/
 #ifdef MORSE
-  add_morse_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_MORSE))
+    add_morse_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
  /*soft-sphere potential*/
 #ifdef SOFT_SPHERE
-  add_soft_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_SOFT_SPHERE))
+    add_soft_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
  /*repulsive membrane potential*/
 #ifdef MEMBRANE_COLLISION
+  if (NONBONDED_KERNEL_HAS(NONBONDED_MEMBRANE_COLLISION))
     add_membrane_collision_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
  /*hat potential*/
 #ifdef HAT
-  add_hat_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_HAT))
+    add_hat_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* lennard jones cosine */
 #ifdef LJCOS
-  add_ljcos_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_LJCOS))
+    add_ljcos_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* lennard jones cosine */
 #ifdef LJCOS2
-  add_ljcos2_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_LJCOS2))
+    add_ljcos2_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* tabulated */
 #ifdef TABULATED
-  add_tabulated_pair_force(p1,p2,ia_params,d,dist,force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_TABULATED))
+    add_tabulated_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* Gay-Berne */
 #ifdef GAY_BERNE
-  add_gb_pair_force(p1,p2,ia_params,d,dist,force,torque1,torque2);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_GAY_BERNE))
+    add_gb_pair_force(p1,p2,ia_params,d,dist,force,torque1,torque2);
 #endif
 #ifdef INTER_RF
-  add_interrf_pair_force(p1,p2,ia_params,d,dist, force);
+  if (NONBONDED_KERNEL_HAS(NONBONDED_INTER_RF))
+    add_interrf_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
 }
 
+#undef NONBONDED_KERNEL_HAS
+
+#define NONBONDED_KERNEL_CASE(flags) \
+  case flags: \
+    calc_non_bonded_pair_force_kernel<flags>(p1, p2, ia_params, d, dist, dist2, \
+                                             force, torque1, torque2); \
+    break;
+
+/** Nonbonded pair forces between p1 and p2. Dispatches to a kernel
+    for exactly the potentials active for the type pair, see \ref
+    IA_parameters::potentials. */
+inline void 
+calc_non_bonded_pair_force_parts(const Particle * const p1, const Particle * const p2, IA_parameters *ia_params,
+                                 double d[3], double dist, double dist2, 
+                                 double force[3], 
+                                 double torque1[3] = NULL, double torque2[3] = NULL) {
+#ifdef NO_INTRA_NB
+  if (p1->p.mol_id==p2->p.mol_id) return;
+#endif
+  switch (ia_params->potentials & NONBONDED_PAIR_FORCES) {
+  case 0:
+    /* no pair potential, e.g. only electrostatics */
+    break;
+#ifdef LENNARD_JONES
+  NONBONDED_KERNEL_CASE(NONBONDED_LJ)
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  NONBONDED_KERNEL_CASE(NONBONDED_LJGEN)
+#endif
+#ifdef SOFT_SPHERE
+  NONBONDED_KERNEL_CASE(NONBONDED_SOFT_SPHERE)
+#endif
+#ifdef LJCOS
+  NONBONDED_KERNEL_CASE(NONBONDED_LJCOS)
+#endif
+#ifdef LJCOS2
+  NONBONDED_KERNEL_CASE(NONBONDED_LJCOS2)
+#endif
+#ifdef TABULATED
+  NONBONDED_KERNEL_CASE(NONBONDED_TABULATED)
+#endif
+#ifdef GAY_BERNE
+  NONBONDED_KERNEL_CASE(NONBONDED_GAY_BERNE)
+#endif
+#ifdef MORSE
+  NONBONDED_KERNEL_CASE(NONBONDED_MORSE)
+#endif
+#ifdef BUCKINGHAM
+  NONBONDED_KERNEL_CASE(NONBONDED_BUCKINGHAM)
+#endif
+#ifdef HERTZIAN
+  NONBONDED_KERNEL_CASE(NONBONDED_HERTZIAN)
+#endif
+#ifdef GAUSSIAN
+  NONBONDED_KERNEL_CASE(NONBONDED_GAUSSIAN)
+#endif
+#if defined(LENNARD_JONES) && defined(INTER_RF)
+  NONBONDED_KERNEL_CASE(NONBONDED_LJ | NONBONDED_INTER_RF)
+#endif
+  default:
+    calc_non_bonded_pair_force_kernel<NONBONDED_PAIR_FORCES>(p1, p2, ia_params, d, dist, dist2,
+                                                             force, torque1, torque2);
+  }
+}
+
+#undef NONBONDED_KERNEL_CASE
+
 inline void
 calc_non_bonded_pair_force(Particle *p1, Particle *p2, IA_parameters *ia_params,
                            double d[3], double dist, double dist2,
@@ -328,13 +328,48 @@ void tscale_momentum_update()
 	
 }
 
+/** Gaussian random numbers for the momenta of a particle, the first
+    three for the velocity, the second three for the angular velocity.
+    With the counter based generator, they do not depend on the order of
+    the particles. */
+static void ghmc_gaussian_momenta(Particle *p, double rnd[8])
+{
+  int j;
+
+  if (rng_counter_mask & THERMO_GHMC) {
+    counter_random_gaussian(RNG_STREAM_GHMC, p->p.identity, 0, 0, rnd);
+#ifdef ROTATION
+    counter_random_gaussian(RNG_STREAM_GHMC_ROT, p->p.identity, 0, 0, rnd + 4);
+#endif
+    return;
+  }
+  for (j = 0; j < 3; j++) {
+    rnd[j] = gaussian_random();
+#ifdef ROTATION
+    rnd[4 + j] = gaussian_random();
+#endif
+  }
+}
+
+/** A uniform random number for the Monte Carlo decisions. With the
+    counter based generator, it is the same on all nodes. */
+static double ghmc_decision_random(int index)
+{
+  if (rng_counter_mask & THERMO_GHMC) {
+    double u[4];
+    counter_random_uniform(RNG_STREAM_GHMC_ACCEPT, 0, 0, index, u);
+    return u[0];
+  }
+  return d_random();
+}
+
 /* momentum update step of ghmc */
 void simple_momentum_update()
 {
 	
 	int i, j, c, np;
   Particle *part;
-	double sigmat, sigmar;
+	double sigmat, sigmar, rnd[8];
 	
 
 	sigmat = sqrt(temperature); sigmar = sqrt(temperature);
@@ -349,13 +384,14 @@ void simple_momentum_update()
 			#ifdef MASS
 				sigmat = sqrt(temperature / PMASS(part[i]));
 			#endif
+			ghmc_gaussian_momenta(&part[i], rnd);
       for (j = 0; j < 3; j++) {
-				part[i].m.v[j] = sigmat*gaussian_random()*time_step;
+				part[i].m.v[j] = sigmat*rnd[j]*time_step;
 				#ifdef ROTATION
 					#ifdef ROTATIONAL_INERTIA
 						sigmar = sqrt(temperature / part[i].p.rinertia[j]);
 					#endif
-					part[i].m.omega[j] = sigmar*gaussian_random();
+					part[i].m.omega[j] = sigmar*rnd[4 + j];
 				#endif	
 			}
     }
@@ -371,7 +407,7 @@ void partial_momentum_update()
 
 	int i, j, c, np;
   Particle *part;
-	double sigmat, sigmar;
+	double sigmat, sigmar, rnd[8];
 
 	//fprintf(stderr,"%d: temp before partial update: %f. expected: %f\n",this_node,calc_local_temp(),temperature);
 	sigmat = sqrt(temperature); sigmar = sqrt(temperature);
@@ -382,13 +418,14 @@ void partial_momentum_update()
 			#ifdef MASS
 				sigmat = sqrt(temperature / PMASS(part[i]));
 			#endif
+			ghmc_gaussian_momenta(&part[i], rnd);
       for (j = 0; j < 3; j++) {
-				part[i].m.v[j] = cosp*(part[i].m.v[j])+sinp*(sigmat*gaussian_random()*time_step);
+				part[i].m.v[j] = cosp*(part[i].m.v[j])+sinp*(sigmat*rnd[j]*time_step);
 				#ifdef ROTATION
 					#ifdef ROTATIONAL_INERTIA
 						sigmar = sqrt(temperature / part[i].p.rinertia[j]);
 					#endif
-					part[i].m.omega[j] = cosp*(part[i].m.omega[j])+sinp*(sigmar*gaussian_random());
+					part[i].m.omega[j] = cosp*(part[i].m.omega[j])+sinp*(sigmar*rnd[4 + j]);
 				#endif	
 			}
     }
@@ -491,7 +528,7 @@ void ghmc_mc()
         
         //fprintf(stderr,"old hamiltonian : %f, new hamiltonian: % f, boltzmann factor: %f\n",ghmcdata.hmlt_old,ghmcdata.hmlt_new,boltzmann);
 
-        if ( d_random() < boltzmann) {
+        if ( ghmc_decision_random(0) < boltzmann) {
           ghmcdata.acc++;
           ghmc_mc_res = GHMC_MOVE_ACCEPT;
         } else {
@@ -517,7 +554,7 @@ void ghmc_mc()
         if (ghmc_mflip == GHMC_MFLIP_ON) {
           momentum_flip();
         } else if (ghmc_mflip == GHMC_MFLIP_RAND) {
-          if (d_random() < 0.5) momentum_flip();
+          if (ghmc_decision_random(1) < 0.5) momentum_flip();
         }
       }      
         
@@ -79,14 +79,26 @@ void prepare_comm(GhostCommunicator *comm, int data_parts, int num)
   comm->comm = (GhostCommunication*)Utils::malloc(num*sizeof(GhostCommunication));
   for(i=0; i<num; i++) {
     comm->comm[i].shift[0]=comm->comm[i].shift[1]=comm->comm[i].shift[2]=0.0;
+    comm->comm[i].buffer = NULL;
+    comm->comm[i].n_buffer = comm->comm[i].max_buffer = 0;
+    comm->comm[i].request_size = -1;
   }
+  comm->async = 0;
+  comm->requests = NULL;
+  comm->stage_first = comm->stage_end = -1;
 }
 
 void free_comm(GhostCommunicator *comm)
 {
   int n;
   GHOST_TRACE(fprintf(stderr,"%d: free_comm: %p has %d ghost communications\n",this_node,comm,comm->num));
-  for (n = 0; n < comm->num; n++) free(comm->comm[n].part_lists);
+  for (n = 0; n < comm->num; n++) {
+    if (comm->async && comm->comm[n].request_size >= 0)
+      MPI_Request_free(&comm->requests[n]);
+    free(comm->comm[n].buffer);
+    free(comm->comm[n].part_lists);
+  }
+  free(comm->requests);
   free(comm->comm);
 }
 
@@ -134,22 +146,14 @@ int calc_transmit_size(GhostCommunication *gc, int data_parts)
   return n_buffer_new;
 }
 
-void prepare_send_buffer(GhostCommunication *gc, int data_parts)
+/** pack the data of the cells of a communication into a buffer of size
+    \ref calc_transmit_size. */
+static void fill_send_buffer(GhostCommunication *gc, int data_parts, char *buffer, int n_buffer)
 {
-  GHOST_TRACE(fprintf(stderr, "%d: prepare sending to/bcast from %d\n", this_node, gc->node));
-
-  /* reallocate send buffer */
-  n_s_buffer = calc_transmit_size(gc, data_parts);
-  if (n_s_buffer > max_s_buffer) {
-    max_s_buffer = n_s_buffer;
-    s_buffer = (char*)Utils::realloc(s_buffer, max_s_buffer);
-  }
-  GHOST_TRACE(fprintf(stderr, "%d: will send %d\n", this_node, n_s_buffer));
-
   s_bondbuffer.resize(0);
 
   /* put in data */
-  char *insert = s_buffer;
+  char *insert = buffer;
   for (int pl = 0; pl < gc->n_part_lists; pl++) {
     int np   = gc->part_lists[pl]->n;
     if (data_parts & GHOSTTRANS_PARTNUM) {
@@ -226,14 +230,29 @@ void prepare_send_buffer(GhostCommunication *gc, int data_parts)
     insert += sizeof(int);
   }
 
-  if (insert - s_buffer != n_s_buffer) {
+  if (insert - buffer != n_buffer) {
     fprintf(stderr, "%d: INTERNAL ERROR: send buffer size %d "
             "differs from what I put in (%ld)\n",
-            this_node, n_s_buffer, insert - s_buffer);
+            this_node, n_buffer, insert - buffer);
     errexit();
   }
 }
 
+void prepare_send_buffer(GhostCommunication *gc, int data_parts)
+{
+  GHOST_TRACE(fprintf(stderr, "%d: prepare sending to/bcast from %d\n", this_node, gc->node));
+
+  /* reallocate send buffer */
+  n_s_buffer = calc_transmit_size(gc, data_parts);
+  if (n_s_buffer > max_s_buffer) {
+    max_s_buffer = n_s_buffer;
+    s_buffer = (char*)Utils::realloc(s_buffer, max_s_buffer);
+  }
+  GHOST_TRACE(fprintf(stderr, "%d: will send %d\n", this_node, n_s_buffer));
+
+  fill_send_buffer(gc, data_parts, s_buffer, n_s_buffer);
+}
+
 static void prepare_ghost_cell(Cell *cell, int size)
 {
 #ifdef GHOSTS_HAVE_BONDS
@@ -282,10 +301,10 @@ void prepare_recv_buffer(GhostCommunication *gc, int data_parts)
   GHOST_TRACE(fprintf(stderr, "%d: will get %d\n", this_node, n_r_buffer));
 }
 
-void put_recv_buffer(GhostCommunication *gc, int data_parts)
+void put_recv_buffer(GhostCommunication *gc, int data_parts, char *buffer, int n_buffer)
 {
   /* put back data */
-  char *retrieve = r_buffer;
+  char *retrieve = buffer;
 
   std::vector<int>::const_iterator bond_retrieve = r_bondbuffer.begin();
 
@@ -382,10 +401,10 @@ void put_recv_buffer(GhostCommunication *gc, int data_parts)
     retrieve += sizeof(int);
   }
 
-  if (retrieve - r_buffer != n_r_buffer) {
+  if (retrieve - buffer != n_buffer) {
     fprintf(stderr, "%d: recv buffer size %d differs "
             "from what I read out (%ld)\n",
-            this_node, n_r_buffer, retrieve - r_buffer);
+            this_node, n_buffer, retrieve - buffer);
     errexit();
   }
   if (bond_retrieve != r_bondbuffer.end()) {
@@ -396,14 +415,14 @@ void put_recv_buffer(GhostCommunication *gc, int data_parts)
   r_bondbuffer.resize(0);
 }
 
-void add_forces_from_recv_buffer(GhostCommunication *gc)
+void add_forces_from_recv_buffer(GhostCommunication *gc, char *buffer, int n_buffer)
 {
   int pl, p, np;
   Particle *part, *pt;
   char *retrieve;
 
   /* put back data */
-  retrieve = r_buffer;
+  retrieve = buffer;
   for (pl = 0; pl < gc->n_part_lists; pl++) {
     np   = gc->part_lists[pl]->n;
     part = gc->part_lists[pl]->part;
@@ -413,10 +432,10 @@ void add_forces_from_recv_buffer(GhostCommunication *gc)
       retrieve +=  sizeof(ParticleForce);
     }
   }
-  if (retrieve - r_buffer != n_r_buffer) {
+  if (retrieve - buffer != n_buffer) {
     fprintf(stderr, "%d: recv buffer size %d differs "
             "from what I put in %ld\n",
-            this_node, n_r_buffer, retrieve - r_buffer);
+            this_node, n_buffer, retrieve - buffer);
     errexit();
   }
 }
@@ -530,12 +549,175 @@ static int is_recv_op(int comm_type, int node)
           (comm_type == GHOST_RDCE && node == this_node));
 }
 
+/** Mark the cells of a list range in \a mark, the cells are indexed by
+    their position in \ref cells. Returns whether any of them was
+    marked before. */
+static int mark_cells(std::vector<char> &mark, ParticleList **lists, int n, int set)
+{
+  int i, hit = 0;
+  for (i = 0; i < n; i++) {
+    int c = lists[i] - cells;
+    if (mark[c])
+      hit = 1;
+    if (set)
+      mark[c] = 1;
+  }
+  return hit;
+}
+
+int ghost_enable_async(GhostCommunicator *gc)
+{
+  int n;
+
+  if (gc->data_parts & GHOSTTRANS_PROPRTS)
+    return 0;
+  for (n = 0; n < gc->num; n++) {
+    GhostCommunication *gcn = &gc->comm[n];
+    int comm_type = gcn->type & GHOST_JOBMASK;
+    if (comm_type == GHOST_BCST || comm_type == GHOST_RDCE)
+      return 0;
+    for (int pl = 0; pl < gcn->n_part_lists; pl++)
+      if (gcn->part_lists[pl] < cells || gcn->part_lists[pl] >= cells + n_cells)
+        return 0;
+  }
+
+  /* cells that receives of the current stage write to */
+  std::vector<char> written(n_cells, 0);
+  for (n = 0; n < gc->num; n++) {
+    GhostCommunication *gcn = &gc->comm[n];
+    int comm_type = gcn->type & GHOST_JOBMASK;
+    int depends;
+
+    gcn->type &= ~GHOST_NEWSTAGE;
+    if (comm_type == GHOST_LOCL)
+      depends = mark_cells(written, gcn->part_lists, gcn->n_part_lists, 0);
+    else if (comm_type == GHOST_SEND)
+      depends = mark_cells(written, gcn->part_lists, gcn->n_part_lists, 0);
+    else
+      depends = 0;
+    if (depends || n == 0) {
+      gcn->type |= GHOST_NEWSTAGE;
+      std::fill(written.begin(), written.end(), 0);
+    }
+    if (comm_type == GHOST_RECV)
+      mark_cells(written, gcn->part_lists, gcn->n_part_lists, 1);
+  }
+
+  gc->requests = (MPI_Request*)Utils::realloc(gc->requests, gc->num*sizeof(MPI_Request));
+  for (n = 0; n < gc->num; n++)
+    gc->requests[n] = MPI_REQUEST_NULL;
+  gc->async = 1;
+
+  GHOST_TRACE(fprintf(stderr, "%d: ghost_enable_async %p\n", this_node, gc));
+  return 1;
+}
+
+/** Resize the buffer of a communication of a nonblocking communicator and
+    set up the persistent request for it, if the size changed. */
+static void ghost_prepare_request(GhostCommunicator *gc, int n)
+{
+  GhostCommunication *gcn = &gc->comm[n];
+  int comm_type = gcn->type & GHOST_JOBMASK;
+
+  gcn->n_buffer = calc_transmit_size(gcn, gc->data_parts);
+  if (gcn->n_buffer == gcn->request_size)
+    return;
+
+  if (gcn->request_size >= 0)
+    MPI_Request_free(&gc->requests[n]);
+  if (gcn->n_buffer > gcn->max_buffer) {
+    gcn->max_buffer = gcn->n_buffer;
+    gcn->buffer = (char*)Utils::realloc(gcn->buffer, gcn->max_buffer);
+  }
+  if (comm_type == GHOST_SEND)
+    MPI_Send_init(gcn->buffer, gcn->n_buffer, MPI_BYTE, gcn->node, REQ_GHOST_SEND, comm_cart, &gc->requests[n]);
+  else
+    MPI_Recv_init(gcn->buffer, gcn->n_buffer, MPI_BYTE, gcn->node, REQ_GHOST_SEND, comm_cart, &gc->requests[n]);
+  gcn->request_size = gcn->n_buffer;
+}
+
+/** Do the local transfers and start the sends and receives of the stage
+    beginning with communication \a first. Returns the first communication
+    of the next stage. */
+static int ghost_stage_start(GhostCommunicator *gc, int first)
+{
+  int n;
+
+  for (n = first; n < gc->num; n++) {
+    GhostCommunication *gcn = &gc->comm[n];
+    int comm_type = gcn->type & GHOST_JOBMASK;
+
+    if (n > first && (gcn->type & GHOST_NEWSTAGE))
+      break;
+    if (comm_type == GHOST_LOCL) {
+      cell_cell_transfer(gcn, gc->data_parts);
+      continue;
+    }
+    ghost_prepare_request(gc, n);
+    if (comm_type == GHOST_SEND)
+      fill_send_buffer(gcn, gc->data_parts, gcn->buffer, gcn->n_buffer);
+    GHOST_TRACE(fprintf(stderr, "%d: ghost_comm start %d, job %x with %d (%d bytes)\n", this_node, n, gcn->type, gcn->node, gcn->n_buffer));
+    MPI_Start(&gc->requests[n]);
+  }
+  return n;
+}
+
+/** Wait for the sends and receives of a stage and write back the received data. */
+static void ghost_stage_finish(GhostCommunicator *gc, int first, int end)
+{
+  int n;
+
+  /* communications without a started request are MPI_REQUEST_NULL or
+     inactive, both are ignored */
+  MPI_Waitall(end - first, gc->requests + first, MPI_STATUSES_IGNORE);
+
+  for (n = first; n < end; n++) {
+    GhostCommunication *gcn = &gc->comm[n];
+    if ((gcn->type & GHOST_JOBMASK) != GHOST_RECV)
+      continue;
+    if (gc->data_parts == GHOSTTRANS_FORCE)
+      add_forces_from_recv_buffer(gcn, gcn->buffer, gcn->n_buffer);
+    else
+      put_recv_buffer(gcn, gc->data_parts, gcn->buffer, gcn->n_buffer);
+  }
+}
+
+void ghost_communicator_start(GhostCommunicator *gc)
+{
+  if (!gc->async) {
+    ghost_communicator(gc);
+    return;
+  }
+  GHOST_TRACE(fprintf(stderr, "%d: ghost_comm_start %p, data_parts %d\n", this_node, gc, gc->data_parts));
+  gc->stage_first = 0;
+  gc->stage_end = ghost_stage_start(gc, 0);
+}
+
+void ghost_communicator_finish(GhostCommunicator *gc)
+{
+  if (!gc->async || gc->stage_first < 0)
+    return;
+  while (gc->stage_first < gc->num) {
+    ghost_stage_finish(gc, gc->stage_first, gc->stage_end);
+    gc->stage_first = gc->stage_end;
+    if (gc->stage_first < gc->num)
+      gc->stage_end = ghost_stage_start(gc, gc->stage_first);
+  }
+  gc->stage_first = gc->stage_end = -1;
+}
+
 void ghost_communicator(GhostCommunicator *gc)
 {
   MPI_Status status;
   int n, n2;
   int data_parts = gc->data_parts;
 
+  if (gc->async) {
+    ghost_communicator_start(gc);
+    ghost_communicator_finish(gc);
+    return;
+  }
+
   GHOST_TRACE(fprintf(stderr, "%d: ghost_comm %p, data_parts %d\n", this_node, gc, data_parts));
 
   for (n = 0; n < gc->num; n++) {
@@ -658,9 +840,9 @@ void ghost_communicator(GhostCommunicator *gc)
 	  /* forces have to be added, the rest overwritten. Exception is RDCE, where the addition
 	     is integrated into the communication. */
 	  if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-	    add_forces_from_recv_buffer(gcn);
+	    add_forces_from_recv_buffer(gcn, r_buffer, n_r_buffer);
 	  else
-	    put_recv_buffer(gcn, data_parts);
+	    put_recv_buffer(gcn, data_parts, r_buffer, n_r_buffer);
 	}
 	else {
 	  GHOST_TRACE(fprintf(stderr, "%d: ghost_comm delaying operation %d, recv from %d\n", this_node, n, node));
@@ -685,9 +867,9 @@ void ghost_communicator(GhostCommunicator *gc)
 #endif
 	      /* as above */
 	      if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-		add_forces_from_recv_buffer(gcn2);
+		add_forces_from_recv_buffer(gcn2, r_buffer, n_r_buffer);
 	      else
-		put_recv_buffer(gcn2, data_parts);
+		put_recv_buffer(gcn2, data_parts, r_buffer, n_r_buffer);
 	      break;
 	    }
 	  }
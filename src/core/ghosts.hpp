@@ -82,6 +82,17 @@ When sending, this precreated send buffer is used. In the scenario above, all no
 communication step, thereby reducing the latency a little bit. The pststore is similar and postpones the write back of received data until a
 send operation (with a precreated send buffer) is finished.
 
+<h2> Nonblocking communication </h2>
+Communicators without \ref GHOSTTRANS_PROPRTS and without collective operations can be switched to a nonblocking mode by
+\ref ghost_enable_async. The communications are then grouped into stages: a stage ends before the first communication that
+sends (or locally copies) a cell that a receive of the same stage writes to. For the domain decomposition, these are the
+forwarding steps between the x, y and z directions. All sends and receives of a stage are in flight at the same time, each
+with its own buffer and a persistent MPI request, so that neither the pairwise ordering of the blocking mode nor
+the prefetch/poststore flags are needed. The communication can also be split by \ref ghost_communicator_start and
+\ref ghost_communicator_finish, so that work which does not touch the receiving cells can be done while the first stage
+is on the wire. This is used by \ref force_calc to compute the pair forces between particles of the same node while the
+ghost positions are updated.
+
 The ghost communicators are created in the init routines of the cell systems, therefore have a look at \ref dd_topology_init or
 \ref nsq_topology_init for further details.
 */
@@ -109,6 +120,8 @@ The ghost communicators are created in the init routines of the cell systems, th
 #define GHOST_PREFETCH 16
 /// additional flag for poststoring
 #define GHOST_PSTSTORE 32
+/// additional flag for the nonblocking mode, the communication starts a new stage
+#define GHOST_NEWSTAGE 64
 /*@}*/
 
 
@@ -162,6 +175,15 @@ typedef struct {
   /** if \ref GhostCommunicator::data_parts has \ref GHOSTTRANS_POSSHFTD, then this is the shift vector.
       Normally this a integer multiple of the box length. The shift is done on the sender side */
   double shift[3];
+
+  /** buffer of this communication in the nonblocking mode. */
+  char *buffer;
+  /** size of the data in \ref GhostCommunication::buffer. */
+  int n_buffer;
+  /** allocated size of \ref GhostCommunication::buffer. */
+  int max_buffer;
+  /** size for which the persistent request was set up, or -1 if there is none. */
+  int request_size;
 } GhostCommunication;
 
 /** Properties for a ghost communication. A ghost communication is defined */
@@ -176,6 +198,14 @@ typedef struct {
   /** List of ghost communications. */
   GhostCommunication *comm;
 
+  /** flag for the nonblocking mode, see \ref ghost_enable_async. */
+  int async;
+  /** persistent MPI requests of the communications in the nonblocking mode. */
+  MPI_Request *requests;
+  /** first and end communication of the stage that is in flight
+      after \ref ghost_communicator_start, or -1 if none. */
+  int stage_first, stage_end;
+
 } GhostCommunicator;
 
 /*@}*/
@@ -193,9 +223,24 @@ void free_comm(GhostCommunicator *comm);
 /** Initialize ghosts. */
 void ghost_init();
 
+/** Switch a communicator to the nonblocking mode if possible, i.e. if it
+    does not transfer \ref GHOSTTRANS_PROPRTS and has no collective
+    operations. All nodes have to call this for the same communicator.
+    @return whether the communicator is nonblocking now. */
+int ghost_enable_async(GhostCommunicator *gc);
+
 /** do a ghost communication */
 void ghost_communicator(GhostCommunicator *gc);
 
+/** Start a ghost communication. For a nonblocking communicator, this does
+    the local transfers and posts the sends and receives of the first stage,
+    otherwise the whole communication is done. It has to be completed by
+    \ref ghost_communicator_finish before any other ghost communication. */
+void ghost_communicator_start(GhostCommunicator *gc);
+
+/** Complete a ghost communication started by \ref ghost_communicator_start. */
+void ghost_communicator_finish(GhostCommunicator *gc);
+
 /** Go through \ref ghost_cells and remove the ghost entries from \ref
     local_particles. Part of \ref dd_exchange_and_sort_particles.*/
 void invalidate_ghosts();
@@ -33,6 +33,7 @@
 #include "rattle.hpp"
 #include "imd.hpp"
 #include "ghmc.hpp"
+#include "random.hpp"
 #include "lb.hpp"
 #include "integrate_sd.hpp"
 
@@ -102,6 +103,14 @@ const Datafield fields[] = {
   {&sd_random_precision,     TYPE_DOUBLE, 1, "sd_precision_random",        4 },         /* 58 from integrate_sd.cpp */
   {&smaller_time_step,TYPE_DOUBLE,1, "smaller_time_step", 5 },         /* 59 from integrate.cpp */
   {configtemp,       TYPE_DOUBLE, 2, "configtemp",        1 },         /* 60 from integrate.cpp */
+  {&cell_sort_period,   TYPE_INT, 1, "cell_sort_period",  6 },         /* 61 from cells.cpp */
+  {&locality_drift,  TYPE_DOUBLE, 1, "locality_drift",    3 },         /* 62 from cells.cpp */
+  {&dd_balance_interval,TYPE_INT, 1, "balance_interval",  7 },         /* 63 from domain_decomposition.cpp */
+  {&load_imbalance,  TYPE_DOUBLE, 1, "load_imbalance",    4 },         /* 64 from domain_decomposition.cpp */
+  {&rng_counter_mask,   TYPE_INT, 1, "rng_counter_mask",  9 },         /* 65 from random.cpp */
+  {&rng_counter_seed,   TYPE_INT, 1, "rng_counter_seed",  9 },         /* 66 from random.cpp */
+  {&rng_counter_step,   TYPE_INT, 1, "rng_counter_step",  9 },         /* 67 from random.cpp */
+  {&kspace_interval,    TYPE_INT, 1, "kspace_interval",   2 },         /* 68 from integrate.cpp */
   { NULL, 0, 0, NULL, 0 }
 };
 
@@ -196,6 +196,22 @@ extern const Datafield fields[];
 #define FIELD_SMALLERTIMESTEP     59
 /** index of \ref configtemp in \ref #fields */
 #define FIELD_CONFIGTEMP          60
+/** index of \ref cell_sort_period in \ref #fields */
+#define FIELD_CELL_SORT_PERIOD    61
+/** index of \ref locality_drift in \ref #fields */
+#define FIELD_LOCALITY_DRIFT      62
+/** index of \ref dd_balance_interval in \ref #fields */
+#define FIELD_BALANCE_INTERVAL    63
+/** index of \ref load_imbalance in \ref #fields */
+#define FIELD_LOAD_IMBALANCE      64
+/** index of \ref rng_counter_mask in \ref #fields */
+#define FIELD_RNG_COUNTER_MASK    65
+/** index of \ref rng_counter_seed in \ref #fields */
+#define FIELD_RNG_COUNTER_SEED    66
+/** index of \ref rng_counter_step in \ref #fields */
+#define FIELD_RNG_COUNTER_STEP    67
+/** index of \ref kspace_interval in \ref #fields */
+#define FIELD_KSPACE_INTERVAL     68
 
 /*@}*/
 
@@ -66,6 +66,7 @@ double local_box_l[3] = {1, 1, 1};
 double min_local_box_l;
 double my_left[3]     = {0, 0, 0};
 double my_right[3]    = {1, 1, 1};
+double *node_bounds[3] = {NULL, NULL, NULL};
 
 /************************************************************/
 
@@ -91,7 +92,21 @@ int map_position_node_array(double pos[3])
   fold_position(f_pos, im);
 
   for (i = 0; i < 3; i++) {
-    im[i] = (int)floor(node_grid[i]*f_pos[i]*box_l_i[i]);
+    if (node_bounds[i]) {
+      /* bisection for the domain containing the position */
+      double frac = f_pos[i]*box_l_i[i];
+      int lo = 0, hi = node_grid[i];
+      while (hi - lo > 1) {
+        int mid = (lo + hi)/2;
+        if (frac < node_bounds[i][mid])
+          hi = mid;
+        else
+          lo = mid;
+      }
+      im[i] = lo;
+    }
+    else
+      im[i] = (int)floor(node_grid[i]*f_pos[i]*box_l_i[i]);
     if (im[i] < 0)
       im[i] = 0;
     else if (im[i] >= node_grid[i])
@@ -250,9 +265,16 @@ void grid_changed_box_l()
   GRID_TRACE(fprintf(stderr,"%d: node_pos %d %d %d\n", this_node, node_pos[0], node_pos[1], node_pos[2]));
   GRID_TRACE(fprintf(stderr,"%d: node_grid %d %d %d\n", this_node, node_grid[0], node_grid[1], node_grid[2]));
   for(i = 0; i < 3; i++) {
-    local_box_l[i] = box_l[i]/(double)node_grid[i]; 
-    my_left[i]   = node_pos[i]    *local_box_l[i];
-    my_right[i]  = (node_pos[i]+1)*local_box_l[i];    
+    if (node_bounds[i]) {
+      my_left[i]     = node_bounds[i][node_pos[i]]*box_l[i];
+      my_right[i]    = node_bounds[i][node_pos[i]+1]*box_l[i];
+      local_box_l[i] = my_right[i] - my_left[i];
+    }
+    else {
+      local_box_l[i] = box_l[i]/(double)node_grid[i]; 
+      my_left[i]   = node_pos[i]    *local_box_l[i];
+      my_right[i]  = (node_pos[i]+1)*local_box_l[i];    
+    }
     box_l_i[i] = 1/box_l[i];
   }
 
@@ -281,6 +303,12 @@ void grid_changed_n_nodes()
 
   calc_node_neighbors(this_node);
 
+  /* the domain boundaries do not fit the new grid */
+  for (int i = 0; i < 3; i++) {
+    free(node_bounds[i]);
+    node_bounds[i] = NULL;
+  }
+
 #ifdef GRID_DEBUG
   fprintf(stderr,"%d: node_pos=(%d,%d,%d)\n",this_node,node_pos[0],node_pos[1],node_pos[2]);
   fprintf(stderr,"%d: node_neighbors=(%d,%d,%d,%d,%d,%d)\n",this_node,
@@ -293,6 +321,24 @@ void grid_changed_n_nodes()
   grid_changed_box_l();
 }
 
+void grid_set_bounds(int dir, double *bounds)
+{
+  if (bounds) {
+    node_bounds[dir] = (double *)Utils::realloc(node_bounds[dir], (node_grid[dir] + 1)*sizeof(double));
+    memmove(node_bounds[dir], bounds, (node_grid[dir] + 1)*sizeof(double));
+  }
+  else {
+    free(node_bounds[dir]);
+    node_bounds[dir] = NULL;
+  }
+  grid_changed_box_l();
+}
+
+int grid_is_regular()
+{
+  return !node_bounds[0] && !node_bounds[1] && !node_bounds[2];
+}
+
 void calc_minimal_box_dimensions()
 {
   int i;
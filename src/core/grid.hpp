@@ -99,6 +99,13 @@ extern double min_local_box_l;
 extern double my_left[3];
 /** Right (top, back) corner of this nodes local box. */ 
 extern double my_right[3];
+/** Boundaries of the node domains in direction i as fractions of \ref
+    box_l, node_grid[i]+1 values from 0 to 1, or NULL if all nodes have
+    the same \ref local_box_l in this direction. Since the boundaries are
+    the same for all nodes in a plane of the node grid, the domains stay
+    boxes with the regular neighbor relations. Set by the load balancer,
+    see \ref dd_balance_step. */
+extern double *node_bounds[3];
 
 /*@}*/
 
@@ -153,6 +160,15 @@ void grid_changed_n_nodes();
 /** called from \ref mpi_bcast_parameter . */
 void grid_changed_box_l();
 
+/** Set the domain boundaries \ref node_bounds in direction \a dir to
+    \a bounds, or to the regular grid if \a bounds is NULL. Only the
+    geometry of this file is updated, the cell system has to be
+    reinitialized by the caller. */
+void grid_set_bounds(int dir, double *bounds);
+
+/** Whether all node domains have the same size. */
+int grid_is_regular();
+
 /** Calculates the smallest box and local box dimensions for periodic
  * directions.  This is needed to check if the interaction ranges are
  * compatible with the box dimensions and the node grid.  
@@ -34,6 +34,7 @@
 
 /** Primitive fieldtypes and their initializers */
 struct _Fieldtype fieldtype_double = { 0, NULL, NULL, sizeof(double), 0, 0, 0, 0, NULL };
+struct _Fieldtype fieldtype_float = { 0, NULL, NULL, sizeof(float), 0, 0, 0, 0, NULL };
 
 /** Creates a fieldtype describing the data layout 
  *  @param count   number of subtypes (Input)
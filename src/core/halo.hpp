@@ -53,11 +53,14 @@
  * <br>
  * <ul>
  * <li>REQ_HALO_SPREAD exchange of all halo regions</li>
+ * <li>REQ_HALO_PUSH_RIGHT, REQ_HALO_PUSH_LEFT exchange of the populations pushed into the halo by the LB</li>
  * <li>REQ_HALO_CHECK  additional check for consistency of halo regions</li>
  * </ul>
  */
 /*@{*/
 #define REQ_HALO_SPREAD 501 /**< Tag for halo update */
+#define REQ_HALO_PUSH_RIGHT 502 /**< Tag for LB push halo transfers to the right */
+#define REQ_HALO_PUSH_LEFT  503 /**< Tag for LB push halo transfers to the left */
 #define REQ_HALO_CHECK  599 /**< Tag for consistency check of halo regions */
 /*@}*/
 
@@ -81,6 +84,8 @@ struct _Fieldtype {
 /** Predefined fieldtypes */
 extern struct _Fieldtype fieldtype_double;
 #define FIELDTYPE_DOUBLE (&fieldtype_double)
+extern struct _Fieldtype fieldtype_float;
+#define FIELDTYPE_FLOAT (&fieldtype_float)
 
 /** Structure describing a Halo region */
 typedef struct {
@@ -58,7 +58,7 @@ int iccp3m_initialized = 0;
  * excluding forces other than the electrostatic ones */
 void init_forces_iccp3m();
 void calc_long_range_forces_iccp3m();
-inline void add_pair_iccp3m(PairList *pl, Particle *p1, Particle *p2);
+inline void add_pair_iccp3m(PairList *pl, int i, int j);
 void resize_verlet_list_iccp3m(PairList *pl);
 inline void init_local_particle_force_iccp3m(Particle *part);
 inline void init_ghost_force_iccp3m(Particle *part);
@@ -388,7 +388,7 @@ void build_verlet_lists_and_calc_verlet_ia_iccp3m()
 	    ONEPART_TRACE(if(p1[i].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d,%d %d,%d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,i,n,j,sqrt(dist2)));
 	    ONEPART_TRACE(if(p2[j].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d %d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,n,sqrt(dist2)));
 
-	    add_pair_iccp3m(pl, &p1[i], &p2[j]);
+	    add_pair_iccp3m(pl, i, j);
 	    /* calc non bonded interactions */ 
 	       add_non_bonded_pair_force_iccp3m(&(p1[i]), &(p2[j]), vec21, sqrt(dist2), dist2);
 	  }
@@ -408,24 +408,25 @@ void build_verlet_lists_and_calc_verlet_ia_iccp3m()
 
 void calculate_verlet_ia_iccp3m()
 {
-  int c, np, n, i;
+  int c, np, n, i, *pairs;
   Cell *cell;
-  Particle *p1, *p2, **pairs;
+  Particle *part1, *part2, *p1, *p2;
   double dist2, vec21[3];
 
   /* Loop local cells */
   for (c = 0; c < local_cells.n; c++) {
     cell = local_cells.cell[c];
-    p1   = cell->part;
+    part1 = cell->part;
     np  = cell->n;
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      part2 = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
       /* verlet list loop */
       for(i=0; i<2*np; i+=2) {
-	      p1 = pairs[i];                    /* pointer to particle 1 */
-	      p2 = pairs[i+1];                  /* pointer to particle 2 */
+	      p1 = &part1[pairs[i]];            /* pointer to particle 1 */
+	      p2 = &part2[pairs[i+1]];          /* pointer to particle 2 */
 	      dist2 = distance2vec(p1->r.p, p2->r.p, vec21); 
 	      add_non_bonded_pair_force_iccp3m(p1, p2, vec21, sqrt(dist2), dist2);
       }
@@ -612,20 +613,20 @@ void calc_long_range_forces_iccp3m()
 
 /** Add a particle pair to a verlet pair list.
     Checks verlet pair list size and reallocates memory if necessary.
- *  \param p1 Pointer to paricle one.
- *  \param p2 Pointer to paricle two.
+ *  \param i  Index of paricle one in the local cell.
+ *  \param j  Index of paricle two in the neighbor cell.
  *  \param pl Pointer to the verlet pair list.
  */
-inline void add_pair_iccp3m(PairList *pl, Particle *p1, Particle *p2)
+inline void add_pair_iccp3m(PairList *pl, int i, int j)
 {
   /* check size of verlet List */
   if(pl->n+1 >= pl->max) {
     pl->max += LIST_INCREMENT;
-    pl->pair = (Particle **)Utils::realloc(pl->pair, 2*pl->max*sizeof(Particle *));
+    pl->pair = (int *)Utils::realloc(pl->pair, 2*pl->max*sizeof(int));
   }
   /* add pair */
-  pl->pair[(2*pl->n)  ] = p1;
-  pl->pair[(2*pl->n)+1] = p2;
+  pl->pair[(2*pl->n)  ] = i;
+  pl->pair[(2*pl->n)+1] = j;
   /* increase number of pairs */
   pl->n++;
 }
@@ -637,7 +638,7 @@ void resize_verlet_list_iccp3m(PairList *pl)
   if( diff > 2*LIST_INCREMENT ) {
     diff = (diff/LIST_INCREMENT)-1;
     pl->max -= diff*LIST_INCREMENT;
-    pl->pair = (Particle **)Utils::realloc(pl->pair, 2*pl->max*sizeof(Particle *));
+    pl->pair = (int *)Utils::realloc(pl->pair, 2*pl->max*sizeof(int));
   }
 }
 
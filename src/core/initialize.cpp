@@ -65,6 +65,7 @@
 #include "external_potential.hpp"
 #include "cuda_init.hpp"
 #include "cuda_interface.hpp"
+#include "particle_soa.hpp"
 
 /** whether the thermostat has to be reinitialized before integration */
 static int reinit_thermo = 1;
@@ -215,6 +216,12 @@ void on_integration_start()
   /* Ensemble preparation: NVT or NPT */
   integrate_ensemble_init();
 
+  /* Equal domains unless balancing is possible */
+  dd_balance_reset(dd_balance_interval <= 0);
+
+  /* Choose the short ranged force loop */
+  soa_on_integration_start();
+
   /* Update particle and observable information for routines in statistics.cpp */
   invalidate_obs();
   freePartCfg();
@@ -292,6 +299,9 @@ void on_coulomb_change()
   EVENT_TRACE(fprintf(stderr, "%d: on_coulomb_change\n", this_node));
   invalidate_obs();
 
+  /* mesh based methods have to be set up on equal domains */
+  dd_balance_reset(0);
+
   recalc_coulomb_prefactor();
 
 #ifdef ELECTROSTATICS
@@ -622,8 +632,9 @@ void on_parameter_change(int field)
     break;
 #ifdef LB
   case FIELD_LATTICE_SWITCH:
-    /* LB needs ghost velocities */
+    /* LB needs ghost velocities and equal domains */
     on_ghost_flags_change();
+    dd_balance_reset(0);
     break;
 #endif
   case FIELD_DPD_IGNORE_FIXED_PARTICLES:
@@ -636,6 +647,8 @@ void on_lb_params_change(int field) {
   EVENT_TRACE(fprintf(stderr, "%d: on_lb_params_change\n", this_node));
 
   if (field == LBPAR_AGRID) {
+    /* the fluid lattice is set up on equal domains */
+    dd_balance_reset(1);
     lb_init();
   }
   if (field == LBPAR_DENSITY) {
@@ -45,6 +45,7 @@
 #include "ghosts.hpp"
 #include "pressure.hpp"
 #include "p3m.hpp"
+#include "iccp3m.hpp"
 #include "maggs.hpp"
 #include "thermostat.hpp"
 #include "initialize.hpp"
@@ -93,6 +94,8 @@ int    recalc_forces    = 1;
 double verlet_reuse     = 0.0;
 
 double smaller_time_step          = -1.0;
+int    kspace_interval            = 1;
+int    kspace_step                = 0;
 #ifdef MULTI_TIMESTEP
 int    current_time_step_is_small = 0;
 int    mts_index                  = 0;
@@ -151,6 +154,32 @@ void integrator_sanity_checks()
       msg <<"time_step not set";
       runtimeError(msg);
   }
+
+  if (kspace_interval > 1) {
+#ifdef P3M
+    if (coulomb.method != COULOMB_P3M || iccp3m_initialized) {
+      ostringstream msg;
+      msg <<"kspace_interval > 1 only works with plain P3M electrostatics";
+      runtimeError(msg);
+    }
+#ifdef NPT
+    if (integ_switch == INTEG_METHOD_NPT_ISO) {
+      ostringstream msg;
+      msg <<"kspace_interval > 1 does not work with the NPT integrator";
+      runtimeError(msg);
+    }
+#endif
+    if (smaller_time_step > 0.) {
+      ostringstream msg;
+      msg <<"kspace_interval > 1 cannot be combined with smaller_time_step";
+      runtimeError(msg);
+    }
+#else
+    ostringstream msg;
+    msg <<"kspace_interval > 1 requires P3M";
+    runtimeError(msg);
+#endif
+  }
 }
 
 #ifdef NPT
@@ -296,6 +325,8 @@ void integrate_vv(int n_steps, int reuse_forces)
       if (warnings) fprintf (stderr, "Warning: Recalculating forces, so the LB coupling forces are not included in the particle force the first time step. This only matters if it happens frequently during sampling.\n");
 #endif
 
+    /* restart the k-space schedule with a full k-space impulse */
+    kspace_step = 0;
     force_calc();
 
     if(integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -441,6 +472,8 @@ void integrate_vv(int n_steps, int reuse_forces)
     transfer_momentum_gpu = 1;
 #endif
 
+    if (++kspace_step >= kspace_interval)
+      kspace_step = 0;
     force_calc();
     
 // IMMERSED_BOUNDARY
@@ -556,11 +589,15 @@ void integrate_vv(int n_steps, int reuse_forces)
     #ifdef COLLISION_DETECTION
       handle_collisions();
     #endif
+
+    /* adjust the domains to the measured load */
+    dd_balance_step();
   }
 
   /* verlet list statistics */
   if(n_verlet_updates>0) verlet_reuse = n_steps/(double) n_verlet_updates;
   else verlet_reuse = 0;
+  cells_locality_statistics();
 
 #ifdef NPT
   if(integ_switch == INTEG_METHOD_NPT_ISO) {
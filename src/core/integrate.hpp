@@ -64,6 +64,16 @@ extern double virial_store[3];
 #endif
 #endif
 
+/** Number of time steps between two calculations of the k-space part
+    of the P3M electrostatics (impulse multiple time stepping, r-RESPA).
+    The k-space forces are calculated only in every kspace_interval-th
+    step and then applied with weight kspace_interval, all other forces
+    in every step. 1 (the default) calculates them in every step. */
+extern int kspace_interval;
+/** Number of steps since the k-space forces were last calculated,
+    the k-space forces are due if this is 0. */
+extern int kspace_step;
+
 /** Store configurational temperature terms (numerator/denominator) */
 extern double configtemp[2];
 
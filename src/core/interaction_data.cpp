@@ -139,6 +139,7 @@ void force_and_energy_tables_init() {
 void initialize_ia_params(IA_parameters *params) {
  
   params->particlesInteract = 0;
+  params->potentials = 0;
   params->max_cut = max_cut_global;
 
 #ifdef LENNARD_JONES
@@ -556,12 +557,15 @@ static void recalc_maximal_cutoff_nonbonded()
   for (i = 0; i < n_particle_types; i++)
     for (j = i; j < n_particle_types; j++) {
       double max_cut_current = 0;
+      int potentials = 0;
 
       IA_parameters *data = get_ia_param(i, j);
 
 #ifdef LENNARD_JONES
       if(max_cut_current < (data->LJ_cut+data->LJ_offset))
 	max_cut_current = (data->LJ_cut+data->LJ_offset);
+      if (data->LJ_cut+data->LJ_offset > 0)
+	potentials |= NONBONDED_LJ;
 #endif
 
 #ifdef INTER_DPD
@@ -570,67 +574,93 @@ static void recalc_maximal_cutoff_nonbonded()
 	  data->dpd_r_cut : data->dpd_tr_cut;
 	if (max_cut_current <  max_cut_tmp)
 	  max_cut_current = max_cut_tmp;
+	if (max_cut_tmp > 0)
+	  potentials |= NONBONDED_INTER_DPD;
       }
 #endif
 
 #ifdef LENNARD_JONES_GENERIC
       if (max_cut_current < (data->LJGEN_cut+data->LJGEN_offset))
 	max_cut_current = (data->LJGEN_cut+data->LJGEN_offset);
+      if (data->LJGEN_cut+data->LJGEN_offset > 0)
+	potentials |= NONBONDED_LJGEN;
 #endif
 
 #ifdef LJ_ANGLE
       if (max_cut_current < (data->LJANGLE_cut))
 	max_cut_current = (data->LJANGLE_cut);
+      if (data->LJANGLE_cut > 0)
+	potentials |= NONBONDED_LJ_ANGLE;
 #endif
 
 #ifdef SMOOTH_STEP
       if (max_cut_current < data->SmSt_cut)
 	max_cut_current = data->SmSt_cut;
+      if (data->SmSt_cut > 0)
+	potentials |= NONBONDED_SMOOTH_STEP;
 #endif
 
 #ifdef HERTZIAN
       if (max_cut_current < data->Hertzian_sig)
 	max_cut_current = data->Hertzian_sig;
+      if (data->Hertzian_sig > 0)
+	potentials |= NONBONDED_HERTZIAN;
 #endif
 
 #ifdef GAUSSIAN
       if (max_cut_current < data->Gaussian_cut)
 	max_cut_current = data->Gaussian_cut;
+      if (data->Gaussian_cut > 0)
+	potentials |= NONBONDED_GAUSSIAN;
 #endif
 
 #ifdef BMHTF_NACL
       if (max_cut_current < data->BMHTF_cut)
 	max_cut_current = data->BMHTF_cut;
+      if (data->BMHTF_cut > 0)
+	potentials |= NONBONDED_BMHTF;
 #endif
 
 #ifdef MORSE
       if (max_cut_current < data->MORSE_cut)
 	max_cut_current = data->MORSE_cut;
+      if (data->MORSE_cut > 0)
+	potentials |= NONBONDED_MORSE;
 #endif
 
 #ifdef BUCKINGHAM
       if (max_cut_current < data->BUCK_cut)
 	max_cut_current = data->BUCK_cut;
+      if (data->BUCK_cut > 0)
+	potentials |= NONBONDED_BUCKINGHAM;
 #endif
 
 #ifdef SOFT_SPHERE
       if (max_cut_current < data->soft_cut)
 	max_cut_current = data->soft_cut;
+      if (data->soft_cut + data->soft_offset > 0)
+	potentials |= NONBONDED_SOFT_SPHERE;
 #endif
 
 #ifdef AFFINITY
       if (max_cut_current < data->affinity_cut)
 	max_cut_current = data->affinity_cut;
+      if (data->affinity_cut > 0)
+	potentials |= NONBONDED_AFFINITY;
 #endif
         
 #ifdef MEMBRANE_COLLISION
       if (max_cut_current < data->membrane_cut)
     max_cut_current = data->membrane_cut;
+      if (data->membrane_cut + data->membrane_offset > 0)
+	potentials |= NONBONDED_MEMBRANE_COLLISION;
 #endif
 
 #ifdef HAT
       if (max_cut_current < data->HAT_r)
 	max_cut_current = data->HAT_r;
+      if (data->HAT_r > 0)
+	potentials |= NONBONDED_HAT;
 #endif
 
 #ifdef LJCOS
@@ -638,6 +668,8 @@ static void recalc_maximal_cutoff_nonbonded()
 	double max_cut_tmp = data->LJCOS_cut + data->LJCOS_offset;
 	if (max_cut_current < max_cut_tmp)
 	  max_cut_current = max_cut_tmp;
+	if (max_cut_tmp > 0)
+	  potentials |= NONBONDED_LJCOS;
       }
 #endif
 
@@ -646,6 +678,8 @@ static void recalc_maximal_cutoff_nonbonded()
 	double max_cut_tmp = data->LJCOS2_cut + data->LJCOS2_offset;
 	if (max_cut_current < max_cut_tmp)
 	  max_cut_current = max_cut_tmp;
+	if (max_cut_tmp > 0)
+	  potentials |= NONBONDED_LJCOS2;
       }
 #endif
 
@@ -654,22 +688,35 @@ static void recalc_maximal_cutoff_nonbonded()
   double max_cut_tmp = data->COS2_cut + data->COS2_offset;
   if (max_cut_current < max_cut_tmp)
     max_cut_current = max_cut_tmp;
+  if (max_cut_tmp > 0)
+    potentials |= NONBONDED_COS2;
       }
 #endif
 
 #ifdef GAY_BERNE
       if (max_cut_current < data->GB_cut)
 	max_cut_current = data->GB_cut;
+      if (data->GB_cut > 0)
+	potentials |= NONBONDED_GAY_BERNE;
 #endif
 
 #ifdef TABULATED
       if (max_cut_current < data->TAB_maxval)
 	max_cut_current = data->TAB_maxval;
+      if (data->TAB_maxval > 0)
+	potentials |= NONBONDED_TABULATED;
 #endif
 	 
 #ifdef TUNABLE_SLIP
       if (max_cut_current < data->TUNABLE_SLIP_r_cut)
 	max_cut_current = data->TUNABLE_SLIP_r_cut;
+      if (data->TUNABLE_SLIP_r_cut > 0)
+	potentials |= NONBONDED_TUNABLE_SLIP;
+#endif
+
+#ifdef INTER_RF
+      if (data->rf_on)
+	potentials |= NONBONDED_INTER_RF;
 #endif
 
 #ifdef CATALYTIC_REACTIONS
@@ -682,6 +729,9 @@ static void recalc_maximal_cutoff_nonbonded()
 	if (max_cut_current < data->mol_cut_cutoff)
 	  max_cut_current = data->mol_cut_cutoff;
 	max_cut_current += 2.0* max_cut_bonded;
+	/* the mol_cut criterion replaces the cutoffs of the potentials,
+	   so all of them have to be evaluated */
+	potentials |= NONBONDED_PAIR_FORCES;
       }
 #endif
 
@@ -691,6 +741,9 @@ static void recalc_maximal_cutoff_nonbonded()
 	 short-ranged one (that writes to the nonbonded energy) */
       data_sym->particlesInteract =
 	data->particlesInteract = (max_cut_current > 0.0);
+
+      data_sym->potentials =
+	data->potentials = potentials;
       
       /* take into account any electrostatics */
       if (max_cut_global > max_cut_current)
@@ -217,6 +217,38 @@ enum ConstraintApplied{
 };
 /*@}*/
 
+/** \name Flags for the short ranged nonbonded interactions
+    Bit flags used in \ref IA_parameters::potentials to mark which
+    interactions are active for a pair of particle types.
+*/
+/************************************************************/
+/*@{*/
+#define NONBONDED_LJ                 (1 << 0)
+#define NONBONDED_LJGEN              (1 << 1)
+#define NONBONDED_SMOOTH_STEP        (1 << 2)
+#define NONBONDED_HERTZIAN           (1 << 3)
+#define NONBONDED_GAUSSIAN           (1 << 4)
+#define NONBONDED_BMHTF              (1 << 5)
+#define NONBONDED_BUCKINGHAM         (1 << 6)
+#define NONBONDED_MORSE              (1 << 7)
+#define NONBONDED_SOFT_SPHERE        (1 << 8)
+#define NONBONDED_MEMBRANE_COLLISION (1 << 9)
+#define NONBONDED_HAT                (1 << 10)
+#define NONBONDED_LJCOS              (1 << 11)
+#define NONBONDED_LJCOS2             (1 << 12)
+#define NONBONDED_TABULATED          (1 << 13)
+#define NONBONDED_GAY_BERNE          (1 << 14)
+#define NONBONDED_INTER_RF           (1 << 15)
+/** all potentials evaluated by \ref calc_non_bonded_pair_force_parts */
+#define NONBONDED_PAIR_FORCES        ((1 << 16) - 1)
+/* interactions that are handled outside of the pair potentials */
+#define NONBONDED_LJ_ANGLE           (1 << 16)
+#define NONBONDED_AFFINITY           (1 << 17)
+#define NONBONDED_INTER_DPD          (1 << 18)
+#define NONBONDED_COS2               (1 << 19)
+#define NONBONDED_TUNABLE_SLIP       (1 << 20)
+/*@}*/
+
 /* Data Types */
 /************************************************************/
 
@@ -232,6 +264,11 @@ typedef struct {
    e.g. electrostatics. */
   int particlesInteract;
 
+  /** bit mask of the NONBONDED_* flags of all short ranged
+      interactions that are active for this pair of particle types,
+      i.e. have a positive cutoff. Set by \ref recalc_maximal_cutoff. */
+  int potentials;
+
   /** maximal cutoff for this pair of particle types. This contains
       contributions from the short-ranged interactions, plus any
       cutoffs from global interactions like electrostatics.
@@ -40,6 +40,15 @@
 int n_lb_boundaries = 0;
 LB_Boundary *lb_boundaries = NULL;
 
+#ifdef LB_BOUNDARIES
+int n_lb_boundary_links = 0;
+LB_BoundaryLink *lb_boundary_links = NULL;
+LB_FluidRun *lb_fluid_runs = NULL;
+int *lb_fluid_run_offset = NULL;
+
+static void lb_init_boundary_links();
+#endif
+
 void lbboundary_mindist_position(double pos[3], double* mindist, double distvec[3], int* no) {
   double vec[3] = {1e100, 1e100, 1e100};
   double dist=1e100;
@@ -312,8 +321,10 @@ void lb_init_boundaries() {
       lbfields[n].boundary = 0;
     }
     
-    if (lblattice.halo_grid_volume==0)
+    if (lblattice.halo_grid_volume==0) {
+      lb_init_boundary_links();
       return;
+    }
     
     for (z=0; z<lblattice.grid[2]+2; z++) {
       for (y=0; y<lblattice.grid[1]+2; y++) {
@@ -511,6 +522,8 @@ void lb_init_boundaries() {
 	}
 	printf("end new\n");
 	*/
+
+    lb_init_boundary_links();
 #endif
   }
 }
@@ -552,69 +565,97 @@ int lbboundary_get_force(int no, double* f) {
 
 #ifdef LB_BOUNDARIES
 
+/** Builds \ref lb_boundary_links and \ref lb_fluid_runs from the
+ *  boundary flags of the local lattice. A link is stored for every
+ *  boundary node (including the halo) and every velocity that points
+ *  to it from a node in the interior of the lattice. */
+static void lb_init_boundary_links() {
+  int x, y, z, i, n_runs = 0, max_links = 0, max_runs = 0;
+  int n_rows = lblattice.grid[1]*lblattice.grid[2];
+
+  n_lb_boundary_links = 0;
+  lb_fluid_run_offset = (int*) Utils::realloc(lb_fluid_run_offset, (n_rows + 1)*sizeof(int));
+  lb_fluid_run_offset[0] = 0;
+  if (lblattice.halo_grid_volume == 0)
+    return;
+
+  for (z=0; z<lblattice.grid[2]+2; z++) {
+    for (y=0; y<lblattice.grid[1]+2; y++) {
+      /* runs of fluid nodes in the interior rows */
+      if (z > 0 && z <= lblattice.grid[2] && y > 0 && y <= lblattice.grid[1]) {
+        for (x=1; x<=lblattice.grid[0]; x++) {
+          index_t k = get_linear_index(x,y,z,lblattice.halo_grid);
+          if (lbfields[k].boundary)
+            continue;
+          if (x > 1 && !lbfields[k-1].boundary) {
+            lb_fluid_runs[n_runs-1].length++;
+            continue;
+          }
+          if (n_runs == max_runs) {
+            max_runs += lblattice.grid[1]*lblattice.grid[2];
+            lb_fluid_runs = (LB_FluidRun*) Utils::realloc(lb_fluid_runs, max_runs*sizeof(LB_FluidRun));
+          }
+          lb_fluid_runs[n_runs].index = k;
+          lb_fluid_runs[n_runs].length = 1;
+          n_runs++;
+        }
+        lb_fluid_run_offset[(y-1) + (z-1)*lblattice.grid[1] + 1] = n_runs;
+      }
+
+      /* links of the boundary nodes */
+      for (x=0; x<lblattice.grid[0]+2; x++) {
+        index_t k = get_linear_index(x,y,z,lblattice.halo_grid);
+        if (!lbfields[k].boundary)
+          continue;
+        for (i=0; i<19; i++) {
+          int nx = x - (int)lbmodel.c[i][0];
+          int ny = y - (int)lbmodel.c[i][1];
+          int nz = z - (int)lbmodel.c[i][2];
+          if (nx <= 0 || nx > lblattice.grid[0] ||
+              ny <= 0 || ny > lblattice.grid[1] ||
+              nz <= 0 || nz > lblattice.grid[2])
+            continue;
+          if (n_lb_boundary_links == max_links) {
+            max_links += 19*(lblattice.grid[0]+2)*(lblattice.grid[1]+2);
+            lb_boundary_links = (LB_BoundaryLink*) Utils::realloc(lb_boundary_links, max_links*sizeof(LB_BoundaryLink));
+          }
+          LB_BoundaryLink *link = &lb_boundary_links[n_lb_boundary_links++];
+          link->index = k;
+          link->neighbor = get_linear_index(nx,ny,nz,lblattice.halo_grid);
+          link->dir = i;
+          link->boundary = lbfields[link->neighbor].boundary ? -1 : lbfields[k].boundary-1;
+        }
+      }
+    }
+  }
+}
+
 void lb_bounce_back() {
 
 #ifdef D3Q19
 #ifndef PULL
-  int k,i,l;
-  int yperiod = lblattice.halo_grid[0];
-  int zperiod = lblattice.halo_grid[0]*lblattice.halo_grid[1];
-  int next[19];
-  int x,y,z;
+  int n,i,l;
   double population_shift;
-  double modes[19];
-  next[0]  =   0;                       // ( 0, 0, 0) =
-  next[1]  =   1;                       // ( 1, 0, 0) +
-  next[2]  = - 1;                       // (-1, 0, 0)
-  next[3]  =   yperiod;                 // ( 0, 1, 0) +
-  next[4]  = - yperiod;                 // ( 0,-1, 0)
-  next[5]  =   zperiod;                 // ( 0, 0, 1) +
-  next[6]  = - zperiod;                 // ( 0, 0,-1)
-  next[7]  =   (1+yperiod);             // ( 1, 1, 0) +
-  next[8]  = - (1+yperiod);             // (-1,-1, 0)
-  next[9]  =   (1-yperiod);             // ( 1,-1, 0) 
-  next[10] = - (1-yperiod);             // (-1, 1, 0) +
-  next[11] =   (1+zperiod);             // ( 1, 0, 1) +
-  next[12] = - (1+zperiod);             // (-1, 0,-1)
-  next[13] =   (1-zperiod);             // ( 1, 0,-1)
-  next[14] = - (1-zperiod);             // (-1, 0, 1) +
-  next[15] =   (yperiod+zperiod);       // ( 0, 1, 1) +
-  next[16] = - (yperiod+zperiod);       // ( 0,-1,-1)
-  next[17] =   (yperiod-zperiod);       // ( 0, 1,-1)
-  next[18] = - (yperiod-zperiod);       // ( 0,-1, 1) +
   int reverse[] = { 0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17 };
 
-  /* bottom-up sweep */
-//  for (k=lblattice.halo_offset;k<lblattice.halo_grid_volume;k++) {
-  for (z=0; z<lblattice.grid[2]+2; z++) {
-    for (y=0; y<lblattice.grid[1]+2; y++) {
-	    for (x=0; x<lblattice.grid[0]+2; x++) {	    
-        k= get_linear_index(x,y,z,lblattice.halo_grid);
-    
-        if (lbfields[k].boundary) {
-          lb_calc_modes(k, modes);
-    
-          for (i=0; i<19; i++) {
-            population_shift=0;
-            for (l=0; l<3; l++) {
-              population_shift-=lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.rho[0]*2*lbmodel.c[i][l]*lbmodel.w[i]*lb_boundaries[lbfields[k].boundary-1].velocity[l]/lbmodel.c_sound_sq;
-            }
-            if ( x-lbmodel.c[i][0] > 0 && x -lbmodel.c[i][0] < lblattice.grid[0]+1 && 
-                 y-lbmodel.c[i][1] > 0 && y -lbmodel.c[i][1] < lblattice.grid[1]+1 &&
-                 z-lbmodel.c[i][2] > 0 && z -lbmodel.c[i][2] < lblattice.grid[2]+1) { 
-              if ( !lbfields[k-next[i]].boundary ) {
-                for (l=0; l<3; l++) {
-                  lb_boundaries[lbfields[k].boundary-1].force[l]+=(2*lbfluid[1][i][k]+population_shift)*lbmodel.c[i][l];
-                }
-                lbfluid[1][reverse[i]][k-next[i]]   = lbfluid[1][i][k]+ population_shift;
-              }
-              else { 
-                lbfluid[1][reverse[i]][k-next[i]]   = lbfluid[1][i][k] = 0.0;
-	      }
-            }
-          }
-        }
+  for (n=0; n<n_lb_boundary_links; n++) {
+    LB_BoundaryLink *link = &lb_boundary_links[n];
+    index_t k = link->index;
+    i = link->dir;
+
+    if (link->boundary >= 0) {
+      LB_Boundary *boundary = &lb_boundaries[link->boundary];
+      population_shift=0;
+      for (l=0; l<3; l++) {
+        population_shift-=lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.agrid*lbpar.rho[0]*2*lbmodel.c[i][l]*lbmodel.w[i]*boundary->velocity[l]/lbmodel.c_sound_sq;
       }
+      for (l=0; l<3; l++) {
+        boundary->force[l]+=(2*lbfluid[1][i][k]+population_shift)*lbmodel.c[i][l];
+      }
+      lbfluid[1][reverse[i]][link->neighbor] = lbfluid[1][i][k]+ population_shift;
+    }
+    else {
+      lbfluid[1][reverse[i]][link->neighbor] = lbfluid[1][i][k] = 0.0;
     }
   }
 #else
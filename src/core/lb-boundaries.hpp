@@ -39,6 +39,7 @@
 
 #include "utils.hpp"
 #include "constraint.hpp"
+#include "lattice.hpp"
 
 #if defined (LB_BOUNDARIES) || defined (LB_BOUNDARIES_GPU)
 
@@ -109,10 +110,45 @@ int lbboundary_get_force(int no, double* f);
 #endif // (LB_BOUNDARIES) || (LB_BOUNDARIES_GPU)
 
 #ifdef LB_BOUNDARIES
+/** Link between a boundary node and a neighboring node in the interior
+ *  of the local lattice. */
+typedef struct {
+  /** linear index of the boundary node */
+  index_t index;
+  /** linear index of the neighbor */
+  index_t neighbor;
+  /** velocity that points from the neighbor to the boundary node */
+  int dir;
+  /** number of the boundary, or -1 if the neighbor is a boundary node too */
+  int boundary;
+} LB_BoundaryLink;
+
+/** Run of consecutive fluid nodes in x direction. */
+typedef struct {
+  /** linear index of the first node */
+  index_t index;
+  /** number of nodes */
+  int length;
+} LB_FluidRun;
+
+/** Number of links in \ref lb_boundary_links */
+extern int n_lb_boundary_links;
+/** All links from the local boundary nodes into the interior of the
+ *  local lattice, built by \ref lb_init_boundaries. */
+extern LB_BoundaryLink *lb_boundary_links;
+/** Runs of fluid nodes in the interior of the local lattice, ordered
+ *  by z, y and x. */
+extern LB_FluidRun *lb_fluid_runs;
+/** The runs of the lattice row (y, z) are lb_fluid_runs[k] with
+ *  lb_fluid_run_offset[r] <= k < lb_fluid_run_offset[r+1], where
+ *  r = (y-1) + (z-1)*lblattice.grid[1]. */
+extern int *lb_fluid_run_offset;
+
 /** Bounce back boundary conditions.
  * The populations that have propagated into a boundary node
  * are bounced back to the node they came from. This results
- * in no slip boundary conditions.
+ * in no slip boundary conditions. Only the links in \ref
+ * lb_boundary_links are visited.
  *
  * [cf. Ladd and Verberg, J. Stat. Phys. 104(5/6):1191-1251, 2001]
  */
@@ -100,7 +100,16 @@ LB_Model lbmodel = { 19, d3q19_lattice, d3q19_coefficients, d3q19_w, NULL, 1./3.
 Lattice lblattice;
 
 /** Pointer to the velocity populations of the fluid nodes */
-double **lbfluid[2] = { NULL, NULL };
+lb_float **lbfluid[2] = { NULL, NULL };
+
+/** MPI datatype and halo fieldtype matching \ref lb_float */
+#ifdef LB_SINGLE_PRECISION
+#define MPI_LB_FLOAT MPI_FLOAT
+#define FIELDTYPE_LB_FLOAT FIELDTYPE_FLOAT
+#else
+#define MPI_LB_FLOAT MPI_DOUBLE
+#define FIELDTYPE_LB_FLOAT FIELDTYPE_DOUBLE
+#endif
 
 /** Pointer to the hydrodynamic fields of the fluid nodes */
 LB_FluidNode *lbfields = NULL;
@@ -1464,309 +1473,151 @@ int lb_lbnode_set_extforce(int* ind, double* f) {
 
 #ifdef LB
 /********************** The Main LB Part *************************************/
-/* Halo communication for push scheme */
-static void halo_push_communication() {
-    index_t index;
-    int x, y, z, count;
-    int rnode, snode;
-    double *buffer=NULL, *sbuf=NULL, *rbuf=NULL;
-    MPI_Status status;
-
-    int yperiod = lblattice.halo_grid[0];
-    int zperiod = lblattice.halo_grid[0]*lblattice.halo_grid[1];
-
-    /***************
-     * X direction *
-     ***************/
-    count = 5*lblattice.halo_grid[1]*lblattice.halo_grid[2];
-    sbuf = (double*) Utils::malloc(count*sizeof(double));
-    rbuf = (double*) Utils::malloc(count*sizeof(double));
-
-    /* send to right, recv from left i = 1, 7, 9, 11, 13 */
-    snode = node_neighbors[1];
-    rnode = node_neighbors[0];
-
-    buffer = sbuf;
-    index = get_linear_index(lblattice.grid[0]+1,0,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (y=0; y<lblattice.halo_grid[1]; y++) {
-
-            buffer[0] = lbfluid[1][1][index];
-            buffer[1] = lbfluid[1][7][index];
-            buffer[2] = lbfluid[1][9][index];
-            buffer[3] = lbfluid[1][11][index];
-            buffer[4] = lbfluid[1][13][index];
-            buffer += 5;
-
-            index += yperiod;
-        }
-    }
-
-    if (node_grid[0] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
-    } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
-    }
-
-    buffer = rbuf;
-    index = get_linear_index(1,0,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (y=0; y<lblattice.halo_grid[1]; y++) {
-
-            lbfluid[1][1][index] = buffer[0];
-            lbfluid[1][7][index] = buffer[1];
-            lbfluid[1][9][index] = buffer[2];
-            lbfluid[1][11][index] = buffer[3];
-            lbfluid[1][13][index] = buffer[4];
-            buffer += 5;
-
-            index += yperiod;
-        }
-    }
-
-    /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-    snode = node_neighbors[0];
-    rnode = node_neighbors[1];
-
-    buffer = sbuf;
-    index = get_linear_index(0,0,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (y=0; y<lblattice.halo_grid[1]; y++) {
-
-            buffer[0] = lbfluid[1][2][index];
-            buffer[1] = lbfluid[1][8][index];
-            buffer[2] = lbfluid[1][10][index];
-            buffer[3] = lbfluid[1][12][index];
-            buffer[4] = lbfluid[1][14][index];
-            buffer += 5;
-
-            index += yperiod;
-        }
-    }
-
-    if (node_grid[0] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
-    } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
-    }
-
-    buffer = rbuf;
-    index = get_linear_index(lblattice.grid[0],0,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (y=0; y<lblattice.halo_grid[1]; y++) {
-
-            lbfluid[1][2][index] = buffer[0];
-            lbfluid[1][8][index] = buffer[1];
-            lbfluid[1][10][index] = buffer[2];
-            lbfluid[1][12][index] = buffer[3];
-            lbfluid[1][14][index] = buffer[4];
-            buffer += 5;
-
-            index += yperiod;
-        }
-    }
-
-    /***************
-     * Y direction *
-     ***************/
-    count = 5*lblattice.halo_grid[0]*lblattice.halo_grid[2];
-    sbuf = (double*) Utils::realloc(sbuf, count*sizeof(double));
-    rbuf = (double*) Utils::realloc(rbuf, count*sizeof(double));
-
-    /* send to right, recv from left i = 3, 7, 10, 15, 17 */
-    snode = node_neighbors[3];
-    rnode = node_neighbors[2];
-
-    buffer = sbuf;
-    index = get_linear_index(0,lblattice.grid[1]+1,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            buffer[0] = lbfluid[1][3][index];
-            buffer[1] = lbfluid[1][7][index];
-            buffer[2] = lbfluid[1][10][index];
-            buffer[3] = lbfluid[1][15][index];
-            buffer[4] = lbfluid[1][17][index];
-            buffer += 5;
-
-            ++index;
-        }
-        index += zperiod - lblattice.halo_grid[0];
-    }
-
-    if (node_grid[1] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
-    } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
-    }
-
-    buffer = rbuf;
-    index = get_linear_index(0,1,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            lbfluid[1][3][index] = buffer[0];
-            lbfluid[1][7][index] = buffer[1];
-            lbfluid[1][10][index] = buffer[2];
-            lbfluid[1][15][index] = buffer[3];
-            lbfluid[1][17][index] = buffer[4];
-            buffer += 5;
-
-            ++index;
-        }
-        index += zperiod - lblattice.halo_grid[0];
-    }
-
-    /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-    snode = node_neighbors[2];
-    rnode = node_neighbors[3];
-
-    buffer = sbuf;
-    index = get_linear_index(0,0,0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
+/** \name Halo communication for push scheme
+ *  The populations that were pushed into the halo are sent to the
+ *  neighbors, first in x, then in y and then in z direction, so that the
+ *  populations pushed into edges and corners of the halo reach the
+ *  right node in two or three steps. Every direction has two transfers,
+ *  to the right (side 0) and to the left (side 1), which use packed
+ *  buffers and persistent requests that are set up in \ref
+ *  lb_prepare_communication. */
+/*@{*/
 
-            buffer[0] = lbfluid[1][4][index];
-            buffer[1] = lbfluid[1][8][index];
-            buffer[2] = lbfluid[1][9][index];
-            buffer[3] = lbfluid[1][16][index];
-            buffer[4] = lbfluid[1][18][index];
-            buffer += 5;
+/** Populations that leave the lattice to the right and to the left in
+ *  every direction, indexed by 2*dir+side. */
+static const int halo_push_pops[6][5] = {
+    { 1, 7, 9, 11, 13 }, { 2, 8, 10, 12, 14 },
+    { 3, 7, 10, 15, 17 }, { 4, 8, 9, 16, 18 },
+    { 5, 11, 14, 15, 18 }, { 6, 12, 13, 16, 17 }
+};
 
-            ++index;
+/** Send and receive buffers of the transfers */
+static lb_float *halo_push_sbuf[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+static lb_float *halo_push_rbuf[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+/** Persistent requests of the transfers of each direction, the sends
+ *  followed by the receives. */
+static MPI_Request halo_push_req[3][4];
+/** Whether halo_push_req[dir] has been set up */
+static int halo_push_req_init[3] = { 0, 0, 0 };
+
+/** Copies the populations of transfer t between a plane of the
+ *  lattice and the buffer buf.
+ *  @param t     transfer (2*dir+side)
+ *  @param plane coordinate of the plane in direction dir
+ *  @param buf   the buffer
+ *  @param pack  copy from the lattice into the buffer if 1, else back
+ */
+static void halo_push_copy(int t, int plane, lb_float *buf, int pack) {
+    int dir = t/2;
+    /* the other two directions, the slower one first */
+    int da = (dir == 2) ? 1 : 2;
+    int db = (dir == 0) ? 1 : 0;
+    index_t stride[3];
+    const int *pop = halo_push_pops[t];
+    int a, b, i;
+
+    stride[0] = 1;
+    stride[1] = lblattice.halo_grid[0];
+    stride[2] = lblattice.halo_grid[0]*lblattice.halo_grid[1];
+
+    for (a = 0; a < lblattice.halo_grid[da]; a++) {
+        index_t index = plane*stride[dir] + a*stride[da];
+        for (b = 0; b < lblattice.halo_grid[db]; b++, index += stride[db]) {
+            if (pack)
+                for (i = 0; i < 5; i++)
+                    buf[i] = lbfluid[1][pop[i]][index];
+            else
+                for (i = 0; i < 5; i++)
+                    lbfluid[1][pop[i]][index] = buf[i];
+            buf += 5;
         }
-        index += zperiod - lblattice.halo_grid[0];
     }
+}
 
-    if (node_grid[1] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
-    } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
-    }
+/** Number of values in the buffers of direction dir. */
+static int halo_push_count(int dir) {
+    return 5*lblattice.halo_grid[(dir == 2) ? 1 : 2]*lblattice.halo_grid[(dir == 0) ? 1 : 0];
+}
 
-    buffer = rbuf;
-    index = get_linear_index(0,lblattice.grid[1],0,lblattice.halo_grid);
-    for (z=0; z<lblattice.halo_grid[2]; z++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
+/** Sets up the buffers and persistent requests of the halo exchange. */
+static void halo_push_prepare() {
+    for (int dir = 0; dir < 3; dir++) {
+        int count = halo_push_count(dir);
 
-            lbfluid[1][4][index] = buffer[0];
-            lbfluid[1][8][index] = buffer[1];
-            lbfluid[1][9][index] = buffer[2];
-            lbfluid[1][16][index] = buffer[3];
-            lbfluid[1][18][index] = buffer[4];
-            buffer += 5;
+        if (halo_push_req_init[dir])
+            for (int r = 0; r < 4; r++)
+                MPI_Request_free(&halo_push_req[dir][r]);
+        halo_push_req_init[dir] = 0;
 
-            ++index;
+        for (int side = 0; side < 2; side++) {
+            int t = 2*dir + side;
+            halo_push_sbuf[t] = (lb_float*) Utils::realloc(halo_push_sbuf[t], count*sizeof(lb_float));
+            halo_push_rbuf[t] = (lb_float*) Utils::realloc(halo_push_rbuf[t], count*sizeof(lb_float));
         }
-        index += zperiod - lblattice.halo_grid[0];
-    }
-
-    /***************
-     * Z direction *
-     ***************/
-    count = 5*lblattice.halo_grid[0]*lblattice.halo_grid[1];
-    sbuf = (double*) Utils::realloc(sbuf, count*sizeof(double));
-    rbuf = (double*) Utils::realloc(rbuf, count*sizeof(double));
-
-    /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-    snode = node_neighbors[5];
-    rnode = node_neighbors[4];
-
-    buffer = sbuf;
-    index = get_linear_index(0,0,lblattice.grid[2]+1,lblattice.halo_grid);
-    for (y=0; y<lblattice.halo_grid[1]; y++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            buffer[0] = lbfluid[1][5][index];
-            buffer[1] = lbfluid[1][11][index];
-            buffer[2] = lbfluid[1][14][index];
-            buffer[3] = lbfluid[1][15][index];
-            buffer[4] = lbfluid[1][18][index];
-            buffer += 5;
 
-            ++index;
+        if (node_grid[dir] > 1) {
+            /* send to right, recv from left */
+            MPI_Send_init(halo_push_sbuf[2*dir], count, MPI_LB_FLOAT, node_neighbors[2*dir+1],
+                          REQ_HALO_PUSH_RIGHT, comm_cart, &halo_push_req[dir][0]);
+            /* send to left, recv from right */
+            MPI_Send_init(halo_push_sbuf[2*dir+1], count, MPI_LB_FLOAT, node_neighbors[2*dir],
+                          REQ_HALO_PUSH_LEFT, comm_cart, &halo_push_req[dir][1]);
+            MPI_Recv_init(halo_push_rbuf[2*dir], count, MPI_LB_FLOAT, node_neighbors[2*dir],
+                          REQ_HALO_PUSH_RIGHT, comm_cart, &halo_push_req[dir][2]);
+            MPI_Recv_init(halo_push_rbuf[2*dir+1], count, MPI_LB_FLOAT, node_neighbors[2*dir+1],
+                          REQ_HALO_PUSH_LEFT, comm_cart, &halo_push_req[dir][3]);
+            halo_push_req_init[dir] = 1;
         }
     }
+}
 
-    if (node_grid[2] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
-    } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
+/** Frees the buffers and persistent requests of the halo exchange. */
+static void halo_push_release() {
+    for (int dir = 0; dir < 3; dir++) {
+        if (halo_push_req_init[dir])
+            for (int r = 0; r < 4; r++)
+                MPI_Request_free(&halo_push_req[dir][r]);
+        halo_push_req_init[dir] = 0;
     }
-
-    buffer = rbuf;
-    index = get_linear_index(0,0,1,lblattice.halo_grid);
-    for (y=0; y<lblattice.halo_grid[1]; y++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            lbfluid[1][5][index] = buffer[0];
-            lbfluid[1][11][index] = buffer[1];
-            lbfluid[1][14][index] = buffer[2];
-            lbfluid[1][15][index] = buffer[3];
-            lbfluid[1][18][index] = buffer[4];
-            buffer += 5;
-
-            ++index;
-        }
+    for (int t = 0; t < 6; t++) {
+        free(halo_push_sbuf[t]);
+        free(halo_push_rbuf[t]);
+        halo_push_sbuf[t] = halo_push_rbuf[t] = NULL;
     }
+}
 
-    /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-    snode = node_neighbors[4];
-    rnode = node_neighbors[5];
-
-    buffer = sbuf;
-    index = get_linear_index(0,0,0,lblattice.halo_grid);
-    for (y=0; y<lblattice.halo_grid[1]; y++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            buffer[0] = lbfluid[1][6][index];
-            buffer[1] = lbfluid[1][12][index];
-            buffer[2] = lbfluid[1][13][index];
-            buffer[3] = lbfluid[1][16][index];
-            buffer[4] = lbfluid[1][17][index];
-            buffer += 5;
+/** Packs the populations in the halo planes of direction dir and
+ *  starts their transfer. The halo planes may only be changed again
+ *  after \ref halo_push_finish. */
+static void halo_push_start(int dir) {
+    halo_push_copy(2*dir, lblattice.grid[dir]+1, halo_push_sbuf[2*dir], 1);
+    halo_push_copy(2*dir+1, 0, halo_push_sbuf[2*dir+1], 1);
 
-            ++index;
-        }
-    }
+    if (node_grid[dir] > 1)
+        MPI_Startall(4, halo_push_req[dir]);
+}
 
-    if (node_grid[2] > 1) {
-        MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-                     rbuf, count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-                     comm_cart, &status);
+/** Waits for the transfers of direction dir and stores the received
+ *  populations in the first and last plane of the lattice. */
+static void halo_push_finish(int dir) {
+    if (node_grid[dir] > 1) {
+        MPI_Waitall(4, halo_push_req[dir], MPI_STATUSES_IGNORE);
+        halo_push_copy(2*dir, 1, halo_push_rbuf[2*dir], 0);
+        halo_push_copy(2*dir+1, lblattice.grid[dir], halo_push_rbuf[2*dir+1], 0);
     } else {
-        memmove(rbuf,sbuf,count*sizeof(double));
+        halo_push_copy(2*dir, 1, halo_push_sbuf[2*dir], 0);
+        halo_push_copy(2*dir+1, lblattice.grid[dir], halo_push_sbuf[2*dir+1], 0);
     }
+}
 
-    buffer = rbuf;
-    index = get_linear_index(0,0,lblattice.grid[2],lblattice.halo_grid);
-    for (y=0; y<lblattice.halo_grid[1]; y++) {
-        for (x=0; x<lblattice.halo_grid[0]; x++) {
-
-            lbfluid[1][6][index] = buffer[0];
-            lbfluid[1][12][index] = buffer[1];
-            lbfluid[1][13][index] = buffer[2];
-            lbfluid[1][16][index] = buffer[3];
-            lbfluid[1][17][index] = buffer[4];
-            buffer += 5;
-
-            ++index;
-        }
+/** Exchanges the halo regions without overlap with computation. */
+static void halo_push_communication() {
+    for (int dir = 0; dir < 3; dir++) {
+        halo_push_start(dir);
+        halo_push_finish(dir);
     }
-
-    free(rbuf);
-    free(sbuf);
 }
+/*@}*/
 
 /***********************************************************************/
 
@@ -1830,8 +1681,8 @@ int lb_sanity_checks() {
 
 /** (Pre-)allocate memory for data structures */
 void lb_pre_init() {
-    lbfluid[0]    = (double**) Utils::malloc(2*lbmodel.n_veloc*sizeof(double *));
-    lbfluid[0][0] = (double*) Utils::malloc(2*lblattice.halo_grid_volume*lbmodel.n_veloc*sizeof(double));
+    lbfluid[0]    = (lb_float**) Utils::malloc(2*lbmodel.n_veloc*sizeof(lb_float *));
+    lbfluid[0][0] = (lb_float*) Utils::malloc(2*lblattice.halo_grid_volume*lbmodel.n_veloc*sizeof(lb_float));
 }
 
 
@@ -1841,10 +1692,10 @@ static void lb_realloc_fluid() {
 
     LB_TRACE(printf("reallocating fluid\n"));
 
-    lbfluid[0]    = (double**) Utils::realloc(*lbfluid,2*lbmodel.n_veloc*sizeof(double *));
-    lbfluid[0][0] = (double*) Utils::realloc(**lbfluid,2*lblattice.halo_grid_volume*lbmodel.n_veloc*sizeof(double));
-    lbfluid[1]    = (double **)lbfluid[0] + lbmodel.n_veloc;
-    lbfluid[1][0] = (double *)lbfluid[0][0] + lblattice.halo_grid_volume*lbmodel.n_veloc;
+    lbfluid[0]    = (lb_float**) Utils::realloc(*lbfluid,2*lbmodel.n_veloc*sizeof(lb_float *));
+    lbfluid[0][0] = (lb_float*) Utils::realloc(**lbfluid,2*lblattice.halo_grid_volume*lbmodel.n_veloc*sizeof(lb_float));
+    lbfluid[1]    = (lb_float **)lbfluid[0] + lbmodel.n_veloc;
+    lbfluid[1][0] = (lb_float *)lbfluid[0][0] + lblattice.halo_grid_volume*lbmodel.n_veloc;
 
     for (i=0; i<lbmodel.n_veloc; ++i) {
         lbfluid[0][i] = lbfluid[0][0] + i*lblattice.halo_grid_volume;
@@ -1869,7 +1720,7 @@ static void lb_prepare_communication() {
      * datatypes */
 
     /* prepare the communication for a single velocity */
-    prepare_halo_communication(&comm, &lblattice, FIELDTYPE_DOUBLE, MPI_DOUBLE);
+    prepare_halo_communication(&comm, &lblattice, FIELDTYPE_LB_FLOAT, MPI_LB_FLOAT);
 
     update_halo_comm.num = comm.num;
     update_halo_comm.halo_info = (HaloInfo*) Utils::realloc(update_halo_comm.halo_info,comm.num*sizeof(HaloInfo));
@@ -1891,18 +1742,21 @@ static void lb_prepare_communication() {
 
         MPI_Aint lower;
         MPI_Aint extent;
-        MPI_Type_get_extent(MPI_DOUBLE, &lower, &extent);
+        MPI_Type_get_extent(MPI_LB_FLOAT, &lower, &extent);
         MPI_Type_create_hvector(lbmodel.n_veloc, 1,
                                 lblattice.halo_grid_volume*extent,
                                 comm.halo_info[i].datatype, &hinfo->datatype);
         MPI_Type_commit(&hinfo->datatype);
 
         halo_create_field_hvector(lbmodel.n_veloc,1,
-                                  lblattice.halo_grid_volume*sizeof(double),
+                                  lblattice.halo_grid_volume*sizeof(lb_float),
                                   comm.halo_info[i].fieldtype,&hinfo->fieldtype);
     }
 
     release_halo_communication(&comm);
+
+    /* the halo exchange of the push scheme */
+    halo_push_prepare();
 }
 
 
@@ -2079,6 +1933,7 @@ void lb_release_fluid() {
 void lb_release() {
     lb_release_fluid();
     release_halo_communication(&update_halo_comm);
+    halo_push_release();
 }
 
 /***********************************************************************/
@@ -2393,8 +2248,56 @@ inline void lb_relax_modes(index_t index, double *mode)
 }
 
 
+/** Fluctuations from the counter based generator. The counter is the
+    global index of the lattice site, so that the noise does not depend
+    on the node grid. */
+inline void lb_thermalize_modes_counter(index_t index, double *mode) {
+    double rnd[16];
+    int ind[3], site;
+
+    ind[0] = index % lblattice.halo_grid[0];
+    ind[1] = (index / lblattice.halo_grid[0]) % lblattice.halo_grid[1];
+    ind[2] = index / (lblattice.halo_grid[0]*lblattice.halo_grid[1]);
+    for (int d = 0; d < 3; d++)
+        ind[d] += lblattice.local_index_offset[d] - lblattice.halo_size;
+    site = ind[0] + lblattice.global_grid[0]*(ind[1] + lblattice.global_grid[1]*ind[2]);
+
+    for (int k = 0; k < 4; k++) {
+#if defined (GAUSSRANDOM)
+        counter_random_gaussian(RNG_STREAM_LB_FLUID, site, 0, k, rnd + 4*k);
+#elif defined (GAUSSRANDOMCUT)
+        counter_random_gaussian_cut(RNG_STREAM_LB_FLUID, site, 0, k, rnd + 4*k);
+#else
+        counter_random_uniform(RNG_STREAM_LB_FLUID, site, 0, k, rnd + 4*k);
+        for (int i = 4*k; i < 4*k + 4; i++)
+            rnd[i] -= 0.5;
+#endif
+    }
+
+#if defined (GAUSSRANDOM) || defined (GAUSSRANDOMCUT)
+    double rootrho = sqrt(fabs(mode[0]+lbpar.rho[0]*lbpar.agrid*lbpar.agrid*lbpar.agrid));
+#else
+    double rootrho = sqrt(fabs(12.0*(mode[0]+lbpar.rho[0]*lbpar.agrid*lbpar.agrid*lbpar.agrid)));
+#endif
+
+    /* stress modes */
+    for (int m = 4; m < 10; m++)
+        mode[m] += rootrho*lb_phi[m]*rnd[m-4];
+
+#ifndef OLD_FLUCT
+    /* ghost modes */
+    for (int m = 10; m < 19; m++)
+        mode[m] += rootrho*lb_phi[m]*rnd[m-4];
+#endif // !OLD_FLUCT
+}
+
 inline void lb_thermalize_modes(index_t index, double *mode) {
     double fluct[6];
+
+    if (rng_counter_mask & THERMO_LB) {
+        lb_thermalize_modes_counter(index, mode);
+        return;
+    }
 #ifdef GAUSSRANDOM
     double rootrho_gauss = sqrt(fabs(mode[0]+lbpar.rho[0]*lbpar.agrid*lbpar.agrid*lbpar.agrid));
 
@@ -2675,11 +2578,347 @@ inline void lb_calc_n_from_modes_push(index_t index, double *m) {
 }
 
 
+#ifndef OLD_FLUCT
+/** Maximal number of lattice sites in x direction that are collided
+ *  and streamed together by \ref lb_collide_stream_row. */
+#define LB_ROW 32
+/** Number of lattice rows in y direction that \ref lb_collide_stream
+ *  updates for all z planes before the next rows, so that the
+ *  populations pushed into the neighboring planes are still cached. */
+#define LB_BLOCK_Y 8
+
+/** Stores the populations of a row of sites. */
+inline void lb_push_row(lb_float *dst, const double *n_new, int n) {
+    for (int x = 0; x < n; x++)
+        dst[x] = n_new[x];
+}
+
+/** Collisions and streaming (push scheme) of n <= \ref LB_ROW
+ *  consecutive fluid sites in x direction, starting at index.  Does
+ *  the same as \ref lb_calc_modes, \ref lb_relax_modes, \ref
+ *  lb_thermalize_modes, \ref lb_apply_forces and \ref
+ *  lb_calc_n_from_modes_push for every site, but with the sites in the
+ *  innermost loops, which the compiler can vectorize. */
+static void lb_collide_stream_row(index_t index, int n) {
+    int yperiod = lblattice.halo_grid[0];
+    int zperiod = lblattice.halo_grid[0]*lblattice.halo_grid[1];
+    double rho0 = lbpar.rho[0]*lbpar.agrid*lbpar.agrid*lbpar.agrid;
+    double *w = lbmodel.w;
+    lb_float *src[19];
+    double m[19][LB_ROW], f[3][LB_ROW], n_new[LB_ROW];
+    int has_force[LB_ROW];
+    int x, i;
+
+    /* forces on the sites */
+    for (x = 0; x < n; x++) {
+        LB_FluidNode *node = &lbfields[index + x];
+#ifdef EXTERNAL_FORCES
+        has_force[x] = 1;
+#else // EXTERNAL_FORCES
+        has_force[x] = node->has_force;
+#endif // EXTERNAL_FORCES
+        for (i = 0; i < 3; i++)
+            f[i][x] = has_force[x] ? node->force[i] : 0.0;
+    }
+
+    /* calculate modes locally */
+    for (i = 0; i < 19; i++)
+        src[i] = lbfluid[0][i] + index;
+    for (x = 0; x < n; x++) {
+        double n0, n1p, n1m, n2p, n2m, n3p, n3m, n4p, n4m, n5p, n5m, n6p, n6m, n7p, n7m, n8p, n8m, n9p, n9m;
+
+        n0  = src[0][x];
+        n1p = src[1][x] + src[2][x];
+        n1m = src[1][x] - src[2][x];
+        n2p = src[3][x] + src[4][x];
+        n2m = src[3][x] - src[4][x];
+        n3p = src[5][x] + src[6][x];
+        n3m = src[5][x] - src[6][x];
+        n4p = src[7][x] + src[8][x];
+        n4m = src[7][x] - src[8][x];
+        n5p = src[9][x] + src[10][x];
+        n5m = src[9][x] - src[10][x];
+        n6p = src[11][x] + src[12][x];
+        n6m = src[11][x] - src[12][x];
+        n7p = src[13][x] + src[14][x];
+        n7m = src[13][x] - src[14][x];
+        n8p = src[15][x] + src[16][x];
+        n8m = src[15][x] - src[16][x];
+        n9p = src[17][x] + src[18][x];
+        n9m = src[17][x] - src[18][x];
+
+        /* mass mode */
+        m[0][x] = n0 + n1p + n2p + n3p + n4p + n5p + n6p + n7p + n8p + n9p;
+
+        /* momentum modes */
+        m[1][x] = n1m + n4m + n5m + n6m + n7m;
+        m[2][x] = n2m + n4m - n5m + n8m + n9m;
+        m[3][x] = n3m + n6m - n7m + n8m - n9m;
+
+        /* stress modes */
+        m[4][x] = -n0 + n4p + n5p + n6p + n7p + n8p + n9p;
+        m[5][x] = n1p - n2p + n6p + n7p - n8p - n9p;
+        m[6][x] = n1p + n2p - n6p - n7p - n8p - n9p - 2.*(n3p - n4p - n5p);
+        m[7][x] = n4p - n5p;
+        m[8][x] = n6p - n7p;
+        m[9][x] = n8p - n9p;
+
+        /* kinetic modes */
+        m[10][x] = -2.*n1m + n4m + n5m + n6m + n7m;
+        m[11][x] = -2.*n2m + n4m - n5m + n8m + n9m;
+        m[12][x] = -2.*n3m + n6m - n7m + n8m - n9m;
+        m[13][x] = n4m + n5m - n6m - n7m;
+        m[14][x] = n4m - n5m - n8m - n9m;
+        m[15][x] = n6m - n7m - n8m + n9m;
+        m[16][x] = n0 + n4p + n5p + n6p + n7p + n8p + n9p
+            - 2.*(n1p + n2p + n3p);
+        m[17][x] = - n1p + n2p + n6p + n7p - n8p - n9p;
+        m[18][x] = - n1p - n2p -n6p - n7p - n8p - n9p
+            + 2.*(n3p + n4p + n5p);
+    }
+
+    /* deterministic collisions, the momentum density includes one
+     * half-step of the force action, see lb_relax_modes */
+    for (x = 0; x < n; x++) {
+        double rho, j0, j1, j2, jj, pi_eq[6];
+
+        rho = m[0][x] + rho0;
+        j0 = m[1][x] + 0.5 * f[0][x];
+        j1 = m[2][x] + 0.5 * f[1][x];
+        j2 = m[3][x] + 0.5 * f[2][x];
+        jj = j0*j0 + j1*j1 + j2*j2;
+
+        /* equilibrium part of the stress modes */
+        pi_eq[0] = jj / rho;
+        pi_eq[1] = (j0*j0 - j1*j1) / rho;
+        pi_eq[2] = (jj - 3.0 * (j2*j2)) / rho;
+        pi_eq[3] = j0 * j1 / rho;
+        pi_eq[4] = j0 * j2 / rho;
+        pi_eq[5] = j1 * j2 / rho;
+
+        /* relax the stress modes */
+        m[4][x] = pi_eq[0] + gamma_bulk * (m[4][x] - pi_eq[0]);
+        m[5][x] = pi_eq[1] + gamma_shear * (m[5][x] - pi_eq[1]);
+        m[6][x] = pi_eq[2] + gamma_shear * (m[6][x] - pi_eq[2]);
+        m[7][x] = pi_eq[3] + gamma_shear * (m[7][x] - pi_eq[3]);
+        m[8][x] = pi_eq[4] + gamma_shear * (m[8][x] - pi_eq[4]);
+        m[9][x] = pi_eq[5] + gamma_shear * (m[9][x] - pi_eq[5]);
+
+        /* relax the ghost modes (project them out) */
+        m[10][x] = gamma_odd*m[10][x];
+        m[11][x] = gamma_odd*m[11][x];
+        m[12][x] = gamma_odd*m[12][x];
+        m[13][x] = gamma_odd*m[13][x];
+        m[14][x] = gamma_odd*m[14][x];
+        m[15][x] = gamma_odd*m[15][x];
+        m[16][x] = gamma_even*m[16][x];
+        m[17][x] = gamma_even*m[17][x];
+        m[18][x] = gamma_even*m[18][x];
+    }
+
+    /* fluctuating hydrodynamics, site by site in the order of the
+     * random numbers */
+    if (fluct) {
+        double mode[19];
+        for (x = 0; x < n; x++) {
+            for (i = 0; i < 19; i++)
+                mode[i] = m[i][x];
+            lb_thermalize_modes(index + x, mode);
+            for (i = 0; i < 19; i++)
+                m[i][x] = mode[i];
+        }
+    }
+
+    /* apply forces, see lb_apply_forces. Sites without force have
+     * f = 0 and are not changed. */
+    for (x = 0; x < n; x++) {
+        double rho, u[3], uf, C[6];
+
+        rho = m[0][x] + rho0;
+        u[0] = (m[1][x] + 0.5 * f[0][x])/rho;
+        u[1] = (m[2][x] + 0.5 * f[1][x])/rho;
+        u[2] = (m[3][x] + 0.5 * f[2][x])/rho;
+        uf = u[0]*f[0][x] + u[1]*f[1][x] + u[2]*f[2][x];
+
+        C[0] = (1.+gamma_bulk)*u[0]*f[0][x] + 1./3.*(gamma_bulk-gamma_shear)*uf;
+        C[2] = (1.+gamma_bulk)*u[1]*f[1][x] + 1./3.*(gamma_bulk-gamma_shear)*uf;
+        C[5] = (1.+gamma_bulk)*u[2]*f[2][x] + 1./3.*(gamma_bulk-gamma_shear)*uf;
+        C[1] = 1./2. * (1.+gamma_shear)*(u[0]*f[1][x]+u[1]*f[0][x]);
+        C[3] = 1./2. * (1.+gamma_shear)*(u[0]*f[2][x]+u[2]*f[0][x]);
+        C[4] = 1./2. * (1.+gamma_shear)*(u[1]*f[2][x]+u[2]*f[1][x]);
+
+        /* update momentum modes */
+        m[1][x] += f[0][x];
+        m[2][x] += f[1][x];
+        m[3][x] += f[2][x];
+
+        /* update stress modes */
+        m[4][x] += C[0] + C[2] + C[5];
+        m[5][x] += C[0] - C[2];
+        m[6][x] += C[0] + C[2] - 2. * C[5];
+        m[7][x] += C[1];
+        m[8][x] += C[3];
+        m[9][x] += C[4];
+    }
+
+    /* reset force */
+    for (x = 0; x < n; x++) {
+        if (!has_force[x])
+            continue;
+#ifdef EXTERNAL_FORCES
+        // unit conversion: force density
+        lbfields[index + x].force[0] = lbpar.ext_force[0]*pow(lbpar.agrid,2)*lbpar.tau*lbpar.tau;
+        lbfields[index + x].force[1] = lbpar.ext_force[1]*pow(lbpar.agrid,2)*lbpar.tau*lbpar.tau;
+        lbfields[index + x].force[2] = lbpar.ext_force[2]*pow(lbpar.agrid,2)*lbpar.tau*lbpar.tau;
+#else // EXTERNAL_FORCES
+        lbfields[index + x].force[0] = 0.0;
+        lbfields[index + x].force[1] = 0.0;
+        lbfields[index + x].force[2] = 0.0;
+        lbfields[index + x].has_force = 0;
+#endif // EXTERNAL_FORCES
+    }
+
+    /* normalization factors enter in the back transformation */
+    for (i = 0; i < 19; i++) {
+        double norm = 1./d3q19_modebase[19][i];
+        for (x = 0; x < n; x++)
+            m[i][x] = norm*m[i][x];
+    }
+
+    /* transform back to populations and streaming, the weights enter
+     * in the back transformation */
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[4][x] + m[16][x])*w[0];
+    lb_push_row(lbfluid[1][0] + index, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[1][x] + m[5][x] + m[6][x] - m[17][x] - m[18][x] - 2.*(m[10][x] + m[16][x]))*w[1];
+    lb_push_row(lbfluid[1][1] + index + 1, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[1][x] + m[5][x] + m[6][x] - m[17][x] - m[18][x] + 2.*(m[10][x] - m[16][x]))*w[2];
+    lb_push_row(lbfluid[1][2] + index - 1, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[2][x] - m[5][x] + m[6][x] + m[17][x] - m[18][x] - 2.*(m[11][x] + m[16][x]))*w[3];
+    lb_push_row(lbfluid[1][3] + index + yperiod, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[2][x] - m[5][x] + m[6][x] + m[17][x] - m[18][x] + 2.*(m[11][x] - m[16][x]))*w[4];
+    lb_push_row(lbfluid[1][4] + index - yperiod, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[3][x] - 2.*(m[6][x] + m[12][x] + m[16][x] - m[18][x]))*w[5];
+    lb_push_row(lbfluid[1][5] + index + zperiod, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[3][x] - 2.*(m[6][x] - m[12][x] + m[16][x] - m[18][x]))*w[6];
+    lb_push_row(lbfluid[1][6] + index - zperiod, n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[1][x] + m[2][x] + m[4][x] + 2.*m[6][x] + m[7][x] + m[10][x] + m[11][x] + m[13][x] + m[14][x] + m[16][x] + 2.*m[18][x])*w[7];
+    lb_push_row(lbfluid[1][7] + index + (1 + yperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[1][x] - m[2][x] + m[4][x] + 2.*m[6][x] + m[7][x] - m[10][x] - m[11][x] - m[13][x] - m[14][x] + m[16][x] + 2.*m[18][x])*w[8];
+    lb_push_row(lbfluid[1][8] + index - (1 + yperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[1][x] - m[2][x] + m[4][x] + 2.*m[6][x] - m[7][x] + m[10][x] - m[11][x] + m[13][x] - m[14][x] + m[16][x] + 2.*m[18][x])*w[9];
+    lb_push_row(lbfluid[1][9] + index + (1 - yperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[1][x] + m[2][x] + m[4][x] + 2.*m[6][x] - m[7][x] - m[10][x] + m[11][x] - m[13][x] + m[14][x] + m[16][x] + 2.*m[18][x])*w[10];
+    lb_push_row(lbfluid[1][10] + index - (1 - yperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[1][x] + m[3][x] + m[4][x] + m[5][x] - m[6][x] + m[8][x] + m[10][x] + m[12][x] - m[13][x] + m[15][x] + m[16][x] + m[17][x] - m[18][x])*w[11];
+    lb_push_row(lbfluid[1][11] + index + (1 + zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[1][x] - m[3][x] + m[4][x] + m[5][x] - m[6][x] + m[8][x] - m[10][x] - m[12][x] + m[13][x] - m[15][x] + m[16][x] + m[17][x] - m[18][x])*w[12];
+    lb_push_row(lbfluid[1][12] + index - (1 + zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[1][x] - m[3][x] + m[4][x] + m[5][x] - m[6][x] - m[8][x] + m[10][x] - m[12][x] - m[13][x] - m[15][x] + m[16][x] + m[17][x] - m[18][x])*w[13];
+    lb_push_row(lbfluid[1][13] + index + (1 - zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[1][x] + m[3][x] + m[4][x] + m[5][x] - m[6][x] - m[8][x] - m[10][x] + m[12][x] + m[13][x] + m[15][x] + m[16][x] + m[17][x] - m[18][x])*w[14];
+    lb_push_row(lbfluid[1][14] + index - (1 - zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[2][x] + m[3][x] + m[4][x] - m[5][x] - m[6][x] + m[9][x] + m[11][x] + m[12][x] - m[14][x] - m[15][x] + m[16][x] - m[17][x] - m[18][x])*w[15];
+    lb_push_row(lbfluid[1][15] + index + (yperiod + zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[2][x] - m[3][x] + m[4][x] - m[5][x] - m[6][x] + m[9][x] - m[11][x] - m[12][x] + m[14][x] + m[15][x] + m[16][x] - m[17][x] - m[18][x])*w[16];
+    lb_push_row(lbfluid[1][16] + index - (yperiod + zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] + m[2][x] - m[3][x] + m[4][x] - m[5][x] - m[6][x] - m[9][x] + m[11][x] - m[12][x] - m[14][x] + m[15][x] + m[16][x] - m[17][x] - m[18][x])*w[17];
+    lb_push_row(lbfluid[1][17] + index + (yperiod - zperiod), n_new, n);
+    for (x = 0; x < n; x++)
+        n_new[x] = (m[0][x] - m[2][x] + m[3][x] + m[4][x] - m[5][x] - m[6][x] - m[9][x] - m[11][x] + m[12][x] + m[14][x] - m[15][x] + m[16][x] - m[17][x] - m[18][x])*w[18];
+    lb_push_row(lbfluid[1][18] + index - (yperiod - zperiod), n_new, n);
+}
+
+/** Collisions and streaming of the fluid sites x0 <= x <= x1 of the
+ *  lattice row (y, z). */
+static void lb_collide_stream_sites(int y, int z, int x0, int x1) {
+    index_t first = get_linear_index(x0, y, z, lblattice.halo_grid);
+#ifdef LB_BOUNDARIES
+    /* only the runs of fluid sites, see lb_init_boundaries */
+    index_t last = first + (x1 - x0);
+    int row = (y - 1) + (z - 1)*lblattice.grid[1];
+
+    for (int r = lb_fluid_run_offset[row]; r < lb_fluid_run_offset[row + 1]; r++) {
+        index_t begin = lb_fluid_runs[r].index;
+        index_t end = begin + lb_fluid_runs[r].length - 1;
+        if (begin < first) begin = first;
+        if (end > last) end = last;
+        for (index_t index = begin; index <= end; index += LB_ROW)
+            lb_collide_stream_row(index, (end - index < LB_ROW) ? (int)(end - index + 1) : LB_ROW);
+    }
+#else // LB_BOUNDARIES
+    for (int x = x0; x <= x1; x += LB_ROW)
+        lb_collide_stream_row(first + (x - x0), imin(LB_ROW, x1 - x + 1));
+#endif // LB_BOUNDARIES
+}
+
+/** Collisions and streaming of the sites in the first and last plane
+ *  of each direction, which push populations into the halo. */
+static void lb_collide_stream_surface() {
+    int *grid = lblattice.grid;
+
+    /* every site pushes into its own target slots, so the planes can
+     * be updated by different threads */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int z = 1; z <= grid[2]; z++) {
+        for (int y = 1; y <= grid[1]; y++) {
+            if (z == 1 || z == grid[2] || y == 1 || y == grid[1]) {
+                lb_collide_stream_sites(y, z, 1, grid[0]);
+            } else {
+                lb_collide_stream_sites(y, z, 1, 1);
+                if (grid[0] > 1)
+                    lb_collide_stream_sites(y, z, grid[0], grid[0]);
+            }
+        }
+    }
+}
+
+/** Collisions and streaming of the interior sites (the ones that are
+ *  not updated by \ref lb_collide_stream_surface) with z0 <= z <= z1.
+ *  The rows are updated in blocks of \ref LB_BLOCK_Y for all planes. */
+static void lb_collide_stream_interior(int z0, int z1) {
+    int *grid = lblattice.grid;
+
+    if (grid[0] <= 2 || z1 < z0)
+        return;
+
+    /* the pairs of block and plane are distributed over the threads */
+    int nblocks = (grid[1] - 2 + LB_BLOCK_Y - 1)/LB_BLOCK_Y;
+    int nz = z1 - z0 + 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int b = 0; b < nblocks*nz; b++) {
+        int y0 = 2 + (b / nz)*LB_BLOCK_Y;
+        int z = z0 + b % nz;
+        for (int y = y0; y < y0 + LB_BLOCK_Y && y < grid[1]; y++)
+            lb_collide_stream_sites(y, z, 2, grid[0] - 1);
+    }
+}
+#endif // !OLD_FLUCT
+
 /* Collisions and streaming (push scheme) */
 inline void lb_collide_stream() {
-    index_t index;
-    int x, y, z;
-    double modes[19];
+    int y, z;
 
     /* loop over all lattice cells (halo excluded) */
 #ifdef LB_BOUNDARIES
@@ -2705,6 +2944,33 @@ inline void lb_collide_stream() {
   
   
 
+#ifndef OLD_FLUCT
+    if (fluct && !(rng_counter_mask & THERMO_LB)) {
+        /* the sequential random numbers of the fluctuations require
+         * the order of the sites */
+        for (z = 1; z <= lblattice.grid[2]; z++)
+            for (y = 1; y <= lblattice.grid[1]; y++)
+                lb_collide_stream_sites(y, z, 1, lblattice.grid[0]);
+
+        halo_push_communication();
+    } else {
+        /* update the surface of the local lattice first, then the
+         * interior in three slabs while the halo regions of one
+         * direction after the other are exchanged */
+        int nz = imax(lblattice.grid[2] - 2, 0);
+
+        lb_collide_stream_surface();
+        for (int dir = 0; dir < 3; dir++) {
+            halo_push_start(dir);
+            lb_collide_stream_interior(2 + dir*nz/3, 1 + (dir + 1)*nz/3);
+            halo_push_finish(dir);
+        }
+    }
+#else // !OLD_FLUCT
+    index_t index;
+    int x;
+    double modes[19];
+
     index = lblattice.halo_offset;
     for (z = 1; z <= lblattice.grid[2]; z++) {
       for (y = 1; y<=lblattice.grid[1]; y++) {
@@ -2750,8 +3016,10 @@ inline void lb_collide_stream() {
         index += 2*lblattice.halo_grid[0]; /* skip halo region */
     }
 
+
     /* exchange halo regions */
     halo_push_communication();
+#endif // !OLD_FLUCT
 
 #ifdef LB_BOUNDARIES
     /* boundary conditions for links */
@@ -2759,7 +3027,7 @@ inline void lb_collide_stream() {
 #endif // LB_BOUNDARIES
 
     /* swap the pointers for old and new population fields */
-    double **tmp;
+    lb_float **tmp;
     tmp = lbfluid[0];
     lbfluid[0] = lbfluid[1];
     lbfluid[1] = tmp;
@@ -2825,7 +3093,7 @@ inline void lb_stream_collide() {
 
     /* swap the pointers for old and new population fields */
     //fprintf(stderr,"swapping pointers\n");
-    double **tmp = lbfluid[0];
+    lb_float **tmp = lbfluid[0];
     lbfluid[0] = lbfluid[1];
     lbfluid[1] = tmp;
 
@@ -2871,17 +3139,21 @@ void lattice_boltzmann_update() {
 /*@{*/
 
 /** Coupling of a single particle to viscous fluid with Stokesian friction.
+ * Only reads the fluid, the momentum transfer to the fluid is done by
+ * \ref lb_transfer_momentum, so that several particles can be coupled
+ * at the same time.
  *
  * Section II.C. Ahlrichs and Duenweg, JCP 111(17):8225 (1999)
  *
  * @param p          The coupled particle (Input).
  * @param force      Coupling force between particle and fluid (Output).
+ * @param node_index The nodes surrounding the particle (Output).
+ * @param delta      The interpolation weights of the nodes (Output).
+ * @param delta_j    Momentum transfer to the fluid in lattice units (Output).
  */
-inline void lb_viscous_coupling(Particle *p, double force[3]) {
-  int x,y,z;
-  index_t node_index[8];
-  double delta[6];
-  double *local_f, interpolated_u[3],delta_j[3];
+inline void lb_viscous_coupling(Particle *p, double force[3], index_t node_index[8],
+                                double delta[6], double delta_j[3]) {
+  double interpolated_u[3];
   
 #ifdef EXTERNAL_FORCES
   if (!(p->p.ext_flag & COORD_FIXED(0)) 
@@ -2993,6 +3265,14 @@ inline void lb_viscous_coupling(Particle *p, double force[3]) {
   delta_j[0] = - force[0]*time_step*lbpar.tau/lbpar.agrid;
   delta_j[1] = - force[1]*time_step*lbpar.tau/lbpar.agrid;
   delta_j[2] = - force[2]*time_step*lbpar.tau/lbpar.agrid;
+}
+
+/** Distributes a momentum transfer to the eight nodes surrounding a
+ *  position, see \ref lb_viscous_coupling. */
+inline void lb_transfer_momentum(const index_t node_index[8], const double delta[6],
+                                 const double delta_j[3]) {
+  int x,y,z;
+  double *local_f;
 
   for (z = 0; z < 2; z++) {
     for (y = 0; y < 2; y++) {
@@ -3005,10 +3285,16 @@ inline void lb_viscous_coupling(Particle *p, double force[3]) {
       }
     }
   }
-
-  // map_position_to_lattice: position ... not inside a local plaquette in ...
+}
 
 #ifdef ENGINE
+/** Force of a swimmer on the fluid at its source position. */
+inline void lb_swimmer_coupling(Particle *p) {
+  int x,y,z;
+  index_t node_index[8];
+  double delta[6];
+  double *local_f, delta_j[3];
+
   if ( p->swim.swimming )
   {
     // TODO: Fix LB mapping
@@ -3052,9 +3338,8 @@ inline void lb_viscous_coupling(Particle *p, double force[3]) {
       }
     }
   }
-#endif
-
 }
+#endif
 
 
 int lb_lbfluid_get_interpolated_velocity(double* p, double* v) {
@@ -3159,6 +3444,32 @@ int lb_lbfluid_get_interpolated_velocity(double* p, double* v) {
 }
 
 
+/** A particle coupled to the fluid, together with the results of
+ *  \ref lb_viscous_coupling. */
+typedef struct {
+  Particle *p;
+  /** 1 for ghost particles, which do not get the force added */
+  int ghost;
+  double force[3];
+  index_t node_index[8];
+  double delta[6];
+  double delta_j[3];
+} LB_Coupling;
+
+/** Buffer of the particles coupled in the current time step. */
+static LB_Coupling *lb_coupling = NULL;
+static int lb_coupling_max = 0;
+
+/** Stores particle p at position i of \ref lb_coupling. */
+inline void lb_coupling_add(int i, Particle *p, int ghost) {
+  if (i >= lb_coupling_max) {
+    lb_coupling_max = 2*i + 16;
+    lb_coupling = (LB_Coupling *) Utils::realloc(lb_coupling, lb_coupling_max*sizeof(LB_Coupling));
+  }
+  lb_coupling[i].p = p;
+  lb_coupling[i].ghost = ghost;
+}
+
 /** Calculate particle lattice interactions.
  * So far, only viscous coupling with Stokesian friction is
  * implemented.
@@ -3196,7 +3507,6 @@ void calc_particle_lattice_ia() {
   int np;
   Cell *cell ;
   Particle *p ;
-  double force[3];
 
   if (transfer_momentum) {
       
@@ -3224,6 +3534,23 @@ void calc_particle_lattice_ia() {
         np = cell->n ;
         for (int i = 0; i < np; i++) 
           {
+            if (rng_counter_mask & THERMO_LB) {
+              double rnd[4];
+#ifdef GAUSSRANDOM
+              counter_random_gaussian(RNG_STREAM_LB_COUPLING, p[i].p.identity, 0, 0, rnd);
+              for (int j = 0; j < 3; j++)
+                p[i].lc.f_random[j] = lb_coupl_pref2 * rnd[j];
+#elif defined (GAUSSRANDOMCUT)
+              counter_random_gaussian_cut(RNG_STREAM_LB_COUPLING, p[i].p.identity, 0, 0, rnd);
+              for (int j = 0; j < 3; j++)
+                p[i].lc.f_random[j] = lb_coupl_pref2 * rnd[j];
+#else
+              counter_random_uniform(RNG_STREAM_LB_COUPLING, p[i].p.identity, 0, 0, rnd);
+              for (int j = 0; j < 3; j++)
+                p[i].lc.f_random[j] = lb_coupl_pref * (rnd[j] - 0.5);
+#endif
+              continue;
+            }
 #ifdef GAUSSRANDOM
             p[i].lc.f_random[0] = lb_coupl_pref2 * gaussian_random();
             p[i].lc.f_random[1] = lb_coupl_pref2 * gaussian_random();
@@ -3252,33 +3579,24 @@ void calc_particle_lattice_ia() {
     ghost_communicator(&cell_structure.ghost_swimming_comm);
 #endif
 
-    /* local cells */
+    /* collect the local particles and those ghosts which lie in the
+     * range of the local lattice nodes */
+    int n_coupled = 0;
     for (int c = 0; c < local_cells.n; c++) {
       cell = local_cells.cell[c] ;
       p = cell->part ;
       np = cell->n ;
       
       for (int i = 0; i < np; i++) {
-        
 #ifdef IMMERSED_BOUNDARY
         // Virtual particles for IBM must not be coupled
-        if(!ifParticleIsVirtual(&p[i]))
+        if(ifParticleIsVirtual(&p[i]))
+          continue;
 #endif
-        {
-          lb_viscous_coupling(&p[i],force);
-        
-          /* add force to the particle */
-          p[i].f.f[0] += force[0];
-          p[i].f.f[1] += force[1];
-          p[i].f.f[2] += force[2];
-        
-          ONEPART_TRACE( if (p->p.identity == check_id)  {
-                          fprintf(stderr, "%d: OPT: LB f = (%.6e,%.3e,%.3e)\n", this_node, p->f.f[0], p->f.f[1], p->f.f[2]);  } );
-        }
+        lb_coupling_add(n_coupled++, &p[i], 0);
       }
     }
       
-    /* ghost cells */
     for (int c = 0; c < ghost_cells.n ;c++) {
       cell = ghost_cells.cell[c] ;
       p = cell->part ;
@@ -3304,24 +3622,44 @@ void calc_particle_lattice_ia() {
                           );
 #ifdef IMMERSED_BOUNDARY
             // Virtual particles for IBM must not be coupled
-            if(!ifParticleIsVirtual(&p[i]))
+            if(ifParticleIsVirtual(&p[i]))
+              continue;
 #endif
-            {
-              lb_viscous_coupling(&p[i],force);
-            }
-            
-            /* ghosts must not have the force added! */
-            ONEPART_TRACE(
-                          if (p->p.identity == check_id)
-                            {
-                              fprintf(stderr,
-                                      "%d: OPT: LB f = (%.6e,%.3e,%.3e)\n",
-                                      this_node, p->f.f[0], p->f.f[1], p->f.f[2]);
-                            }
-                          );
+            lb_coupling_add(n_coupled++, &p[i], 1);
           }
       }
     }
+
+    /* the coupling forces only read the fluid populations and can
+     * be determined for all particles at once */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < n_coupled; i++) {
+      LB_Coupling *cp = &lb_coupling[i];
+      lb_viscous_coupling(cp->p, cp->force, cp->node_index, cp->delta, cp->delta_j);
+    }
+
+    /* the momentum is transferred to the fluid in the order of the
+     * particles, so that the result does not depend on the number of
+     * threads */
+    for (int i = 0; i < n_coupled; i++) {
+      LB_Coupling *cp = &lb_coupling[i];
+      lb_transfer_momentum(cp->node_index, cp->delta, cp->delta_j);
+#ifdef ENGINE
+      lb_swimmer_coupling(cp->p);
+#endif
+
+      /* ghosts must not have the force added! */
+      if (!cp->ghost) {
+        cp->p->f.f[0] += cp->force[0];
+        cp->p->f.f[1] += cp->force[1];
+        cp->p->f.f[2] += cp->force[2];
+      }
+
+      ONEPART_TRACE( if (cp->p->p.identity == check_id)  {
+                      fprintf(stderr, "%d: OPT: LB f = (%.6e,%.3e,%.3e)\n", this_node, cp->p->f.f[0], cp->p->f.f[1], cp->p->f.f[2]);  } );
+    }
   }
 }
 
@@ -184,10 +184,24 @@ extern LB_Parameters lbpar;
 /** The underlying lattice */
 extern Lattice lblattice;
 
+/** Storage type of the velocity populations. With \ref
+ * LB_SINGLE_PRECISION the populations are kept in single precision,
+ * which halves the memory traffic of the collide-stream step and of
+ * the halo exchange, while all moments and the collision itself are
+ * still computed in double precision. Since the populations are stored
+ * as deviations from their equilibrium values at the reference
+ * density, the rounding error stays small compared to the
+ * fluctuations of the fluid. */
+#ifdef LB_SINGLE_PRECISION
+typedef float lb_float;
+#else
+typedef double lb_float;
+#endif
+
 /** Pointer to the velocity populations of the fluid.
  * lbfluid[0] contains pre-collision populations, lbfluid[1]
  * contains post-collision populations*/
-extern double **lbfluid[2];
+extern lb_float **lbfluid[2];
 
 /** Pointer to the hydrodynamic fields of the fluid */
 extern LB_FluidNode *lbfields;
@@ -47,6 +47,13 @@
 /** minimal radius for the far formula in multiples of box_l[2] */
 #define MIN_RAD 0.01
 
+/** length of the key of a MMM1D tuning cache entry. */
+#define MMM1D_TUNE_CACHE_KEY   9
+/** number of key values that have to match exactly. */
+#define MMM1D_TUNE_CACHE_EXACT 5
+/** length of a MMM1D tuning result in the tuning cache. */
+#define MMM1D_TUNE_CACHE_RES   2
+
 /** if you define this, the Besselfunctions are calculated up
     to machine precision, otherwise 10^-14, which should be
     definitely enough for daily life. */
@@ -360,11 +367,36 @@ int mmm1d_tune(char **log)
   char buffer[32 + 2*ES_DOUBLE_SPACE + ES_INTEGER_SPACE];
   double int_time, min_time=1e200, min_rad = -1;
   double maxrad = box_l[2]; /* N_psi = 2, theta=2/3 maximum for rho */
-  double switch_radius;
+  double switch_radius, switch_radius_min = 0.2*maxrad;
+  double cache_key[MMM1D_TUNE_CACHE_KEY], cache_res[MMM1D_TUNE_CACHE_RES];
+  int cached = TUNE_CACHE_MISS;
 
   if (mmm1d_params.far_switch_radius_2 < 0) {
+    /* key of the system in the tuning cache, see p3m_adaptive_tune() */
+    cache_key[0] = node_grid[0];
+    cache_key[1] = node_grid[1];
+    cache_key[2] = node_grid[2];
+    cache_key[3] = coulomb.prefactor;
+    cache_key[4] = mmm1d_params.maxPWerror;
+    cache_key[5] = box_l[0];
+    cache_key[6] = box_l[1];
+    cache_key[7] = box_l[2];
+    cache_key[8] = n_part;
+    cached = tune_cache_lookup("mmm1d", cache_key, MMM1D_TUNE_CACHE_KEY, MMM1D_TUNE_CACHE_EXACT,
+			       cache_res, MMM1D_TUNE_CACHE_RES);
+    if (cached == TUNE_CACHE_HIT) {
+      /* skip the timings */
+      min_rad = cache_res[0]*maxrad;
+      switch_radius_min = 0.4*maxrad;
+      sprintf(buffer, "cached r= %f\n", min_rad);
+      *log = strcat_alloc(*log, buffer);
+    }
+    else if (cached == TUNE_CACHE_NEAREST && cache_res[0] - 0.05 > 0.2)
+      /* warm start shortly below the most similar cached system */
+      switch_radius_min = (cache_res[0] - 0.05)*maxrad;
+
     /* determine besselcutoff and optimal switching radius. Should be around 0.33 */
-    for (switch_radius = 0.2*maxrad;
+    for (switch_radius = switch_radius_min;
 	 switch_radius < 0.4*maxrad;
 	 switch_radius += 0.025*maxrad) {
       if (switch_radius <= bessel_radii[MAXIMAL_B_CUT - 1]) {
@@ -399,6 +431,13 @@ int mmm1d_tune(char **log)
     }
     switch_radius = min_rad;
     mmm1d_params.far_switch_radius_2 = SQR(switch_radius);
+
+    /* only store radii that were actually timed */
+    if (cached != TUNE_CACHE_HIT && min_rad > 0) {
+      cache_res[0] = switch_radius/maxrad;
+      cache_res[1] = min_time;
+      tune_cache_store("mmm1d", cache_key, MMM1D_TUNE_CACHE_KEY, cache_res, MMM1D_TUNE_CACHE_RES);
+    }
   }
   else {
     if (mmm1d_params.far_switch_radius_2 <= SQR(bessel_radii[MAXIMAL_B_CUT - 1])) {
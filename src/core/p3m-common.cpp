@@ -21,6 +21,7 @@
 /** \file p3m-common.cpp P3M main file.
 */
 #include "p3m-common.hpp"
+#include "fft-common.hpp"
 
 #if defined(P3M) || defined(DP3M)
 
@@ -53,6 +54,8 @@ void p3m_common_parameter_pre_init(p3m_parameter_struct *params) {
   params->additional_mesh[0] = 0;
   params->additional_mesh[1] = 0;
   params->additional_mesh[2] = 0;
+  params->fft_comm = FFT_COMM_NONBLOCKING;
+  params->store_ca_frac = 1;
 }
 
 /** Debug function printing p3m structures */
@@ -144,6 +147,8 @@ double p3m_analytic_cotangent_sum(int n, double mesh_i, int cao)
   return res;
 }
 
+#endif /* defined(P3M) || defined(DP3M) */
+
 /** Computes the  assignment function of for the \a i'th degree
     at value \a x. */
 double p3m_caf(int i, double x, int cao_value) {
@@ -222,4 +227,3 @@ double p3m_caf(int i, double x, int cao_value) {
     return 0.0;
   }}}
 }
-#endif /* defined(P3M) || defined(DP3M) */
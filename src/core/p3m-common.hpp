@@ -158,6 +158,12 @@ typedef struct {
   /** additional points around the charge assignment mesh, for method like dielectric ELC
       creating virtual charges. */
   double additional_mesh[3];
+  /** communication scheme of the parallel FFT, see \ref FFT_COMM_NONBLOCKING. */
+  int fft_comm;
+  /** whether the charge assignment fractions (cao^3 per charge) are
+      stored for the force interpolation, or recomputed from the one
+      dimensional weights. Only used by the charge P3M. */
+  int store_ca_frac;
 } p3m_parameter_struct;
 
 /** initialize the parameter struct */
@@ -193,10 +199,11 @@ void p3m_add_block(double *in, double *out, int start[3], int size[3], int dim[3
     is Eqn. 7.66 in the book of Hockney and Eastwood). */
 double p3m_analytic_cotangent_sum(int n, double mesh_i, int cao);
 
+#endif /* P3M || DP3M */
+
 /** Computes the  assignment function of for the \a i'th degree
-    at value \a x. */
+    at value \a x. Also used for the density mesh of \ref
+    calc_structurefactor_mesh. */
 double p3m_caf(int i, double x,int cao_value);
 
-#endif /* P3M || DP3M */
-
 #endif /* _P3M_COMMON_H */
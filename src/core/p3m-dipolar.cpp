@@ -62,6 +62,13 @@
 /** Tag for communication in p3m_spread_force_grid(). */
 #define REQ_P3M_SPREAD_D 2021
 
+/** length of the key of a dipolar P3M tuning cache entry. */
+#define DP3M_TUNE_CACHE_KEY   16
+/** number of key values that have to match exactly. */
+#define DP3M_TUNE_CACHE_EXACT 11
+/** length of a dipolar P3M tuning result in the tuning cache. */
+#define DP3M_TUNE_CACHE_RES   6
+
 /************************************************
  * variables
  ************************************************/
@@ -370,6 +377,7 @@ void dp3m_init() {
     /* FFT */
     P3M_TRACE(fprintf(stderr,"%d: dp3m.rs_mesh ADR=%p\n",this_node,dp3m.rs_mesh));
  
+    dfft.comm = dp3m.params.fft_comm;
     int ca_mesh_size = dfft_init(&dp3m.rs_mesh,
 				 dp3m.local_mesh.dim,dp3m.local_mesh.margin,
 				 dp3m.params.mesh, dp3m.params.mesh_off,
@@ -597,6 +605,18 @@ int dp3m_set_ninterpol(int n)
   return ES_OK;
 }
 
+int dp3m_set_fft_comm(int comm)
+{
+  if (comm != FFT_COMM_SENDRECV && comm != FFT_COMM_NONBLOCKING)
+    return ES_ERROR;
+
+  dp3m.params.fft_comm = comm;
+
+  mpi_bcast_coulomb_params();
+
+  return ES_OK;
+}
+
 /*****************************************************************************/
 
 
@@ -1873,6 +1893,8 @@ int dp3m_adaptive_tune(char **logger)
   double                             accuracy = -1, tmp_accuracy=0.0;
   double                            time_best=1e20, tmp_time;
   char b[3*ES_INTEGER_SPACE + 3*ES_DOUBLE_SPACE + 128];
+  double cache_key[DP3M_TUNE_CACHE_KEY], cache_res[DP3M_TUNE_CACHE_RES];
+  int cached;
  
   P3M_TRACE(fprintf(stderr,"%d: dp3m_adaptive_tune\n",this_node));
 
@@ -1890,6 +1912,24 @@ int dp3m_adaptive_tune(char **logger)
     *logger = strcat_alloc(*logger, "no dipolar particles in the system, cannot tune dipolar P3M");
     return ES_ERROR;
   }
+
+  /* key of the system in the tuning cache, see p3m_adaptive_tune() */
+  cache_key[0]  = node_grid[0];
+  cache_key[1]  = node_grid[1];
+  cache_key[2]  = node_grid[2];
+  cache_key[3]  = (coulomb.Dmethod == DIPOLAR_MDLC_P3M) ? DIPOLAR_MDLC_P3M : DIPOLAR_P3M;
+  cache_key[4]  = coulomb.Dprefactor;
+  cache_key[5]  = dp3m.params.accuracy;
+  cache_key[6]  = dp3m.params.epsilon;
+  cache_key[7]  = skin;
+  cache_key[8]  = dp3m.params.mesh[0];
+  cache_key[9]  = dp3m.params.cao;
+  cache_key[10] = dp3m.params.r_cut_iL;
+  cache_key[11] = box_l[0];
+  cache_key[12] = box_l[1];
+  cache_key[13] = box_l[2];
+  cache_key[14] = dp3m.sum_dip_part;
+  cache_key[15] = dp3m.sum_mu2;
   
   /* parameter ranges */
   if (dp3m.params.mesh[0] == 0 ) {
@@ -1937,6 +1977,33 @@ int dp3m_adaptive_tune(char **logger)
     *logger = strcat_alloc(*logger, b);
   }
 
+  cached = tune_cache_lookup("dp3m", cache_key, DP3M_TUNE_CACHE_KEY, DP3M_TUNE_CACHE_EXACT,
+			     cache_res, DP3M_TUNE_CACHE_RES);
+  if (cached == TUNE_CACHE_HIT) {
+    sprintf(b, "using cached parameters from %.64s\n", tune_cache_file);
+    *logger = strcat_alloc(*logger, b);
+    time_best = cache_res[5];
+    mesh      = (int)cache_res[0];
+    cao       = (int)cache_res[1];
+    r_cut_iL  = cache_res[2];
+    alpha_L   = cache_res[3];
+    accuracy  = cache_res[4];
+    /* skip the mesh loop */
+    tmp_mesh  = mesh_max + 1;
+    set_dipolar_method_local((DipolarInteraction)(int)cache_key[3]);
+  }
+  else if (cached == TUNE_CACHE_NEAREST) {
+    /* warm start one mesh below the mesh and with the cao that were
+       optimal for the most similar cached system */
+    if (dp3m.params.mesh[0] == 0)
+      while (4*tmp_mesh <= (int)cache_res[0] && 2*tmp_mesh <= mesh_max)
+	tmp_mesh *= 2;
+    if (cao_min < cao_max)
+      cao = (int)cache_res[1];
+    sprintf(b, "warm start from cached parameters in %.64s\n", tune_cache_file);
+    *logger = strcat_alloc(*logger, b);
+  }
+
   *logger = strcat_alloc(*logger, "Dmesh cao Dr_cut_iL   Dalpha_L     Derr         Drs_err    Dks_err    time [ms]\n");
 
   /* mesh loop */
@@ -1975,6 +2042,16 @@ int dp3m_adaptive_tune(char **logger)
     return ES_ERROR;
   }
 
+  if (cached != TUNE_CACHE_HIT) {
+    cache_res[0] = mesh;
+    cache_res[1] = cao;
+    cache_res[2] = r_cut_iL;
+    cache_res[3] = alpha_L;
+    cache_res[4] = accuracy;
+    cache_res[5] = time_best;
+    tune_cache_store("dp3m", cache_key, DP3M_TUNE_CACHE_KEY, cache_res, DP3M_TUNE_CACHE_RES);
+  }
+
   /* set tuned p3m parameters */
   dp3m.params.r_cut_iL = r_cut_iL;
   dp3m.params.mesh[0]  = dp3m.params.mesh[1] = dp3m.params.mesh[2] = mesh;
@@ -109,6 +109,10 @@ int dp3m_set_params(double r_cut, int mesh, int cao,
 
 int dp3m_set_ninterpol(int n);
 
+/** Select the communication scheme of the parallel FFT.
+    \param comm \ref FFT_COMM_SENDRECV or \ref FFT_COMM_NONBLOCKING. */
+int dp3m_set_fft_comm(int comm);
+
 int dp3m_set_mesh_offset(double x, double y, double z);
 
 int dp3m_set_eps(double eps);
@@ -56,6 +56,13 @@ p3m_data_struct p3m;
 /** Tag for communication in p3m_spread_force_grid(). */
 #define REQ_P3M_SPREAD 202
 
+/** length of the key of a P3M tuning cache entry. */
+#define P3M_TUNE_CACHE_KEY   18
+/** number of key values that have to match exactly. */
+#define P3M_TUNE_CACHE_EXACT 13
+/** length of a P3M tuning result in the tuning cache. */
+#define P3M_TUNE_CACHE_RES   9
+
 /* Index helpers for direct and reciprocal space
  * After the FFT the data is in order YZX, which
  * means that Y is the slowest changing index.
@@ -352,6 +359,7 @@ void   p3m_init() {
     /* FFT */
     P3M_TRACE(fprintf(stderr,"%d: p3m.rs_mesh ADR=%p\n",this_node,p3m.rs_mesh));
  
+    fft.comm = p3m.params.fft_comm;
     int ca_mesh_size = fft_init(&p3m.rs_mesh,
 				p3m.local_mesh.dim,p3m.local_mesh.margin,
 				p3m.params.mesh, p3m.params.mesh_off,
@@ -490,6 +498,27 @@ int p3m_set_ninterpol(int n)
   return ES_OK;
 }
 
+int p3m_set_store_ca_frac(int store)
+{
+  p3m.params.store_ca_frac = store ? 1 : 0;
+
+  mpi_bcast_coulomb_params();
+
+  return ES_OK;
+}
+
+int p3m_set_fft_comm(int comm)
+{
+  if (comm != FFT_COMM_SENDRECV && comm != FFT_COMM_NONBLOCKING)
+    return ES_ERROR;
+
+  p3m.params.fft_comm = comm;
+
+  mpi_bcast_coulomb_params();
+
+  return ES_OK;
+}
+
 
 /************************************* method ********************************/
 /*****************************************************************************/
@@ -603,32 +632,23 @@ void p3m_assign_charge(double q, double real_pos[3], int cp_cnt) {
 }  
 
 
+/** Calculate the separable charge assignment weights of a charge.
+    The weight of mesh point (i0,i1,i2) relative to the first mesh point
+    is w[0][i0]*w[1][i1]*w[2][i2].
+    \param real_pos position of the charge.
+    \param w        the one dimensional weights (output).
+    \return index of the first mesh point in \ref p3m_data_struct::rs_mesh.
+*/
 template<int cao>
-void p3m_do_assign_charge(double q,
-		       double real_pos[3],
-		       int cp_cnt)
+inline int p3m_calc_weights(double real_pos[3], double w[3][cao])
 {
-  int d, i0, i1, i2;
-  double tmp0, tmp1;
+  int d, i;
   /* position of a particle in local mesh units */
   double pos;
   /* 1d-index of nearest mesh point */
   int nmp;
-  /* distance to nearest mesh point */
-  double dist[3];
-  /* index for caf interpolation grid */
-  int arg[3];
-  /* index, index jumps for rs_mesh array */
+  /* index for rs_mesh array */
   int q_ind = 0;
-  double cur_ca_frac_val;
-#ifdef P3M_STORE_CA_FRAC
-  double *cur_ca_frac;
-
-  // make sure we have enough space
-  if (cp_cnt >= p3m.ca_num) p3m_realloc_ca_fields(cp_cnt + 1);
-  // do it here, since p3m_realloc_ca_fields may change the address of p3m.ca_frac
-  cur_ca_frac = p3m.ca_frac + cao*cao*cao*cp_cnt;
-#endif
 
   for(d=0;d<3;d++) {
     /* particle position in mesh coordinates */
@@ -637,13 +657,19 @@ void p3m_do_assign_charge(double q,
     nmp  = (int)pos;
     /* 3d-array index of nearest mesh point */
     q_ind = (d == 0) ? nmp : nmp + p3m.local_mesh.dim[d]*q_ind;
-    
-    if (p3m.params.inter == 0)
+
+    if (p3m.params.inter == 0) {
       /* distance to nearest mesh point */
-      dist[d] = (pos-nmp)-0.5;
-    else
+      double dist = (pos-nmp)-0.5;
+      for(i=0; i<cao; i++)
+	w[d][i] = p3m_caf(i, dist, cao);
+    }
+    else {
       /* distance to nearest mesh point for interpolation */
-      arg[d] = (int) ((pos - nmp)*p3m.params.inter2);
+      int arg = (int) ((pos - nmp)*p3m.params.inter2);
+      for(i=0; i<cao; i++)
+	w[d][i] = p3m.int_caf[i][arg];
+    }
 
 #ifdef ADDITIONAL_CHECKS
     if( pos < -skin*p3m.params.ai[d] ) {
@@ -659,46 +685,52 @@ void p3m_do_assign_charge(double q,
 #endif
   }
 
+  return q_ind;
+}
+
+template<int cao>
+void p3m_do_assign_charge(double q,
+		       double real_pos[3],
+		       int cp_cnt)
+{
+  int i0, i1, i2;
+  double tmp1;
+  /* separable charge assignment weights */
+  double w[3][cao];
+  /* index, index jumps for rs_mesh array */
+  int q_ind = p3m_calc_weights<cao>(real_pos, w);
 #ifdef P3M_STORE_CA_FRAC
-  if (cp_cnt >= 0) p3m.ca_fmp[cp_cnt] = q_ind;
+  double *cur_ca_frac = NULL;
+
+  if (cp_cnt >= 0 && p3m.params.store_ca_frac) {
+    // make sure we have enough space
+    if (cp_cnt >= p3m.ca_num) p3m_realloc_ca_fields(cp_cnt + 1);
+    // do it here, since p3m_realloc_ca_fields may change the address of p3m.ca_frac
+    cur_ca_frac = p3m.ca_frac + cao*cao*cao*cp_cnt;
+    p3m.ca_fmp[cp_cnt] = q_ind;
+  }
 #endif
-  
-  if (p3m.params.inter == 0) {
-    for(i0=0; i0<cao; i0++) {
-      tmp0 = p3m_caf(i0, dist[0],cao);
-      for(i1=0; i1<cao; i1++) {
-	tmp1 = tmp0 * p3m_caf(i1, dist[1],cao);
-	for(i2=0; i2<cao; i2++) {
-	  cur_ca_frac_val = q * tmp1 * p3m_caf(i2, dist[2], cao);
-	  p3m.rs_mesh[q_ind] += cur_ca_frac_val;
+
+  for(i0=0; i0<cao; i0++) {
+    for(i1=0; i1<cao; i1++) {
+      double *mesh = p3m.rs_mesh + q_ind;
+      tmp1 = w[0][i0] * w[1][i1];
 #ifdef P3M_STORE_CA_FRAC
-	  /* store current ca frac */
-	  if (cp_cnt >= 0) *(cur_ca_frac++) = cur_ca_frac_val;
-#endif
-	  q_ind++;
-	}
-	q_ind += p3m.local_mesh.q_2_off;
-      }
-      q_ind += p3m.local_mesh.q_21_off;
-    }
-  } else {
-    for(i0=0; i0<cao; i0++) {
-      tmp0 = p3m.int_caf[i0][arg[0]];
-      for(i1=0; i1<cao; i1++) {
-	tmp1 = tmp0 * p3m.int_caf[i1][arg[1]];
+      if (cur_ca_frac) {
+	/* store current ca frac */
 	for(i2=0; i2<cao; i2++) {
-	  cur_ca_frac_val = q * tmp1 * p3m.int_caf[i2][arg[2]];
-	  p3m.rs_mesh[q_ind] += cur_ca_frac_val;
-#ifdef P3M_STORE_CA_FRAC
-	  /* store current ca frac */
-	  if (cp_cnt >= 0) *(cur_ca_frac++) = cur_ca_frac_val;
-#endif
-	  q_ind++;
+	  cur_ca_frac[i2] = q * tmp1 * w[2][i2];
+	  mesh[i2] += cur_ca_frac[i2];
 	}
-	q_ind += p3m.local_mesh.q_2_off;
+	cur_ca_frac += cao;
       }
-      q_ind += p3m.local_mesh.q_21_off;
+      else
+#endif
+	for(i2=0; i2<cao; i2++)
+	  mesh[i2] += q * tmp1 * w[2][i2];
+      q_ind += cao + p3m.local_mesh.q_2_off;
     }
+    q_ind += p3m.local_mesh.q_21_off;
   }
 }
 
@@ -721,16 +753,13 @@ static void P3M_assign_forces(double force_prefac, int d_rs)
 #ifdef ONEPART_DEBUG
   double db_fsum=0.0; /* TODO: db_fsum was missing and code couldn't compile. Now it has the arbitrary value of 0, fix it. */ 
 #endif
+#ifdef P3M_STORE_CA_FRAC
   /* charged particle counter, charge fraction counter */
   int cp_cnt=0;
-#ifdef P3M_STORE_CA_FRAC
   int cf_cnt=0;
-#else
-  /* distance to nearest mesh point */
-  double dist[3];
-  /* index for caf interpolation grid */
-  int arg[3];
 #endif
+  /* separable charge assignment weights */
+  double w[3][cao];
   /* index, index jumps for rs_mesh array */
   int q_ind = 0;
 
@@ -741,70 +770,43 @@ static void P3M_assign_forces(double force_prefac, int d_rs)
     for(i=0; i<np; i++) { 
       if( (q=p[i].p.q) != 0.0 ) {
 #ifdef P3M_STORE_CA_FRAC
-	q_ind = p3m.ca_fmp[cp_cnt];
-	for(i0=0; i0<cao; i0++) {
-	  for(i1=0; i1<cao; i1++) {
-	    for(i2=0; i2<cao; i2++) {
-	      p[i].f.f[d_rs] -= force_prefac*p3m.ca_frac[cf_cnt]*p3m.rs_mesh[q_ind]; 
-	      q_ind++;
-	      cf_cnt++;
-	    }
-	    q_ind += p3m.local_mesh.q_2_off;
-	  }
-	  q_ind += p3m.local_mesh.q_21_off;
-	}
-	cp_cnt++;
-#else
-	double pos;
-	int nmp;
-	double tmp0,tmp1;
-	double cur_ca_frac_val;
-	for(int d=0;d<3;d++) {
-	  /* particle position in mesh coordinates */
-	  pos    = ((p[i].r.p[d]-p3m.local_mesh.ld_pos[d])*p3m.params.ai[d]) - p3m.pos_shift;
-	  /* nearest mesh point */
-	  nmp  = (int)pos;
-	  /* 3d-array index of nearest mesh point */
-	  q_ind = (d == 0) ? nmp : nmp + p3m.local_mesh.dim[d]*q_ind;
-
-	  if (p3m.params.inter == 0)
-	    /* distance to nearest mesh point */
-	    dist[d] = (pos-nmp)-0.5;
-	  else
-	    /* distance to nearest mesh point for interpolation */
-	    arg[d] = (int)((pos-nmp)*p3m.params.inter2);
-	}
-
-	if (p3m.params.inter == 0) {
+	if (p3m.params.store_ca_frac) {
+	  q_ind = p3m.ca_fmp[cp_cnt];
 	  for(i0=0; i0<cao; i0++) {
-	    tmp0 = p3m_caf(i0, dist[0],cao);
 	    for(i1=0; i1<cao; i1++) {
-	      tmp1 = tmp0 * p3m_caf(i1, dist[1],cao);
 	      for(i2=0; i2<cao; i2++) {
-		cur_ca_frac_val = q * tmp1 * p3m_caf(i2, dist[2], cao);
-		p[i].f.f[d_rs] -= force_prefac*cur_ca_frac_val*p3m.rs_mesh[q_ind];
+		p[i].f.f[d_rs] -= force_prefac*p3m.ca_frac[cf_cnt]*p3m.rs_mesh[q_ind]; 
 		q_ind++;
+		cf_cnt++;
 	      }
 	      q_ind += p3m.local_mesh.q_2_off;
 	    }
 	    q_ind += p3m.local_mesh.q_21_off;
 	  }
-	} else {
+	  cp_cnt++;
+	}
+	else
+#endif
+	{
+	  /* recompute the weights, and sum up the mesh one direction
+	     after the other */
+	  double f0 = 0.0;
+	  q_ind = p3m_calc_weights<cao>(p[i].r.p, w);
 	  for(i0=0; i0<cao; i0++) {
-	    tmp0 = p3m.int_caf[i0][arg[0]];
+	    double f1 = 0.0;
 	    for(i1=0; i1<cao; i1++) {
-	      tmp1 = tmp0 * p3m.int_caf[i1][arg[1]];
-	      for(i2=0; i2<cao; i2++) {
-		cur_ca_frac_val = q * tmp1 * p3m.int_caf[i2][arg[2]];
-		p[i].f.f[d_rs] -= force_prefac*cur_ca_frac_val*p3m.rs_mesh[q_ind];
-		q_ind++;
-	      }
-	      q_ind += p3m.local_mesh.q_2_off;
+	      double f2 = 0.0;
+	      double *mesh = p3m.rs_mesh + q_ind;
+	      for(i2=0; i2<cao; i2++)
+		f2 += w[2][i2]*mesh[i2];
+	      f1 += w[1][i1]*f2;
+	      q_ind += cao + p3m.local_mesh.q_2_off;
 	    }
+	    f0 += w[0][i0]*f1;
 	    q_ind += p3m.local_mesh.q_21_off;
 	  }
+	  p[i].f.f[d_rs] -= force_prefac*q*f0;
 	}
-#endif
 
 	ONEPART_TRACE(if(p[i].p.identity==check_id) fprintf(stderr,"%d: OPT: P3M  f = (%.3e,%.3e,%.3e) in dir %d add %.5f\n",this_node,p[i].f.f[0],p[i].f.f[1],p[i].f.f[2],d_rs,-db_fsum));
       }
@@ -912,25 +914,25 @@ double p3m_calc_kspace_forces(int force_flag, int energy_flag)
 	    switch(p3m.params.cao) 
 	      {
 	      case 1:
-		P3M_assign_forces<1>(force_prefac, d_rs); 
+		P3M_assign_forces<1>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 2:
-		P3M_assign_forces<2>(force_prefac, d_rs); 
+		P3M_assign_forces<2>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 3:
-		P3M_assign_forces<3>(force_prefac, d_rs); 
+		P3M_assign_forces<3>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 4:
-		P3M_assign_forces<4>(force_prefac, d_rs); 
+		P3M_assign_forces<4>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 5:
-		P3M_assign_forces<5>(force_prefac, d_rs); 
+		P3M_assign_forces<5>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 6:
-		P3M_assign_forces<6>(force_prefac, d_rs); 
+		P3M_assign_forces<6>(force_flag*force_prefac, d_rs); 
 		break;
 	      case 7:
-		P3M_assign_forces<7>(force_prefac, d_rs); 
+		P3M_assign_forces<7>(force_flag*force_prefac, d_rs); 
 		break;
 	      }
         }
@@ -975,7 +977,7 @@ double p3m_calc_dipole_term(int force_flag, int energy_flag)
     en = 0;
   if (force_flag) {
     for (j = 0; j < 3; j++)
-      gbl_dm[j] *= pref;
+      gbl_dm[j] *= force_flag*pref;
     for (c = 0; c < local_cells.n; c++) {
       np   = local_cells.cell[c]->n;
       part = local_cells.cell[c]->part;
@@ -1083,7 +1085,8 @@ void p3m_realloc_ca_fields(int newsize)
 
   P3M_TRACE(fprintf(stderr,"%d: p3m_realloc_ca_fields: old_size=%d -> new_size=%d\n",this_node,p3m.ca_num,newsize));
   p3m.ca_num = newsize;
-  p3m.ca_frac = (double *)Utils::realloc(p3m.ca_frac, p3m.params.cao3*p3m.ca_num*sizeof(double));
+  /* the fractions are only needed if they are stored */
+  p3m.ca_frac = (double *)Utils::realloc(p3m.ca_frac, (p3m.params.store_ca_frac ? p3m.params.cao3*p3m.ca_num : 0)*sizeof(double));
   p3m.ca_fmp  = (int *)Utils::realloc(p3m.ca_fmp, p3m.ca_num*sizeof(int));
     
 } 
@@ -1355,17 +1358,16 @@ static double p3m_mcr_time(int mesh[3], int cao, double r_cut_iL, double alpha_L
   return int_time;
 }
 
-/** get the optimal alpha and the corresponding computation time for fixed mesh, cao. The r_cut is determined via
-    a simple bisection. Returns -1 if the force evaluation does not work, -2 if there is no valid r_cut, and -3 if
-    the charge assigment order is to large for this grid */
-static double p3m_mc_time(char **log, int mesh[3], int cao,
-			  double r_cut_iL_min, double r_cut_iL_max, double *_r_cut_iL,
-			  double *_alpha_L, double *_accuracy)
+/** get the optimal alpha and the smallest r_cut that give the required accuracy for fixed mesh and cao.
+    The r_cut is determined via a simple bisection. Returns 0 on success, -2 if there is no valid r_cut,
+    -3 if the charge assigment order is to large for this grid, and -P3M_TUNE_ELCTEST if the
+    r_cut conflicts with the ELC gap. Rejected combinations are reported in the log, if log is not NULL. */
+static int p3m_mc_r_cut(char **log, int mesh[3], int cao,
+			double r_cut_iL_min, double r_cut_iL_max, double *_r_cut_iL,
+			double *_alpha_L, double *_accuracy, double *_rs_err, double *_ks_err)
 {
-  double int_time;
   double r_cut_iL;
   double rs_err, ks_err, mesh_size, k_cut;
-  int i, n_cells;
   char b[5*ES_DOUBLE_SPACE + 3*ES_INTEGER_SPACE + 128];
 
   /* initial checks. */
@@ -1374,8 +1376,10 @@ static double p3m_mc_time(char **log, int mesh[3], int cao,
   P3M_TRACE(fprintf(stderr, "p3m_mc_time: mesh=(%d, %d, %d), cao=%d, rmin=%f, rmax=%f\n",
 		    mesh[0],mesh[1],mesh[2], cao, r_cut_iL_min, r_cut_iL_max));
   if(cao >= imin(mesh[0],imin(mesh[1],mesh[2])) || k_cut >= (dmin(min_box_l,min_local_box_l) - skin)) {
-    sprintf(b, "%-4d %-3d cao too large for this mesh\n", mesh[0], cao);
-    *log = strcat_alloc(*log, b);
+    if (log) {
+      sprintf(b, "%-4d %-3d cao too large for this mesh\n", mesh[0], cao);
+      *log = strcat_alloc(*log, b);
+    }
     return -3;
   }
 
@@ -1384,9 +1388,11 @@ static double p3m_mc_time(char **log, int mesh[3], int cao,
   if ((*_accuracy = p3m_get_accuracy(mesh, cao, r_cut_iL_max, _alpha_L, &rs_err, &ks_err)) > p3m.params.accuracy) {
     /* print result */
     P3M_TRACE(puts("p3m_mc_time: accuracy not achieved."));
-    sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e accuracy not achieved\n",
-	    mesh[0], cao, r_cut_iL_max, *_alpha_L, *_accuracy, rs_err, ks_err);
-    *log = strcat_alloc(*log, b);
+    if (log) {
+      sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e accuracy not achieved\n",
+	      mesh[0], cao, r_cut_iL_max, *_alpha_L, *_accuracy, rs_err, ks_err);
+      *log = strcat_alloc(*log, b);
+    }
     return -2;
   }
 
@@ -1407,17 +1413,41 @@ static double p3m_mc_time(char **log, int mesh[3], int cao,
   /* final result is always the upper interval boundary, since only there
      we know that the desired minimal accuracy is obtained */
   *_r_cut_iL = r_cut_iL = r_cut_iL_max;
+  *_accuracy = p3m_get_accuracy(mesh, cao, r_cut_iL, _alpha_L, _rs_err, _ks_err);
 
   /* check whether we are running P3M+ELC, and whether we leave a reasonable gap space */
   if (coulomb.method == COULOMB_ELC_P3M && elc_params.gap_size <= 1.1*r_cut_iL*box_l[0]) {
     P3M_TRACE(fprintf(stderr, "p3m_mc_time: mesh (%d, %d, %d) cao %d r_cut %f reject r_cut %f > gap %f\n", mesh[0],mesh[1],mesh[2], cao, r_cut_iL,
                      2*r_cut_iL*box_l[0], elc_params.gap_size));
     /* print result */
-    sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e conflict with ELC\n",
-	    mesh[0], cao, r_cut_iL, *_alpha_L, *_accuracy, rs_err, ks_err);
-    *log = strcat_alloc(*log, b);
+    if (log) {
+      sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e conflict with ELC\n",
+	      mesh[0], cao, r_cut_iL, *_alpha_L, *_accuracy, *_rs_err, *_ks_err);
+      *log = strcat_alloc(*log, b);
+    }
     return -P3M_TUNE_ELCTEST;
   }
+  return 0;
+}
+
+/** get the optimal alpha and the corresponding computation time for fixed mesh, cao. The r_cut is determined via
+    a simple bisection. Returns -1 if the force evaluation does not work, -2 if there is no valid r_cut, and -3 if
+    the charge assigment order is to large for this grid */
+static double p3m_mc_time(char **log, int mesh[3], int cao,
+			  double r_cut_iL_min, double r_cut_iL_max, double *_r_cut_iL,
+			  double *_alpha_L, double *_accuracy)
+{
+  double int_time;
+  double r_cut_iL;
+  double rs_err, ks_err;
+  int i, n_cells, ret;
+  char b[5*ES_DOUBLE_SPACE + 3*ES_INTEGER_SPACE + 128];
+
+  ret = p3m_mc_r_cut(log, mesh, cao, r_cut_iL_min, r_cut_iL_max, _r_cut_iL,
+		     _alpha_L, _accuracy, &rs_err, &ks_err);
+  if (ret < 0)
+    return ret;
+  r_cut_iL = *_r_cut_iL;
 
   /* check whether this radius is too large, so that we would use less cells than allowed */
   n_cells = 1;
@@ -1436,8 +1466,6 @@ static double p3m_mc_time(char **log, int mesh[3], int cao,
     return -P3M_TUNE_FAIL;
   }
 
-  *_accuracy = p3m_get_accuracy(mesh, cao, r_cut_iL, _alpha_L, &rs_err, &ks_err);
-
   P3M_TRACE(fprintf(stderr, "p3m_mc_time: mesh (%d, %d, %d) cao %d r_cut %f time %f\n", mesh[0], mesh[1], mesh[2], cao, r_cut_iL, int_time));
   /* print result */
   sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e %-8d\n",
@@ -1580,6 +1608,9 @@ int p3m_adaptive_tune(char **log) {
   double mesh_density = 0.0, mesh_density_min, mesh_density_max;
   char b[3*ES_INTEGER_SPACE + 3*ES_DOUBLE_SPACE + 128];
   int tune_mesh = 0; //boolean to indicate if mesh should be tuned
+  double best_mesh_density = 0.0;
+  double cache_key[P3M_TUNE_CACHE_KEY], cache_res[P3M_TUNE_CACHE_RES];
+  int cached;
 
   if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
     if( !((box_l[0] == box_l[1]) &&
@@ -1603,6 +1634,33 @@ int p3m_adaptive_tune(char **log) {
     return ES_ERROR;
   }
 
+  /* key of the system in the tuning cache. The first
+     P3M_TUNE_CACHE_EXACT entries including the fixed parameters have to
+     match, the box and the charges are compared approximately. */
+  cache_key[0]  = node_grid[0];
+  cache_key[1]  = node_grid[1];
+  cache_key[2]  = node_grid[2];
+  cache_key[3]  = (coulomb.method == COULOMB_ELC_P3M || coulomb.method == COULOMB_P3M_GPU) ?
+    coulomb.method : COULOMB_P3M;
+  cache_key[4]  = coulomb.prefactor;
+  cache_key[5]  = p3m.params.accuracy;
+  cache_key[6]  = p3m.params.epsilon;
+  cache_key[7]  = skin;
+  if (p3m.params.mesh[0] == 0 || p3m.params.mesh[1] == 0 || p3m.params.mesh[2] == 0)
+    cache_key[8] = cache_key[9] = cache_key[10] = 0;
+  else {
+    cache_key[8]  = p3m.params.mesh[0];
+    cache_key[9]  = p3m.params.mesh[1];
+    cache_key[10] = p3m.params.mesh[2];
+  }
+  cache_key[11] = p3m.params.cao;
+  cache_key[12] = p3m.params.r_cut_iL;
+  cache_key[13] = box_l[0];
+  cache_key[14] = box_l[1];
+  cache_key[15] = box_l[2];
+  cache_key[16] = p3m.sum_qpart;
+  cache_key[17] = p3m.sum_q2;
+
   /* parameter ranges */
   /* if at least the number of meshpoints in one direction is not set, we have to tune it. */
   if (p3m.params.mesh[0] == 0 || p3m.params.mesh[1] == 0 || p3m.params.mesh[2] == 0) {
@@ -1657,6 +1715,35 @@ int p3m_adaptive_tune(char **log) {
     *log = strcat_alloc(*log, b);
   }
 
+  cached = tune_cache_lookup("p3m", cache_key, P3M_TUNE_CACHE_KEY, P3M_TUNE_CACHE_EXACT,
+			     cache_res, P3M_TUNE_CACHE_RES);
+  if (cached == TUNE_CACHE_HIT) {
+    sprintf(b, "using cached parameters from %.64s\n", tune_cache_file);
+    *log = strcat_alloc(*log, b);
+    mesh[0]   = (int)cache_res[0];
+    mesh[1]   = (int)cache_res[1];
+    mesh[2]   = (int)cache_res[2];
+    cao       = (int)cache_res[3];
+    r_cut_iL  = cache_res[4];
+    alpha_L   = cache_res[5];
+    accuracy  = cache_res[6];
+    time_best = cache_res[7];
+    /* skip the mesh loop */
+    mesh_density_min = mesh_density_max + 1;
+    /* the method is otherwise set by the timing in p3m_mcr_time */
+    coulomb.method = (CoulombMethod)(int)cache_key[3];
+  }
+  else if (cached == TUNE_CACHE_NEAREST) {
+    /* warm start: begin shortly below the mesh density and with the
+       cao that were optimal for the most similar cached system */
+    if (tune_mesh && cache_res[8] - 0.2 > mesh_density_min)
+      mesh_density_min = cache_res[8] - 0.2;
+    if (cao_min < cao_max)
+      cao = (int)cache_res[3];
+    sprintf(b, "warm start from cached parameters in %.64s\n", tune_cache_file);
+    *log = strcat_alloc(*log, b);
+  }
+
   *log = strcat_alloc(*log, "mesh cao r_cut_iL     alpha_L      err          rs_err     ks_err     time [ms]\n");
 
   /* mesh loop */
@@ -1710,6 +1797,7 @@ int p3m_adaptive_tune(char **log) {
       r_cut_iL  = tmp_r_cut_iL;
       alpha_L   = tmp_alpha_L;
       accuracy  = tmp_accuracy;
+      best_mesh_density = mesh_density;
     }
     /* no hope of further optimisation */
     else if (tmp_time > time_best + P3M_TIME_GRAN) {
@@ -1724,6 +1812,19 @@ int p3m_adaptive_tune(char **log) {
     return ES_ERROR;
   }
 
+  if (cached != TUNE_CACHE_HIT) {
+    cache_res[0] = mesh[0];
+    cache_res[1] = mesh[1];
+    cache_res[2] = mesh[2];
+    cache_res[3] = cao;
+    cache_res[4] = r_cut_iL;
+    cache_res[5] = alpha_L;
+    cache_res[6] = accuracy;
+    cache_res[7] = time_best;
+    cache_res[8] = best_mesh_density;
+    tune_cache_store("p3m", cache_key, P3M_TUNE_CACHE_KEY, cache_res, P3M_TUNE_CACHE_RES);
+  }
+
   /* set tuned p3m parameters */
   p3m.params.r_cut_iL = r_cut_iL;
   p3m.params.mesh[0]  = mesh[0];
@@ -1745,6 +1846,361 @@ int p3m_adaptive_tune(char **log) {
   *log = strcat_alloc(*log, b);
   return ES_OK;
 }
+
+/** number of terms of the P3M cost model: constant, pair distances,
+    FFT and charge assignment. */
+#define P3M_COST_TERMS 4
+/** maximal number of timings the P3M cost model is fitted to. */
+#define P3M_COST_SAMPLES 32
+
+/** parameter set considered by \ref p3m_model_tune. */
+typedef struct {
+  int mesh[3];
+  int cao;
+  double r_cut_iL, alpha_L, accuracy;
+  /** cost terms per node, see \ref p3m_model_tune. */
+  double terms[P3M_COST_TERMS];
+  /** modeled time in ms. */
+  double model;
+  /** measured time in ms, or -1 if not timed. */
+  double time;
+} p3m_tune_candidate;
+
+/** coefficients of the cost model in ms. The initial values are rough
+    estimates, which only select the parameter sets of the first
+    calibration. */
+static double p3m_cost_coeff[P3M_COST_TERMS] = { 0.0, 2e-5, 2e-5, 4e-5 };
+/** cost terms of the timings the model is fitted to. */
+static double p3m_cost_samples[P3M_COST_SAMPLES][P3M_COST_TERMS];
+/** measured times of the timings the model is fitted to. */
+static double p3m_cost_times[P3M_COST_SAMPLES];
+/** total number of timings, the oldest ones are overwritten. */
+static int p3m_n_cost_samples = 0;
+
+/** calculate the cost terms and the modeled time of a parameter set. */
+static void p3m_cost_model(p3m_tune_candidate *c)
+{
+  double r_cut = c->r_cut_iL*box_l[0] + skin;
+  double mesh_size = (double)c->mesh[0]*c->mesh[1]*c->mesh[2];
+  int i;
+
+  c->terms[0] = 1.0;
+  /* charged pairs within the cutoff plus skin */
+  c->terms[1] = 0.5*SQR((double)p3m.sum_qpart)/(box_l[0]*box_l[1]*box_l[2])
+    *4.0/3.0*PI*r_cut*r_cut*r_cut/n_nodes;
+  c->terms[2] = mesh_size*log(mesh_size)/M_LN2/n_nodes;
+  c->terms[3] = (double)p3m.sum_qpart*c->cao*c->cao*c->cao/n_nodes;
+
+  c->model = 0.0;
+  for (i = 0; i < P3M_COST_TERMS; i++)
+    c->model += p3m_cost_coeff[i]*c->terms[i];
+}
+
+/** fit the cost model coefficients to the timings by linear least
+    squares. Terms with negative coefficients are dropped one by one, and
+    if no term is left, the previous coefficients are only rescaled. */
+static void p3m_cost_fit()
+{
+  int n = imin(p3m_n_cost_samples, P3M_COST_SAMPLES);
+  int active[P3M_COST_TERMS], idx[P3M_COST_TERMS], perms[P3M_COST_TERMS];
+  double a_data[P3M_COST_TERMS*P3M_COST_TERMS], *a[P3M_COST_TERMS], x[P3M_COST_TERMS];
+  double model, num = 0.0, den = 0.0;
+  int i, j, k, n_act, worst;
+
+  for (i = 0; i < P3M_COST_TERMS; i++) {
+    active[i] = 1;
+    a[i] = a_data + i*P3M_COST_TERMS;
+  }
+
+  for (;;) {
+    n_act = 0;
+    for (i = 0; i < P3M_COST_TERMS; i++)
+      if (active[i])
+	idx[n_act++] = i;
+    if (n_act == 0 || n < n_act)
+      break;
+
+    /* normal equations of the active terms */
+    for (i = 0; i < n_act; i++) {
+      x[i] = 0.0;
+      for (j = 0; j < n_act; j++)
+	a[i][j] = 0.0;
+      for (k = 0; k < n; k++) {
+	x[i] += p3m_cost_samples[k][idx[i]]*p3m_cost_times[k];
+	for (j = 0; j < n_act; j++)
+	  a[i][j] += p3m_cost_samples[k][idx[i]]*p3m_cost_samples[k][idx[j]];
+      }
+    }
+    if (lu_decompose_matrix(a, n_act, perms) != 0)
+      break;
+    lu_solve_system(a, n_act, perms, x);
+
+    worst = -1;
+    for (i = 0; i < n_act; i++)
+      if (!(x[i] >= 0.0) && (worst == -1 || x[i] < x[worst]))
+	worst = i;
+    if (worst == -1) {
+      for (i = 0; i < P3M_COST_TERMS; i++)
+	p3m_cost_coeff[i] = 0.0;
+      for (i = 0; i < n_act; i++)
+	p3m_cost_coeff[idx[i]] = x[i];
+      return;
+    }
+    active[idx[worst]] = 0;
+  }
+
+  for (k = 0; k < n; k++) {
+    model = 0.0;
+    for (i = 0; i < P3M_COST_TERMS; i++)
+      model += p3m_cost_coeff[i]*p3m_cost_samples[k][i];
+    num += model*p3m_cost_times[k];
+    den += model*model;
+  }
+  if (den > 0.0)
+    for (i = 0; i < P3M_COST_TERMS; i++)
+      p3m_cost_coeff[i] *= num/den;
+}
+
+/** time a parameter set and add the timing to the samples of the cost
+    model. Returns the time, or -1 if the force evaluation failed. */
+static double p3m_cost_time(char **log, p3m_tune_candidate *c)
+{
+  char b[4*ES_DOUBLE_SPACE + 2*ES_INTEGER_SPACE + 128];
+  int k;
+
+  c->time = p3m_mcr_time(c->mesh, c->cao, c->r_cut_iL, c->alpha_L);
+  if (c->time < 0) {
+    *log = strcat_alloc(*log, "tuning failed, test integration not possible\n");
+    return -1;
+  }
+
+  k = p3m_n_cost_samples % P3M_COST_SAMPLES;
+  memcpy(p3m_cost_samples[k], c->terms, P3M_COST_TERMS*sizeof(double));
+  p3m_cost_times[k] = c->time;
+  p3m_n_cost_samples++;
+
+  sprintf(b, "%-4d %-3d %.5e %.5e %.5e %-10.3f %-10.3f\n",
+	  c->mesh[0], c->cao, c->r_cut_iL, c->alpha_L, c->accuracy, c->model, c->time);
+  *log = strcat_alloc(*log, b);
+  return c->time;
+}
+
+static int p3m_compare_candidates(const void *a, const void *b)
+{
+  double ma = ((const p3m_tune_candidate *)a)->model;
+  double mb = ((const p3m_tune_candidate *)b)->model;
+  return (ma > mb) - (ma < mb);
+}
+
+int p3m_model_tune(char **log, int n_confirm)
+{
+  p3m_tune_candidate *cand = NULL, *c, *best;
+  int n_cand = 0, max_cand = 0, i_best = -1;
+  int calib[2*P3M_COST_TERMS - 1], n_calib, lo, hi;
+  int mesh[3], fixed_mesh[3], mesh_min, mesh_max, m, cao, cao_min, cao_max, i, j, t;
+  int tune_mesh = 0;
+  double r_cut_iL_min, r_cut_iL_max, rs_err, ks_err, mesh_density;
+  char b[4*ES_DOUBLE_SPACE + 3*ES_INTEGER_SPACE + 128];
+
+  if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
+    if( !((box_l[0] == box_l[1]) &&
+	  (box_l[1] == box_l[2]))) {
+      *log = strcat_alloc(*log, "{049 P3M_init: Nonmetallic epsilon requires cubic box} ");
+      return ES_ERROR;
+    }
+  }
+
+  /* preparation */
+  mpi_bcast_event(P3M_COUNT_CHARGES);
+  /* Print Status */
+  sprintf(b, "P3M tune parameters using the cost model: Accuracy goal = %.5e\n", p3m.params.accuracy);
+  *log = strcat_alloc(*log, b);
+  sprintf(b, "System: box_l = %.5e # charged part = %d Sum[q_i^2] = %.5e\n",
+	  box_l[0], p3m.sum_qpart, p3m.sum_q2);
+  *log = strcat_alloc(*log, b);
+
+  if (p3m.sum_qpart == 0) {
+    *log = strcat_alloc(*log, "no charged particles in the system, cannot tune P3M");
+    return ES_ERROR;
+  }
+
+  /* parameter ranges, as in p3m_adaptive_tune */
+  if (p3m.params.mesh[0] == 0 || p3m.params.mesh[1] == 0 || p3m.params.mesh[2] == 0) {
+    mesh_density = pow(p3m.sum_qpart / (box_l[0] * box_l[1] * box_l[2]) , 1.0/3.0);
+    mesh_min = (int)(box_l[0]*mesh_density + 0.5);
+    mesh_max = (int)(box_l[0]*256 / pow(box_l[0] * box_l[1] * box_l[2], 1.0/3.0) + 0.5);
+    tune_mesh = 1;
+  } else {
+    if ( p3m.params.mesh[1] == -1 && p3m.params.mesh[2] == -1) {
+      mesh_density = p3m.params.mesh[0] / box_l[0];
+      p3m.params.mesh[1] = mesh_density*box_l[1]+0.5;
+      p3m.params.mesh[2] = mesh_density*box_l[2]+0.5;
+      if ( p3m.params.mesh[1]%2 == 1 ) p3m.params.mesh[1]++; //Make sure that the mesh is even in all directions
+      if ( p3m.params.mesh[2]%2 == 1 ) p3m.params.mesh[2]++;
+    }
+    /* as in p3m_adaptive_tune, make sure that the mesh is even in
+       all directions */
+    for (i = 0; i < 3; i++) {
+      fixed_mesh[i] = p3m.params.mesh[i];
+      if (fixed_mesh[i] % 2)
+	fixed_mesh[i]++;
+    }
+    mesh_min = mesh_max = fixed_mesh[0];
+
+    sprintf(b, "fixed mesh %d %d %d\n", fixed_mesh[0], fixed_mesh[1], fixed_mesh[2]);
+    *log = strcat_alloc(*log, b);
+  }
+
+  if(p3m.params.r_cut_iL == 0.0) {
+    r_cut_iL_min = 0;
+    r_cut_iL_max = dmin(min_local_box_l, min_box_l/2.0) - skin;
+    r_cut_iL_min *= box_l_i[0];
+    r_cut_iL_max *= box_l_i[0];
+  }
+  else {
+    r_cut_iL_min = r_cut_iL_max = p3m.params.r_cut_iL;
+
+    sprintf(b, "fixed r_cut_iL %f\n", p3m.params.r_cut_iL);
+    *log = strcat_alloc(*log, b);
+  }
+
+  if(p3m.params.cao == 0) {
+    cao_min = 1;
+    cao_max = 7;
+  }
+  else {
+    cao_min = cao_max = p3m.params.cao;
+
+    sprintf(b, "fixed cao %d\n", p3m.params.cao);
+    *log = strcat_alloc(*log, b);
+  }
+
+  /* all parameter sets that reach the accuracy, with the smallest
+     cutoff for each mesh and cao */
+  p3m_cost_fit();
+  for (m = mesh_min + mesh_min%2; m <= mesh_max; m += 2) {
+    if (tune_mesh) {
+      mesh[0] = m;
+      for (i = 1; i < 3; i++) {
+	mesh[i] = (int)(m*box_l[i]/box_l[0] + 0.5);
+	if (mesh[i] % 2)
+	  mesh[i]++;
+      }
+    }
+    else {
+      mesh[0] = fixed_mesh[0];
+      mesh[1] = fixed_mesh[1];
+      mesh[2] = fixed_mesh[2];
+    }
+
+    for (cao = cao_min; cao <= cao_max; cao++) {
+      if (n_cand == max_cand) {
+	max_cand += 64;
+	cand = (p3m_tune_candidate *)Utils::realloc(cand, max_cand*sizeof(p3m_tune_candidate));
+      }
+      c = cand + n_cand;
+      for (i = 0; i < 3; i++)
+	c->mesh[i] = mesh[i];
+      c->cao = cao;
+      c->time = -1;
+
+      /* the mesh and assignment costs alone are too high, and they
+	 only grow for larger meshes and cao. The margin covers the
+	 rough default coefficients before the calibration. */
+      c->r_cut_iL = 0.0;
+      p3m_cost_model(c);
+      if (i_best >= 0 && c->model > 4*cand[i_best].model)
+	break;
+
+      if (p3m_mc_r_cut(NULL, mesh, cao, r_cut_iL_min, r_cut_iL_max, &c->r_cut_iL,
+		       &c->alpha_L, &c->accuracy, &rs_err, &ks_err) < 0)
+	continue;
+      p3m_cost_model(c);
+      if (i_best < 0 || c->model < cand[i_best].model)
+	i_best = n_cand;
+      n_cand++;
+    }
+    /* not even the smallest cao is fast enough */
+    if (cao == cao_min && i_best >= 0)
+      break;
+  }
+
+  if (n_cand == 0) {
+    *log = strcat_alloc(*log, "failed to tune P3M parameters to required accuracy\n");
+    free(cand);
+    return ES_ERROR;
+  }
+  sprintf(b, "%d parameter sets reach the accuracy\n", n_cand);
+  *log = strcat_alloc(*log, b);
+  *log = strcat_alloc(*log, "mesh cao r_cut_iL     alpha_L      err          model [ms] time [ms]\n");
+
+  /* calibration: without enough timings for a fit, time the best
+     parameter set and the ones with the extreme cost terms */
+  if (p3m_n_cost_samples < P3M_COST_TERMS) {
+    n_calib = 0;
+    calib[n_calib++] = i_best;
+    for (t = 1; t < P3M_COST_TERMS; t++) {
+      lo = hi = 0;
+      for (i = 1; i < n_cand; i++) {
+	if (cand[i].terms[t] < cand[lo].terms[t]) lo = i;
+	if (cand[i].terms[t] > cand[hi].terms[t]) hi = i;
+      }
+      calib[n_calib++] = lo;
+      calib[n_calib++] = hi;
+    }
+    for (i = 0; i < n_calib; i++) {
+      c = cand + calib[i];
+      if (c->time < 0 && p3m_cost_time(log, c) < 0) {
+	free(cand);
+	return ES_ERROR;
+      }
+    }
+    p3m_cost_fit();
+    for (i = 0; i < n_cand; i++)
+      p3m_cost_model(cand + i);
+  }
+
+  sprintf(b, "cost model [ms]: %.3e + %.3e pairs + %.3e mesh log2(mesh) + %.3e charges cao^3\n",
+	  p3m_cost_coeff[0], p3m_cost_coeff[1], p3m_cost_coeff[2], p3m_cost_coeff[3]);
+  *log = strcat_alloc(*log, b);
+
+  /* confirm the best parameter sets of the model */
+  qsort(cand, n_cand, sizeof(p3m_tune_candidate), p3m_compare_candidates);
+  for (i = 0; i < n_confirm && i < n_cand; i++) {
+    if (cand[i].time < 0 && p3m_cost_time(log, cand + i) < 0) {
+      free(cand);
+      return ES_ERROR;
+    }
+  }
+
+  /* the fastest timed parameter set, or without confirmation the best
+     of the model */
+  best = cand;
+  if (n_confirm > 0)
+    for (j = 0; j < n_cand; j++)
+      if (cand[j].time >= 0 && (best->time < 0 || cand[j].time < best->time))
+	best = cand + j;
+
+  /* set tuned p3m parameters */
+  p3m.params.r_cut_iL = best->r_cut_iL;
+  p3m.params.mesh[0]  = best->mesh[0];
+  p3m.params.mesh[1]  = best->mesh[1];
+  p3m.params.mesh[2]  = best->mesh[2];
+  p3m.params.cao      = best->cao;
+  p3m.params.alpha_L  = best->alpha_L;
+  p3m.params.accuracy = best->accuracy;
+  p3m_scaleby_box_l();
+  /* broadcast tuned p3m parameters */
+  mpi_bcast_coulomb_params();
+
+  /* Tell the user about the outcome */
+  sprintf(b, "\nresulting parameters:\n%-4d %-3d %.5e %.5e %.5e %-8d\n",
+	  best->mesh[0], best->cao, best->r_cut_iL, best->alpha_L, best->accuracy,
+	  (int)(best->time >= 0 ? best->time : best->model));
+  *log = strcat_alloc(*log, b);
+  free(cand);
+  return ES_OK;
+}
   
 void p3m_count_charged_particles()
 {  
@@ -127,6 +127,26 @@ void p3m_set_bjerrum(void);
 
 int p3m_adaptive_tune(char **log);
 
+/** Tune P3M parameters to the desired accuracy using a cost model
+    instead of timing every parameter set as \ref p3m_adaptive_tune does.
+
+    For all meshes and charge assignment orders, the smallest real space
+    cutoff reaching the accuracy is determined from the error estimates.
+    The time of a force calculation is modeled per node as a linear
+    combination of the number of pair distances within the cutoff, the
+    FFT costs \f$M \log_2 M\f$ of the mesh size \f$M\f$, and the number of
+    charge assignment points \f$N_q\,\mathrm{cao}^3\f$. The coefficients
+    are fitted to all force calculations timed by this function in the
+    running simulation, so that only the first call times a few widely
+    spread parameter sets for the calibration. Finally, the n_confirm best
+    parameter sets of the model are timed and the fastest one is used.
+
+    @param log       log of the tuning, appended to.
+    @param n_confirm number of parameter sets confirmed by a timing.
+    @return ES_OK on success, ES_ERROR otherwise.
+*/
+int p3m_model_tune(char **log, int n_confirm);
+
 /** Initialize all structures, parameters and arrays needed for the 
  *  P3M algorithm for charge-charge interactions.
  */
@@ -136,7 +156,11 @@ void p3m_init(void);
     \ref p3m_parameter_struct::r_cut if \ref box_l changed. */
 void p3m_scaleby_box_l();
 
-/** compute the k-space part of forces and energies for the charge-charge interaction  **/
+/** compute the k-space part of forces and energies for the charge-charge interaction.
+    @param force_flag  if nonzero, the forces are added to the particles,
+                       multiplied by force_flag (see \ref kspace_interval)
+    @param energy_flag if nonzero, the k-space energy is calculated and returned
+**/
 double p3m_calc_kspace_forces(int force_flag, int energy_flag);
 
 /** computer the k-space part of the stress tensor **/
@@ -208,36 +232,51 @@ void p3m_assign_charge(double q,
 /** shrink wrap the charge grid */
 void p3m_shrink_wrap_charge_grid(int n_charges);
 
-/** Calculate real space contribution of coulomb pair forces.
-    If NPT is compiled in, it returns the energy, which is needed for NPT. */
-inline double p3m_add_pair_force(double chgfac, double *d,double dist2,double dist,double force[3])
+/** Prefactor of the real space contribution of the coulomb pair
+    force, i.e. the force is this times the distance vector. The
+    energy needed for NPT is returned in eng. */
+inline double p3m_pair_force_factor(double chgfac, double dist2, double dist, double *eng)
 {
-  int j;
-  double fac1,fac2, adist, erfc_part_ri;
+  double fac1, adist, erfc_part_ri;
+  *eng = 0.0;
   if(dist < p3m.params.r_cut) {
     if (dist > 0.0){		//Vincent
       adist = p3m.params.alpha * dist;
 #if USE_ERFC_APPROXIMATION
       erfc_part_ri = AS_erfc_part(adist) / dist;
       fac1 = coulomb.prefactor * chgfac  * exp(-adist*adist);
-      fac2 = fac1 * (erfc_part_ri + 2.0*p3m.params.alpha*wupii) / dist2;
+      *eng = fac1 * erfc_part_ri;
+      return fac1 * (erfc_part_ri + 2.0*p3m.params.alpha*wupii) / dist2;
 #else
       erfc_part_ri = erfc(adist) / dist;
       fac1 = coulomb.prefactor * chgfac;
-      fac2 = fac1 * (erfc_part_ri + 2.0*p3m.params.alpha*wupii*exp(-adist*adist)) / dist2;
-#endif
-      for(j=0;j<3;j++)
-	force[j] += fac2 * d[j];
-      ESR_TRACE(fprintf(stderr,"%d: RSE: Pair dist=%.3f: force (%.3e,%.3e,%.3e)\n",this_node,
-			dist,fac2*d[0],fac2*d[1],fac2*d[2]));
-#ifdef NPT
-      return fac1 * erfc_part_ri;
+      *eng = fac1 * erfc_part_ri;
+      return fac1 * (erfc_part_ri + 2.0*p3m.params.alpha*wupii*exp(-adist*adist)) / dist2;
 #endif
     }
   }
   return 0.0;
 }
 
+/** Calculate real space contribution of coulomb pair forces.
+    If NPT is compiled in, it returns the energy, which is needed for NPT. */
+inline double p3m_add_pair_force(double chgfac, double *d,double dist2,double dist,double force[3])
+{
+  int j;
+  double eng;
+  double fac2 = p3m_pair_force_factor(chgfac, dist2, dist, &eng);
+  if (fac2 != 0.0) {
+    for(j=0;j<3;j++)
+      force[j] += fac2 * d[j];
+    ESR_TRACE(fprintf(stderr,"%d: RSE: Pair dist=%.3f: force (%.3e,%.3e,%.3e)\n",this_node,
+		      dist,fac2*d[0],fac2*d[1],fac2*d[2]));
+  }
+#ifdef NPT
+  return eng;
+#endif
+  return 0.0;
+}
+
 void p3m_set_tune_params(double r_cut, int mesh[3], int cao,
 			 double alpha, double accuracy, int n_interpol);
 
@@ -250,6 +289,16 @@ int p3m_set_eps(double eps);
 
 int p3m_set_ninterpol(int n);
 
+/** Select whether the charge assignment fractions are stored between
+    the charge assignment and the force interpolation, or recomputed.
+    Recomputing saves cao^3 doubles per charge.
+    \param store 1 to store, 0 to recompute. */
+int p3m_set_store_ca_frac(int store);
+
+/** Select the communication scheme of the parallel FFT.
+    \param comm \ref FFT_COMM_SENDRECV or \ref FFT_COMM_NONBLOCKING. */
+int p3m_set_fft_comm(int comm);
+
 
 /** Calculate real space contribution of coulomb pair energy. */
 inline double p3m_pair_energy(double chgfac, double *d,double dist2,double dist)
@@ -31,6 +31,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <vector>
 #include <mpi.h>
 #include "utils.hpp"
 #include "particle_data.hpp"
@@ -611,6 +612,114 @@ int place_particle(int part, double p[3])
   return retcode;
 }
 
+int particles_property_size(int property)
+{
+  switch (property) {
+  case PART_PROP_POS:
+  case PART_PROP_V:
+  case PART_PROP_F:
+    return 3;
+#ifdef ELECTROSTATICS
+  case PART_PROP_Q:
+    return 1;
+#endif
+  case PART_PROP_TYPE:
+    return 1;
+#ifdef MASS
+  case PART_PROP_MASS:
+    return 1;
+#endif
+  }
+  return 0;
+}
+
+int set_particles_property(int property, int n, const int *ids, const double *values)
+{
+  int i, max_new = max_seen_particle;
+  std::vector<int> enc_ids(n + 1), pnodes(n + 1);
+
+  if (particles_property_size(property) == 0 || n < 0)
+    return ES_ERROR;
+
+  if (!particle_node)
+    build_particle_node();
+
+  /* check everything before changing anything */
+  for (i = 0; i < n; i++) {
+    if (ids[i] < 0)
+      return ES_ERROR;
+    if (property != PART_PROP_POS &&
+        (ids[i] > max_seen_particle || particle_node[ids[i]] == -1))
+      return ES_ERROR;
+    if (ids[i] > max_new)
+      max_new = ids[i];
+  }
+
+  if (property == PART_PROP_TYPE) {
+    for (i = 0; i < n; i++)
+      make_particle_type_exist((int)values[i]);
+    /* the type lists need the old type of each particle */
+    if (Type_array_init) {
+      for (i = 0; i < n; i++)
+        set_particle_type(ids[i], (int)values[i]);
+      return ES_OK;
+    }
+  }
+
+  if (property == PART_PROP_POS) {
+    realloc_particle_node(max_new);
+    for (i = max_seen_particle + 1; i <= max_new; i++)
+      particle_node[i] = -1;
+  }
+
+  for (i = 0; i < n; i++) {
+    int part = ids[i];
+    if (particle_node[part] == -1) {
+      /* new particle, node by spatial position */
+      pnodes[i] = particle_node[part] = cell_structure.position_to_node((double *)values + 3*i);
+      enc_ids[i] = -part - 1;
+    }
+    else {
+      pnodes[i] = particle_node[part];
+      enc_ids[i] = part;
+    }
+  }
+
+  mpi_send_particles_property(property, n, &enc_ids[0], &pnodes[0], (double *)values);
+  return ES_OK;
+}
+
+int get_particles_properties(int n_props, const int *props, int n, const int *ids, double *values)
+{
+  std::vector<int> all_ids;
+
+  if (n_props <= 0 || n < 0)
+    return ES_ERROR;
+  for (int k = 0; k < n_props; k++)
+    if (particles_property_size(props[k]) == 0)
+      return ES_ERROR;
+
+  if (!particle_node)
+    build_particle_node();
+
+  if (ids) {
+    for (int i = 0; i < n; i++)
+      if (ids[i] < 0 || ids[i] > max_seen_particle || particle_node[ids[i]] == -1)
+        return ES_ERROR;
+  }
+  else {
+    if (n != n_part)
+      return ES_ERROR;
+    for (int i = 0; i <= max_seen_particle; i++)
+      if (particle_node[i] != -1)
+        all_ids.push_back(i);
+  }
+
+  if (n > 0)
+    mpi_get_particles_properties(n_props, props, n, ids ? ids : &all_ids[0], ids == NULL, values);
+  return ES_OK;
+}
+
 int set_particle_v(int part, double v[3])
 {
   int pnode;
@@ -1388,17 +1497,22 @@ void local_rescale_particles(int dir, double scale) {
 
 
 void added_particle(int part)
+{
+  added_particles(1, part);
+}
+
+void added_particles(int n, int max_part)
 {
   int i;
 
-  n_part++;
+  n_part += n;
 
-  if (part > max_seen_particle) {
-    realloc_local_particles(part);
+  if (max_part > max_seen_particle) {
+    realloc_local_particles(max_part);
     /* fill up possible gap. Part itself is ESSENTIAL!!!  */
-    for (i = max_seen_particle + 1; i <= part; i++)
+    for (i = max_seen_particle + 1; i <= max_part; i++)
       local_particles[i] = NULL;
-    max_seen_particle = part;
+    max_seen_particle = max_part;
   }
 }
 
@@ -39,6 +39,24 @@
 /// ok code for \ref place_particle, particle is new
 #define ES_PART_CREATED 1
 
+/** \name Particle properties for \ref set_particles_property */
+/*@{*/
+/// position, 3 values. Particles that do not exist are created.
+#define PART_PROP_POS  0
+/// velocity, 3 values
+#define PART_PROP_V    1
+/// force, 3 values
+#define PART_PROP_F    2
+/// charge, 1 value, requires ELECTROSTATICS
+#define PART_PROP_Q    3
+/// type, 1 value
+#define PART_PROP_TYPE 4
+/// mass, 1 value, requires MASS
+#define PART_PROP_MASS 5
+/// number of bulk properties
+#define PART_PROP_NUM  6
+/*@}*/
+
 /**  bonds_flag "bonds_flag" value for updating particle config without bonding information */
 #define WITHOUT_BONDS 0
 /**  bonds_flag "bonds_flag" value for updating particle config with bonding information */
@@ -501,6 +519,44 @@ int get_particle_data(int part, Particle *data);
 */
 int place_particle(int part, double p[3]);
 
+/** Number of values per particle of a property for \ref
+    set_particles_property, 0 if the property is not compiled in. */
+int particles_property_size(int property);
+
+/** Call only on the master node: set a property of many particles at
+    once. The values are sorted by the nodes owning the particles and
+    delivered in one collective operation, instead of one message per
+    particle as with \ref set_particle_v and friends.
+    @param property one of the PART_PROP_ constants.
+    @param n        number of particles.
+    @param ids      the identities of the particles.
+    @param values   \ref particles_property_size values per particle.
+    @return ES_OK, or ES_ERROR if the property is not available or a
+    particle does not exist (except for \ref PART_PROP_POS, which
+    creates particles). Nothing is changed in case of an error.
+*/
+int set_particles_property(int property, int n, const int *ids, const double *values);
+
+/** Call only on the master node: get properties of many particles at
+    once. Only the requested properties are sent to the master, packed
+    per particle, instead of the complete particle data as for \ref
+    partCfg. Positions and velocities are unfolded as in \ref
+    updatePartCfg, velocities and forces are in internal units as for
+    \ref set_particles_property.
+    @param n_props number of properties.
+    @param props   the properties, PART_PROP_ constants.
+    @param n       number of particles.
+    @param ids     the identities of the particles, or NULL for all
+                   particles in the order of their identities. Then,
+                   \a n has to be \ref n_part.
+    @param values  the values of the properties in the order of \a
+                   props, \ref particles_property_size values each,
+                   particle after particle.
+    @return ES_OK, or ES_ERROR if a property is not available or a
+    particle does not exist.
+*/
+int get_particles_properties(int n_props, const int *props, int n, const int *ids, double *values);
+
 /** Call only on the master node: set particle velocity.
     @param part the particle.
     @param v its new velocity.
@@ -809,6 +865,13 @@ void local_place_particle(int part, double p[3], int _new);
 */
 void added_particle(int part);
 
+/** Used by \ref mpi_send_particles_property, should not be used
+    elsewhere. Like \ref added_particle for \a n particles at once.
+    @param n        the number of particles added
+    @param max_part the highest identity of the added particles
+*/
+void added_particles(int n, int max_part);
+
 /** Used by \ref mpi_send_bond, should not be used elsewhere.
     Modify a bond.
     @param part the identity of the particle to change
@@ -0,0 +1,716 @@
+/*
+  Copyright (C) 2010,2012,2013,2014 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** \file particle_soa.cpp
+ *
+ *  Implementation of \ref particle_soa.hpp "particle_soa.h".
+ */
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "utils.hpp"
+#include "particle_soa.hpp"
+#include "cells.hpp"
+#include "domain_decomposition.hpp"
+#include "integrate.hpp"
+#include "interaction_data.hpp"
+#include "thermostat.hpp"
+#include "forces.hpp"
+#include "forces_inline.hpp"
+#include "constraint.hpp"
+#include "external_potential.hpp"
+#include "p3m.hpp"
+#include "npt.hpp"
+#include "reaction.hpp"
+#include "verlet.hpp"
+
+/** granularity of the SoA array allocation. */
+#define SOA_INCREMENT 8
+/** number of pairs the list build and the force loop handle at once. */
+#define SOA_BATCH 32
+
+/** Lennard-Jones parameters of one type pair as used by the SoA
+    kernel, see \ref add_lj_pair_force. */
+typedef struct {
+  /** outer cutoff, LJ_cut + LJ_offset. */
+  double cut;
+  /** inner cutoff, LJ_min + LJ_offset. */
+  double min;
+  double offset;
+  double capradius;
+  double eps;
+  double sig;
+  /** squares of cut and sig, for \ref soa_lj_plain. */
+  double cut2;
+  double sig2;
+} SoA_LJ_Parameters;
+
+CellSoA soa_all = { { NULL, NULL, NULL }, { NULL, NULL, NULL }, NULL,
+#ifdef ELECTROSTATICS
+                     NULL,
+#endif
+#ifdef EXCLUSIONS
+                     NULL,
+#endif
+                     0, 0, 0 };
+CellSoA *cell_soa = NULL;
+int n_cell_soa = 0;
+int soa_kernel_active = 0;
+
+/** LJ parameter table, n_particle_types^2 entries. */
+static SoA_LJ_Parameters *soa_lj = NULL;
+/** number of particle types in \ref soa_lj. */
+static int soa_lj_n_types = 0;
+/** all type pairs have plain LJ without offset, capping or inner
+    cutoff and there are no charges, so that the force loop can work
+    on squared distances only. */
+static int soa_lj_plain = 0;
+/** squared list cutoffs of the type pairs, max_cut + skin with
+    verlet lists, otherwise max_cut. Same layout as \ref soa_lj. */
+static double *soa_cut2 = NULL;
+
+/** pair lists of the local cells, same indexing as \ref local_cells. */
+static SoA_PairList *soa_pair_lists = NULL;
+static int n_soa_pair_lists = 0;
+/** the mirror was refilled, so the indices in \ref soa_pair_lists
+    are no longer valid. */
+static int soa_rebuild_lists = 1;
+
+/** number of threads for the pair loops, fixed in \ref
+    soa_on_integration_start. */
+static int soa_n_threads = 1;
+/** force buffers of the threads 1...soa_n_threads-1, three
+    coordinates with soa_all.n entries each per thread. Thread 0 works
+    on soa_all.f directly. */
+static double *soa_thread_f = NULL;
+static int soa_thread_f_size = 0;
+/** virial contributions of the threads for NPT, 3 per thread. */
+static double *soa_thread_vir = NULL;
+
+/************************************************************/
+
+static void realloc_cell_soa(CellSoA *s, int size)
+{
+  int j;
+
+  if (size <= s->max && size > 0)
+    return;
+
+  s->max = SOA_INCREMENT*((size + SOA_INCREMENT - 1)/SOA_INCREMENT);
+  for (j = 0; j < 3; j++) {
+    s->r[j] = (double *) Utils::realloc(s->r[j], sizeof(double)*s->max);
+    s->f[j] = (double *) Utils::realloc(s->f[j], sizeof(double)*s->max);
+  }
+  s->type = (int *) Utils::realloc(s->type, sizeof(int)*s->max);
+#ifdef ELECTROSTATICS
+  s->q = (double *) Utils::realloc(s->q, sizeof(double)*s->max);
+#endif
+#ifdef EXCLUSIONS
+  s->has_excl = (int *) Utils::realloc(s->has_excl, sizeof(int)*s->max);
+#endif
+}
+
+/** let s point to the np particles of \ref soa_all starting at offset. */
+static void set_cell_soa(CellSoA *s, int offset, int np)
+{
+  int j;
+
+  for (j = 0; j < 3; j++) {
+    s->r[j] = soa_all.r[j] + offset;
+    s->f[j] = soa_all.f[j] + offset;
+  }
+  s->type = soa_all.type + offset;
+#ifdef ELECTROSTATICS
+  s->q = soa_all.q + offset;
+#endif
+#ifdef EXCLUSIONS
+  s->has_excl = soa_all.has_excl + offset;
+#endif
+  s->offset = offset;
+  s->n = np;
+  s->max = np;
+}
+
+/** resize \ref cell_soa to the current number of cells. */
+static void realloc_soa_cells()
+{
+  if (n_cell_soa == n_cells)
+    return;
+
+  cell_soa = (CellSoA *) Utils::realloc(cell_soa, sizeof(CellSoA)*n_cells);
+  n_cell_soa = n_cells;
+}
+
+static void pack_cell(Cell *cell, CellSoA *s)
+{
+  Particle *part = cell->part;
+  int i, np = cell->n;
+
+  for (i = 0; i < np; i++) {
+    s->r[0][i] = part[i].r.p[0];
+    s->r[1][i] = part[i].r.p[1];
+    s->r[2][i] = part[i].r.p[2];
+    s->type[i] = part[i].p.type;
+#ifdef ELECTROSTATICS
+    s->q[i] = part[i].p.q;
+#endif
+#ifdef EXCLUSIONS
+    s->has_excl[i] = (part[i].el.n > 0);
+#endif
+  }
+}
+
+static void pack_cell_positions(Cell *cell, CellSoA *s)
+{
+  Particle *part = cell->part;
+  int i, np = cell->n;
+
+  for (i = 0; i < np; i++) {
+    s->r[0][i] = part[i].r.p[0];
+    s->r[1][i] = part[i].r.p[1];
+    s->r[2][i] = part[i].r.p[2];
+  }
+}
+
+void soa_update_cells(int what)
+{
+  int c, np;
+
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC || !dd.use_soa)
+    return;
+
+  CELL_TRACE(fprintf(stderr, "%d: soa_update_cells %d\n", this_node, what));
+
+  if (what == SOA_UPDATE_POS && n_cell_soa == n_cells) {
+    for (c = 0; c < n_cells; c++)
+      if (cell_soa[c].n != cells[c].n)
+        break;
+    if (c == n_cells) {
+      for (c = 0; c < n_cells; c++)
+        pack_cell_positions(&cells[c], &cell_soa[c]);
+      return;
+    }
+  }
+
+  realloc_soa_cells();
+  np = 0;
+  for (c = 0; c < n_cells; c++)
+    np += cells[c].n;
+  realloc_cell_soa(&soa_all, np);
+  soa_all.n = np;
+
+  np = 0;
+  for (c = 0; c < n_cells; c++) {
+    set_cell_soa(&cell_soa[c], np, cells[c].n);
+    pack_cell(&cells[c], &cell_soa[c]);
+    np += cells[c].n;
+  }
+  soa_rebuild_lists = 1;
+}
+
+/************************************************************/
+
+int soa_kernel_applicable()
+{
+  int i, j;
+
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC || !dd.use_soa)
+    return 0;
+
+  /* features that hook into the pair loop itself */
+#if defined(LEES_EDWARDS) || defined(MOL_CUT) || defined(NO_INTRA_NB) || \
+  defined(SHANCHEN) || defined(LJ_WARN_WHEN_CLOSE) || defined(CONFIGTEMP)
+  return 0;
+#endif
+
+#ifdef DPD
+  if (thermo_switch & (THERMO_DPD | THERMO_INTER_DPD))
+    return 0;
+#endif
+
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode > 0)
+    return 0;
+#endif
+
+#ifdef CATALYTIC_REACTIONS
+  /* integrate_reaction walks the normal verlet lists */
+  if (reaction.ct_rate > 0.0)
+    return 0;
+#endif
+
+#ifdef MULTI_TIMESTEP
+  if (smaller_time_step > 0.)
+    return 0;
+#endif
+
+#ifdef ELECTROSTATICS
+  switch (coulomb.method) {
+  case COULOMB_NONE:
+#ifdef P3M
+  case COULOMB_P3M:
+  case COULOMB_P3M_GPU:
+#endif
+    break;
+  default:
+    return 0;
+  }
+#endif
+
+#ifdef DIPOLES
+  if (coulomb.Dmethod != DIPOLAR_NONE)
+    return 0;
+#endif
+
+  for (i = 0; i < n_particle_types; i++)
+    for (j = i; j < n_particle_types; j++)
+      if (get_ia_param(i, j)->potentials & ~NONBONDED_LJ)
+        return 0;
+
+  return 1;
+}
+
+void soa_on_integration_start()
+{
+  int i, j;
+
+  soa_kernel_active = soa_kernel_applicable();
+
+  if (!soa_kernel_active)
+    return;
+
+#ifdef _OPENMP
+  soa_n_threads = omp_get_max_threads();
+#endif
+  soa_thread_vir = (double *) Utils::realloc(soa_thread_vir, 3*sizeof(double)*soa_n_threads);
+
+  if (soa_lj_n_types != n_particle_types) {
+    soa_lj_n_types = n_particle_types;
+    soa_lj = (SoA_LJ_Parameters *)
+      Utils::realloc(soa_lj, sizeof(SoA_LJ_Parameters)*n_particle_types*n_particle_types);
+    soa_cut2 = (double *)
+      Utils::realloc(soa_cut2, sizeof(double)*n_particle_types*n_particle_types);
+  }
+
+  soa_lj_plain = 1;
+#ifdef ELECTROSTATICS
+  if (coulomb.method != COULOMB_NONE)
+    soa_lj_plain = 0;
+#endif
+
+  for (i = 0; i < n_particle_types; i++)
+    for (j = 0; j < n_particle_types; j++) {
+      SoA_LJ_Parameters *lj = &soa_lj[i*n_particle_types + j];
+      IA_parameters *ia = get_ia_param(i, j);
+      soa_cut2[i*n_particle_types + j] = (ia->max_cut > 0.0) ?
+        SQR(ia->max_cut + (dd.use_vList ? skin : 0.0)) : -1.0;
+#ifdef LENNARD_JONES
+      lj->cut       = ia->LJ_cut + ia->LJ_offset;
+      lj->min       = ia->LJ_min + ia->LJ_offset;
+      lj->offset    = ia->LJ_offset;
+      lj->capradius = ia->LJ_capradius;
+      lj->eps       = ia->LJ_eps;
+      lj->sig       = ia->LJ_sig;
+      lj->cut2      = (lj->cut > 0.0) ? SQR(lj->cut) : 0.0;
+      lj->sig2      = SQR(lj->sig);
+      if (lj->cut > 0.0 && (lj->offset != 0.0 || lj->capradius > 0.0 || lj->min > 0.0))
+        soa_lj_plain = 0;
+#else
+      memset(lj, 0, sizeof(SoA_LJ_Parameters));
+#endif
+    }
+
+  /* the mirror may be stale if the cell system was set up before */
+  soa_update_cells(SOA_UPDATE_ALL);
+}
+
+/************************************************************/
+
+/** LJ force prefactor of a pair at distance dist > 0, i.e. the force
+    is this times the distance vector. Identical to \ref
+    add_lj_pair_force. */
+static inline double soa_lj_pair_factor(const SoA_LJ_Parameters *lj, double dist)
+{
+  double r_off, frac2, frac6;
+
+  if (dist < lj->cut && dist > lj->min) {
+    r_off = dist - lj->offset;
+    if (r_off > lj->capradius) {
+      frac2 = SQR(lj->sig/r_off);
+      frac6 = frac2*frac2*frac2;
+      return 48.0 * lj->eps * frac6*(frac6 - 0.5) / (r_off * dist);
+    }
+    frac2 = SQR(lj->sig/lj->capradius);
+    frac6 = frac2*frac2*frac2;
+    return 48.0 * lj->eps * frac6*(frac6 - 0.5) / (lj->capradius * dist);
+  }
+  return 0.0;
+}
+
+/** LJ force of two particles at the same position, which \ref
+    add_lj_pair_force pushes apart along the x axis. i and j index
+    \ref soa_all, f is the force buffer of the thread. */
+static void soa_lj_overlap_force(const SoA_LJ_Parameters *lj, int i, int j,
+                                 double *f[3])
+{
+  double frac2, frac6, fac;
+
+  if (0.0 < lj->cut && 0.0 > lj->min && -lj->offset <= lj->capradius) {
+    frac2 = SQR(lj->sig/lj->capradius);
+    frac6 = frac2*frac2*frac2;
+    fac   = 48.0 * lj->eps * frac6*(frac6 - 0.5) / lj->capradius;
+    f[0][i] += fac * lj->capradius;
+    f[0][j] -= fac * lj->capradius;
+  }
+}
+
+/** Resize \ref soa_pair_lists to the current local cells. */
+static void realloc_soa_pair_lists()
+{
+  int c;
+
+  if (n_soa_pair_lists == local_cells.n)
+    return;
+
+  for (c = local_cells.n; c < n_soa_pair_lists; c++) {
+    free(soa_pair_lists[c].start);
+    free(soa_pair_lists[c].j);
+  }
+  soa_pair_lists = (SoA_PairList *)
+    Utils::realloc(soa_pair_lists, sizeof(SoA_PairList)*local_cells.n);
+  for (c = n_soa_pair_lists; c < local_cells.n; c++)
+    memset(&soa_pair_lists[c], 0, sizeof(SoA_PairList));
+  n_soa_pair_lists = local_cells.n;
+}
+
+static void realloc_soa_pair_list(SoA_PairList *pl, int size)
+{
+  if (size <= pl->max)
+    return;
+  pl->max = SOA_BATCH*((size + SOA_BATCH - 1)/SOA_BATCH);
+  pl->j = (int *) Utils::realloc(pl->j, sizeof(int)*pl->max);
+}
+
+/** Append all particles of s2 from j_start on to the list of particle
+    i of s1 that are closer than the cutoff of their type pair from
+    \ref soa_cut2. The distances are calculated in batches of \ref
+    SOA_BATCH particles and the hits are compacted into the list,
+    both without branches. */
+static void soa_screen_cell(Cell *cell1, CellSoA *s1, int i,
+                            Cell *cell2, CellSoA *s2, int j_start,
+                            SoA_PairList *pl)
+{
+  double dist2[SOA_BATCH];
+  const double *cut2_row = &soa_cut2[s1->type[i]*soa_lj_n_types];
+  double ri[3];
+  int *jl;
+  int j, b, nb, n, n_start;
+
+  ri[0] = s1->r[0][i];
+  ri[1] = s1->r[1][i];
+  ri[2] = s1->r[2][i];
+
+  realloc_soa_pair_list(pl, pl->n + s2->n);
+  jl = pl->j;
+  n = n_start = pl->n;
+
+  for (j = j_start; j < s2->n; j += SOA_BATCH) {
+    nb = (s2->n - j < SOA_BATCH) ? s2->n - j : SOA_BATCH;
+
+    for (b = 0; b < nb; b++)
+      dist2[b] = SQR(ri[0] - s2->r[0][j + b]) + SQR(ri[1] - s2->r[1][j + b])
+        + SQR(ri[2] - s2->r[2][j + b]);
+
+    /* store every candidate, but advance only for the hits */
+    for (b = 0; b < nb; b++) {
+      jl[n] = s2->offset + j + b;
+      n += (dist2[b] <= cut2_row[s2->type[j + b]]);
+    }
+  }
+
+#ifdef EXCLUSIONS
+  if (s1->has_excl[i]) {
+    int k, m = n_start;
+    for (k = n_start; k < n; k++)
+      if (do_nonbonded(&cell1->part[i], &cell2->part[jl[k] - s2->offset]))
+        jl[m++] = jl[k];
+    n = m;
+  }
+#endif
+
+  pl->n = n;
+}
+
+/** Rebuild the pair lists of all local cells and store the positions
+    for the skin criterion. */
+static void soa_build_pair_lists()
+{
+  int c;
+
+  realloc_soa_pair_lists();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(soa_n_threads)
+#endif
+  for (c = 0; c < local_cells.n; c++) {
+    Cell *cell = local_cells.cell[c];
+    CellSoA *s1 = &cell_soa[cell - cells];
+    SoA_PairList *pl = &soa_pair_lists[c];
+    int n, i;
+
+    if (s1->n + 1 > pl->max_start) {
+      pl->max_start = s1->n + 1;
+      pl->start = (int *) Utils::realloc(pl->start, sizeof(int)*pl->max_start);
+    }
+
+    pl->n = 0;
+    for (i = 0; i < s1->n; i++) {
+      memcpy(cell->part[i].l.p_old, cell->part[i].r.p, 3*sizeof(double));
+      pl->start[i] = pl->n;
+      /* no interaction set, pair list stays empty */
+      if (max_cut_nonbonded == 0.0)
+        continue;
+      for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+        int ind2 = dd.cell_inter[c].nList[n].cell_ind;
+        soa_screen_cell(cell, s1, i, &cells[ind2], &cell_soa[ind2],
+                        (n == 0) ? i + 1 : 0, pl);
+      }
+    }
+    pl->start[s1->n] = pl->n;
+  }
+
+  soa_rebuild_lists = 0;
+}
+
+/** Nonbonded forces of all pairs in the pair list of a cell. The
+    partners of each particle are processed in batches of \ref
+    SOA_BATCH: first the distance vectors are gathered, then the force
+    prefactors are calculated and finally the forces are accumulated
+    for the particle and scattered to its partners. The forces go to
+    the buffer f of the calling thread, which is indexed like \ref
+    soa_all, the NPT virial to p_vir. */
+static void soa_pair_list_forces(CellSoA *s1, SoA_PairList *pl,
+                                 double *f[3], double p_vir[3])
+{
+  double d[3][SOA_BATCH], dist2[SOA_BATCH], fac[SOA_BATCH];
+  double ri[3], fi[3];
+  const SoA_LJ_Parameters *lj_row;
+  const int *pj;
+  int i, jb, b, k, nb;
+  /* local copies, so that the compiler knows they do not change */
+  const double *rx = soa_all.r[0], *ry = soa_all.r[1], *rz = soa_all.r[2];
+  double *fx = f[0], *fy = f[1], *fz = f[2];
+  const int *type = soa_all.type;
+
+  for (i = 0; i < s1->n; i++) {
+    if (pl->start[i] == pl->start[i + 1])
+      continue;
+
+    lj_row = &soa_lj[s1->type[i]*soa_lj_n_types];
+    for (k = 0; k < 3; k++) {
+      ri[k] = s1->r[k][i];
+      fi[k] = 0.0;
+    }
+
+    for (jb = pl->start[i]; jb < pl->start[i + 1]; jb += SOA_BATCH) {
+      nb = (pl->start[i + 1] - jb < SOA_BATCH) ? pl->start[i + 1] - jb : SOA_BATCH;
+      pj = pl->j + jb;
+
+      for (b = 0; b < nb; b++) {
+        d[0][b] = ri[0] - rx[pj[b]];
+        d[1][b] = ri[1] - ry[pj[b]];
+        d[2][b] = ri[2] - rz[pj[b]];
+        dist2[b] = SQR(d[0][b]) + SQR(d[1][b]) + SQR(d[2][b]);
+      }
+
+      if (soa_lj_plain) {
+        /* no square roots needed */
+        for (b = 0; b < nb; b++) {
+          const SoA_LJ_Parameters *lj = &lj_row[type[pj[b]]];
+          double inv2  = 1.0/dist2[b];
+          double frac2 = lj->sig2*inv2;
+          double frac6 = frac2*frac2*frac2;
+          /* two particles at the same position get no force, as in
+             add_lj_pair_force */
+          fac[b] = (dist2[b] > 0.0 && dist2[b] < lj->cut2) ? 48.0 * lj->eps * frac6*(frac6 - 0.5) * inv2 : 0.0;
+        }
+      }
+      else {
+        for (b = 0; b < nb; b++) {
+          const SoA_LJ_Parameters *lj = &lj_row[type[pj[b]]];
+          if (dist2[b] > 0.0)
+            fac[b] = soa_lj_pair_factor(lj, sqrt(dist2[b]));
+          else {
+            fac[b] = 0.0;
+            soa_lj_overlap_force(lj, s1->offset + i, pj[b], f);
+          }
+        }
+      }
+
+#ifdef NPT
+      if (integ_switch == INTEG_METHOD_NPT_ISO)
+        for (b = 0; b < nb; b++)
+          for (k = 0; k < 3; k++)
+            p_vir[k] += fac[b] * SQR(d[k][b]);
+#endif
+
+#if defined(ELECTROSTATICS) && defined(P3M)
+      if (coulomb.method != COULOMB_NONE)
+        for (b = 0; b < nb; b++) {
+          double q1q2 = s1->q[i]*soa_all.q[pj[b]];
+          if (q1q2) {
+            double eng;
+            fac[b] += p3m_pair_force_factor(q1q2, dist2[b], sqrt(dist2[b]), &eng);
+#ifdef NPT
+            if (integ_switch == INTEG_METHOD_NPT_ISO)
+              p_vir[0] += eng;
+#endif
+          }
+        }
+#endif
+
+      for (b = 0; b < nb; b++) {
+        double f0 = fac[b] * d[0][b], f1 = fac[b] * d[1][b], f2 = fac[b] * d[2][b];
+        fi[0] += f0;
+        fi[1] += f1;
+        fi[2] += f2;
+        fx[pj[b]] -= f0;
+        fy[pj[b]] -= f1;
+        fz[pj[b]] -= f2;
+      }
+    }
+
+    for (k = 0; k < 3; k++)
+      f[k][s1->offset + i] += fi[k];
+  }
+}
+
+/** add the mirrored pair forces to the particles of a cell list. */
+static void soa_add_forces(CellPList *cl)
+{
+  int c, i;
+
+  for (c = 0; c < cl->n; c++) {
+    Cell *cell = cl->cell[c];
+    CellSoA *s = &cell_soa[cell - cells];
+    Particle *part = cell->part;
+    for (i = 0; i < s->n; i++) {
+      part[i].f.f[0] += s->f[0][i];
+      part[i].f.f[1] += s->f[1][i];
+      part[i].f.f[2] += s->f[2][i];
+    }
+  }
+}
+
+void soa_build_verlet_lists()
+{
+  build_verlet_lists();
+  /* the old positions were reset, so the skin criterion no longer
+     covers the SoA pair lists */
+  soa_rebuild_lists = 1;
+}
+
+void soa_calculate_ia()
+{
+  int c, i;
+  /* threads actually running the pair loop, OpenMP may deliver fewer
+     than requested */
+  int n_threads = 1;
+  Cell *cell;
+  Particle *p1;
+
+  /* single particle forces, as in calc_link_cell */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p1   = cell->part;
+    for (i = 0; i < cell->n; i++) {
+      add_bonded_force(&p1[i]);
+#ifdef CONSTRAINTS
+      add_constraints_forces(&p1[i]);
+#endif
+      add_external_potential_forces(&p1[i]);
+    }
+  }
+
+  if (soa_rebuild_lists || rebuild_verletlist)
+    soa_build_pair_lists();
+  rebuild_verletlist = 0;
+
+  if (soa_thread_f_size < 3*(soa_n_threads - 1)*soa_all.n) {
+    soa_thread_f_size = 3*(soa_n_threads - 1)*soa_all.n;
+    soa_thread_f = (double *) Utils::realloc(soa_thread_f, sizeof(double)*soa_thread_f_size);
+  }
+
+  /* pair forces on the mirror. Each thread works on a fixed set of
+     cells and has its own force buffer, which are summed up in a
+     fixed order, so that the result does not depend on the timing of
+     the threads. */
+#ifdef _OPENMP
+#pragma omp parallel num_threads(soa_n_threads)
+#endif
+  {
+    int t = 0, k;
+    double *f[3];
+    /* thread local, stored once below to avoid false sharing */
+    double p_vir[3] = { 0.0, 0.0, 0.0 };
+
+#ifdef _OPENMP
+    t = omp_get_thread_num();
+#pragma omp master
+    n_threads = omp_get_num_threads();
+#endif
+    for (k = 0; k < 3; k++) {
+      f[k] = (t == 0) ? soa_all.f[k] : soa_thread_f + (3*(t - 1) + k)*soa_all.n;
+      memset(f[k], 0, soa_all.n*sizeof(double));
+    }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (c = 0; c < local_cells.n; c++)
+      soa_pair_list_forces(&cell_soa[local_cells.cell[c] - cells], &soa_pair_lists[c],
+                           f, p_vir);
+    for (k = 0; k < 3; k++)
+      soa_thread_vir[3*t + k] = p_vir[k];
+  }
+
+  if (n_threads > 1) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(n_threads)
+#endif
+    for (i = 0; i < soa_all.n; i++) {
+      int t, k;
+      for (t = 1; t < n_threads; t++)
+        for (k = 0; k < 3; k++)
+          soa_all.f[k][i] += soa_thread_f[(3*(t - 1) + k)*soa_all.n + i];
+    }
+  }
+
+#ifdef NPT
+  if (integ_switch == INTEG_METHOD_NPT_ISO) {
+    int t, k;
+    for (t = 0; t < n_threads; t++)
+      for (k = 0; k < 3; k++)
+        nptiso.p_vir[k] += soa_thread_vir[3*t + k];
+  }
+#endif
+
+  soa_add_forces(&local_cells);
+  soa_add_forces(&ghost_cells);
+}
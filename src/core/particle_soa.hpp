@@ -0,0 +1,163 @@
+/*
+  Copyright (C) 2010,2012,2013,2014 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef _PARTICLE_SOA_HPP
+#define _PARTICLE_SOA_HPP
+/** \file particle_soa.hpp
+ *
+ *  Packed structure-of-arrays (SoA) mirror of the particle data that
+ *  is needed by the short ranged pair force loop.
+ *
+ *  The \ref Particle struct is large, so that every pair visited in
+ *  the nonbonded loop touches several cache lines only to read \ref
+ *  ParticlePosition::p and to write \ref ParticleForce::f. If the
+ *  domain decomposition is set up with \ref DomainDecomposition::use_soa,
+ *  positions, types and charges of all particles (local and ghost)
+ *  are additionally stored in contiguous arrays in \ref soa_all, cell
+ *  by cell. \ref cell_soa, which is indexed in parallel to \ref
+ *  cells, gives the part belonging to each cell. The mirror is
+ *  refilled completely in \ref cells_resort_particles and its
+ *  positions are refreshed whenever the ghost positions are updated.
+ *  The pair forces are accumulated in the mirror and added to the
+ *  particles before the ghost forces are collected.
+ *
+ *  The SoA kernel keeps its own verlet lists, which store the
+ *  partners of each particle as indices into \ref soa_all, see \ref
+ *  SoA_PairList. Candidates are screened and forces are evaluated in
+ *  fixed size batches, so that the inner loops have no data dependent
+ *  control flow and can be vectorized by the compiler. Without verlet
+ *  lists, the lists are simply rebuilt with zero skin in every step.
+ *  Since the normal verlet lists are not maintained, energies and
+ *  pressures are calculated with the linked cell loops while the SoA
+ *  kernel is active.
+ *
+ *  If compiled with OpenMP, the list build and the pair force loop
+ *  are distributed over the threads cell by cell with a static
+ *  schedule. Every thread has its own force buffer, and the buffers
+ *  are summed in thread order, so that the forces are bitwise
+ *  reproducible for a fixed number of threads.
+ *
+ *  The SoA kernel only knows the Lennard-Jones potential and the
+ *  P3M real space part. For all other setups \ref soa_kernel_applicable
+ *  returns false and the usual force loops are used.
+ *
+ *  For more information see \ref particle_soa.cpp "particle_soa.c".
+ */
+#include "cells.hpp"
+
+/************************************************
+ * defines
+ ************************************************/
+
+/** \name Flags for \ref soa_update_cells */
+/*@{*/
+/** refresh only the positions */
+#define SOA_UPDATE_POS 1
+/** refill the complete mirror, including particle numbers, types and charges */
+#define SOA_UPDATE_ALL 2
+/*@}*/
+
+/************************************************
+ * data types
+ ************************************************/
+
+/** Structure-of-arrays mirror of one \ref Cell. */
+typedef struct {
+  /** positions, one array per coordinate. */
+  double *r[3];
+  /** nonbonded pair forces, one array per coordinate. */
+  double *f[3];
+  /** particle types. */
+  int *type;
+#ifdef ELECTROSTATICS
+  /** particle charges. */
+  double *q;
+#endif
+#ifdef EXCLUSIONS
+  /** flag whether the particle has exclusions. */
+  int *has_excl;
+#endif
+  /** number of particles mirrored. */
+  int n;
+  /** allocated size of the arrays. */
+  int max;
+  /** index of the first particle in \ref soa_all. */
+  int offset;
+} CellSoA;
+
+/** Verlet list of a local cell in the SoA kernel. The partners of
+    particle i of the cell are the particles j[start[i]] to
+    j[start[i+1]-1] of \ref soa_all, from all neighbor cells. */
+typedef struct {
+  /** offsets into j, one more than particles in the cell. */
+  int *start;
+  /** allocated size of start. */
+  int max_start;
+  /** indices into \ref soa_all. */
+  int *j;
+  /** number of pairs. */
+  int n;
+  /** allocated size of j. */
+  int max;
+} SoA_PairList;
+
+/************************************************
+ * exported variables
+ ************************************************/
+
+/** SoA mirror of all particles in \ref cells, cell by cell. */
+extern CellSoA soa_all;
+/** SoA mirrors of \ref cells, same indexing. These are views into
+    \ref soa_all. */
+extern CellSoA *cell_soa;
+/** number of entries in \ref cell_soa. */
+extern int n_cell_soa;
+/** Whether \ref force_calc uses \ref soa_calculate_ia. Set in \ref
+    soa_on_integration_start. */
+extern int soa_kernel_active;
+
+/************************************************
+ * functions
+ ************************************************/
+
+/** Update the SoA mirror of all cells from the particle data. Does
+    nothing unless the domain decomposition is active with \ref
+    DomainDecomposition::use_soa set.
+    @param what \ref SOA_UPDATE_POS or \ref SOA_UPDATE_ALL. */
+void soa_update_cells(int what);
+
+/** Check whether the current interactions and methods can be handled
+    by \ref soa_calculate_ia. */
+int soa_kernel_applicable();
+
+/** Decide whether to use the SoA kernel for the following
+    integration and set up its parameter table. */
+void soa_on_integration_start();
+
+/** Build the normal verlet lists of the domain decomposition for
+    analysis code that reads them directly, and make the SoA kernel
+    rebuild its own lists at the next force calculation. */
+void soa_build_verlet_lists();
+
+/** Calculate bonded and short ranged nonbonded forces using the
+    SoA mirror and the linked cell neighbor structure. Replaces \ref
+    calc_link_cell and the verlet list force loops if \ref
+    soa_kernel_active is set. */
+void soa_calculate_ia();
+
+#endif
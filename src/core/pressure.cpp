@@ -26,6 +26,7 @@
 #include "integrate.hpp"
 #include "initialize.hpp"
 #include "domain_decomposition.hpp"
+#include "particle_soa.hpp"
 #include "nsquare.hpp"
 #include "layered.hpp"
 #include "virtual_sites_relative.hpp" 
@@ -103,7 +104,8 @@ void pressure_calc(double *result, double *result_t, double *result_nb, double *
     layered_calculate_virials(v_comp);
     break;
   case CELL_STRUCTURE_DOMDEC:
-    if(dd.use_vList) {
+    /* the SoA kernel does not maintain the normal verlet lists */
+    if(dd.use_vList && !soa_kernel_active) {
       if (rebuild_verletlist)  
 	build_verlet_lists();
       calculate_verlet_virials(v_comp);
@@ -922,8 +924,9 @@ int local_stress_tensor_calc(DoubleList *TensorInBin, int bins[3], int periodic[
   int c, np, n, bin;
   double centre[3];
   Cell *cell;
-  Particle *p1, *p2, **pairs;
+  Particle *p1, *p2, *neighbors;
   Particle *particles;
+  int *pairs;
   double force[3];
   int k,l;
   int type_num;
@@ -960,6 +963,12 @@ int local_stress_tensor_calc(DoubleList *TensorInBin, int bins[3], int periodic[
 
   binvolume = range[0]*range[1]*range[2]/(double)bins[0]/(double)bins[1]/(double)bins[2];
 
+  /* the SoA kernel does not maintain the normal verlet lists */
+  if (soa_kernel_active)
+    soa_build_verlet_lists();
+  else if (cell_structure.type == CELL_STRUCTURE_DOMDEC && dd.use_vList && rebuild_verletlist)
+    build_verlet_lists();
+
   /* this next bit loops over all pair of particles, calculates the force between them, and distributes it amongst the tensors */
 
   // loop over all local cells
@@ -1003,13 +1012,14 @@ int local_stress_tensor_calc(DoubleList *TensorInBin, int bins[3], int periodic[
 
     // Loop cell neighbors
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      neighbors = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
 
       // verlet list loop //
       for(i=0; i<2*np; i+=2) {
-	p1 = pairs[i];                    // pointer to particle 1
-	p2 = pairs[i+1];                  // pointer to particle 2
+	p1 = &particles[pairs[i]];        // pointer to particle 1
+	p2 = &neighbors[pairs[i+1]];      // pointer to particle 2
 	if ((incubewithskin(p1->r.p,centre,range)) && (incubewithskin(p2->r.p,centre,range))) {
 	  get_nonbonded_interaction(p1,p2, force);
 	  PTENSOR_TRACE(fprintf(stderr,"%d:Looking at pair %d %d force is %f %f %f\n",this_node,p1->p.identity, p2->p.identity,force[0],force[1], force[2]));
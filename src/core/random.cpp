@@ -35,6 +35,11 @@ long  idumInit = -1;
 long  iy=0;
 long  iv[NTAB_RANDOM];
 
+/* Counter based generator */
+int rng_counter_mask = 0;
+int rng_counter_seed = 0;
+int rng_counter_step = 0;
+
 /* Stuff for Burkhards r250-generator */
 int bit_seed = -1;
 int rand_w_array[MERS_BIT_RANDOM];
@@ -240,6 +240,117 @@ inline double gaussian_random_cut(void) {
 }
 
 
+/*----------------------------------------------------------*/
+
+/** \name Counter based random numbers
+
+    The Philox4x32-10 generator of Salmon et al., "Parallel random
+    numbers: as easy as 1, 2, 3" (SC11). It has no state, but maps a
+    128 bit counter and a 64 bit key to four 32 bit random numbers.
+    The thermostats use as counter the integration step \ref
+    rng_counter_step, the particle identities and a stream number per
+    purpose, so that the noise of a particle does not depend on the
+    order in which the particles are visited, on the thread or on the
+    number of nodes. Which thermostats use it instead of \ref l_random
+    is set by \ref rng_counter_mask.
+*/
+/*@{*/
+
+/** Streams of the counter based generator, one per use. */
+#define RNG_STREAM_LANGEVIN      1
+#define RNG_STREAM_LANGEVIN_ROT  2
+#define RNG_STREAM_DPD           3
+#define RNG_STREAM_INTER_DPD     4
+#define RNG_STREAM_LB_FLUID      5
+#define RNG_STREAM_LB_COUPLING   6
+#define RNG_STREAM_GHMC          7
+#define RNG_STREAM_GHMC_ROT      8
+#define RNG_STREAM_GHMC_ACCEPT   9
+
+/** The thermostats (\ref THERMO_LANGEVIN and so on) that draw their
+    noise from the counter based generator. 0 for none. */
+extern int rng_counter_mask;
+/** Key of the counter based generator, the same on all nodes. */
+extern int rng_counter_seed;
+/** Advanced once per force calculation, the time part of the counter. */
+extern int rng_counter_step;
+
+/** One Philox4x32 round. */
+inline void philox_round(unsigned int ctr[4], const unsigned int key[2])
+{
+  unsigned long long p0 = 0xD2511F53ULL*ctr[0];
+  unsigned long long p1 = 0xCD9E8D57ULL*ctr[2];
+  unsigned int hi0 = (unsigned int)(p0 >> 32), lo0 = (unsigned int)p0;
+  unsigned int hi1 = (unsigned int)(p1 >> 32), lo1 = (unsigned int)p1;
+
+  ctr[0] = hi1 ^ ctr[1] ^ key[0];
+  ctr[1] = lo1;
+  ctr[2] = hi0 ^ ctr[3] ^ key[1];
+  ctr[3] = lo0;
+}
+
+/** Philox4x32-10: encrypt the counter \a ctr with \a key in place. */
+inline void philox4x32(unsigned int ctr[4], const unsigned int key_in[2])
+{
+  unsigned int key[2] = { key_in[0], key_in[1] };
+
+  for (int r = 0; r < 9; r++) {
+    philox_round(ctr, key);
+    key[0] += 0x9E3779B9U;
+    key[1] += 0xBB67AE85U;
+  }
+  philox_round(ctr, key);
+}
+
+/** Four uniform random numbers in (0,1) for the counter (\a stream,
+    \a id1, \a id2, \a index) at the current \ref rng_counter_step.
+    \a id1 and \a id2 are particle or lattice site identities, \a index
+    distinguishes several draws for the same objects. */
+inline void counter_random_uniform(int stream, int id1, int id2, int index, double out[4])
+{
+  unsigned int ctr[4], key[2];
+
+  ctr[0] = (unsigned int)id1;
+  ctr[1] = (unsigned int)id2;
+  ctr[2] = (unsigned int)rng_counter_step;
+  ctr[3] = ((unsigned int)stream << 24) ^ (unsigned int)index;
+  key[0] = (unsigned int)rng_counter_seed;
+  key[1] = 0x5EED1E55U;
+  philox4x32(ctr, key);
+
+  for (int i = 0; i < 4; i++)
+    out[i] = (ctr[i] + 0.5)*(1.0/4294967296.0);
+}
+
+/** Four gaussian random numbers with unit variance for the given
+    counter, see \ref counter_random_uniform. Uses the Box-Muller
+    transformation without rejection. */
+inline void counter_random_gaussian(int stream, int id1, int id2, int index, double out[4])
+{
+  double u[4];
+
+  counter_random_uniform(stream, id1, id2, index, u);
+  for (int i = 0; i < 4; i += 2) {
+    double r = sqrt(-2.0*log(u[i]));
+    out[i]   = r*cos(2*M_PI*u[i+1]);
+    out[i+1] = r*sin(2*M_PI*u[i+1]);
+  }
+}
+
+/** Four gaussian random numbers cut off at two standard deviations
+    like \ref gaussian_random_cut, for the given counter. */
+inline void counter_random_gaussian_cut(int stream, int id1, int id2, int index, double out[4])
+{
+  counter_random_gaussian(stream, id1, id2, index, out);
+  for (int i = 0; i < 4; i++) {
+    out[i] *= 1.042267973;
+    if (fabs(out[i]) > 2*1.042267973)
+      out[i] = (out[i] > 0) ? 2*1.042267973 : -2*1.042267973;
+  }
+}
+
+/*@}*/
+
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
@@ -89,7 +89,8 @@ void local_setup_reaction() {
 void integrate_reaction() {
   int c, np, n, i,
       check_catalyzer;
-  Particle *p1, *p2, **pairs;
+  Particle *part1, *part2, *p1, *p2;
+  int *pairs;
   Cell *cell;
   double dist2, vec21[3],
          ct_ratexp, eq_ratexp,
@@ -110,11 +111,11 @@ void integrate_reaction() {
       check_catalyzer = 0;
 
       cell = local_cells.cell[c];
-      p1   = cell->part;
+      part1 = cell->part;
       np  = cell->n;
       
       for(i = 0; i < np; i++) {
-        if(p1[i].p.type == reaction.catalyzer_type) {
+        if(part1[i].p.type == reaction.catalyzer_type) {
           check_catalyzer = 1;
           break;
         }
@@ -125,13 +126,14 @@ void integrate_reaction() {
 
         /* Loop cell neighbors */
         for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+          part2 = dd.cell_inter[c].nList[n].pList->part;
           pairs = dd.cell_inter[c].nList[n].vList.pair;
           np = dd.cell_inter[c].nList[n].vList.n;
 
           /* Verlet list loop */
           for(i = 0; i < 2 * np; i += 2) {
-            p1 = pairs[i];   //pointer to particle 1
-            p2 = pairs[i+1]; //pointer to particle 2
+            p1 = &part1[pairs[i]];   //pointer to particle 1
+            p2 = &part2[pairs[i+1]]; //pointer to particle 2
 
             if( (p1->p.type == reaction.reactant_type &&  p2->p.type == reaction.catalyzer_type) || (p2->p.type == reaction.reactant_type &&  p1->p.type == reaction.catalyzer_type) ) {
               get_mi_vector(vec21, p1->r.p, p2->r.p);
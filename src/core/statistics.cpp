@@ -43,11 +43,16 @@
 #include "lb.hpp"
 #include "virtual_sites.hpp"
 #include "initialize.hpp"
+#include "p3m-common.hpp"
 
 #include <vector>
 #include <string>
 #include <map>
 
+#ifdef FFTW
+#include <fftw3.h>
+#endif
+
 
 /** Previous particle configurations (needed for offline analysis and
     correlation analysis in \ref tclcommand_analyze) */
@@ -64,6 +69,52 @@ double min_distance2(double pos1[3], double pos2[3])
   return sqrlen(diff);
 }
 
+/** Gather the unfolded positions and the types of all particles in
+    identity order, optionally also their velocities and masses, see
+    \ref get_particles_properties. The entries of one particle are
+    pos[3], type, v[3] (if with_v) and mass (if with_mass and MASS is
+    compiled in), such that \ref GATHERED_MASS can be used. Unlike
+    \ref partCfg, nothing is cached, every call is one collective
+    operation.
+    @param with_v    whether to gather the velocities.
+    @param with_mass whether to gather the masses.
+    @param data      the gathered values.
+    @param ids       the identities of the particles.
+    @return the number of entries per particle.
+*/
+static int gather_particles(int with_v, int with_mass, std::vector<double> &data, std::vector<int> &ids)
+{
+  int props[4], n_props = 0, size = 0;
+
+  props[n_props++] = PART_PROP_POS;
+  props[n_props++] = PART_PROP_TYPE;
+  if (with_v)
+    props[n_props++] = PART_PROP_V;
+  if (with_mass && particles_property_size(PART_PROP_MASS))
+    props[n_props++] = PART_PROP_MASS;
+  for (int k = 0; k < n_props; k++)
+    size += particles_property_size(props[k]);
+
+  if (!particle_node)
+    build_particle_node();
+  ids.clear();
+  for (int id = 0; id <= max_seen_particle; id++)
+    if (particle_node[id] != -1)
+      ids.push_back(id);
+
+  data.resize(n_part*size + 1);
+  if (n_part > 0)
+    get_particles_properties(n_props, props, n_part, NULL, &data[0]);
+  return size;
+}
+
+/** mass of a particle gathered by \ref gather_particles with masses */
+#ifdef MASS
+#define GATHERED_MASS(val, size) (val)[(size) - 1]
+#else
+#define GATHERED_MASS(val, size) 1
+#endif
+
 
 /****************************************************************************************
  *                                 basic observables calculation
@@ -72,31 +123,33 @@ double min_distance2(double pos1[3], double pos2[3])
 double mindist(IntList *set1, IntList *set2)
 {
   double mindist, pt[3];
-  int i, j, in_set;
+  int i, j, in_set, size;
+  std::vector<double> data;
+  std::vector<int> ids;
 
   mindist = SQR(box_l[0] + box_l[1] + box_l[2]);
 
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(0, 0, data, ids);
   for (j=0; j<n_part-1; j++) {
-    pt[0] = partCfg[j].r.p[0];
-    pt[1] = partCfg[j].r.p[1];
-    pt[2] = partCfg[j].r.p[2];
+    pt[0] = data[j*size];
+    pt[1] = data[j*size + 1];
+    pt[2] = data[j*size + 2];
     /* check which sets particle j belongs to
        bit 0: set1, bit1: set2
     */
     in_set = 0;
-    if (!set1 || intlist_contains(set1, partCfg[j].p.type))
+    if (!set1 || intlist_contains(set1, (int)data[j*size + 3]))
       in_set = 1;
-    if (!set2 || intlist_contains(set2, partCfg[j].p.type))
+    if (!set2 || intlist_contains(set2, (int)data[j*size + 3]))
       in_set |= 2;
     if (in_set == 0)
       continue;
 
     for (i=j+1; i<n_part; i++)
       /* accept a pair if particle j is in set1 and particle i in set2 or vice versa. */
-      if (((in_set & 1) && (!set2 || intlist_contains(set2, partCfg[i].p.type))) ||
-          ((in_set & 2) && (!set1 || intlist_contains(set1, partCfg[i].p.type))))
-        mindist = dmin(mindist, min_distance2(pt, partCfg[i].r.p));
+      if (((in_set & 1) && (!set2 || intlist_contains(set2, (int)data[i*size + 3]))) ||
+          ((in_set & 2) && (!set1 || intlist_contains(set1, (int)data[i*size + 3]))))
+        mindist = dmin(mindist, min_distance2(pt, &data[i*size]));
   }
   mindist = sqrt(mindist);
 
@@ -124,8 +177,8 @@ void merge_aggregate_lists(int *head_list, int *agg_id_list, int p1molid, int p2
 
 int aggregation(double dist_criteria2, int min_contact, int s_mol_id, int f_mol_id, int *head_list, int *link_list, int *agg_id_list, int *agg_num, int *agg_size, int *agg_max, int *agg_min, int *agg_avg, int *agg_std, int charge)
 {
-  int c, np, n, i;
-  Particle *p1, *p2, **pairs;
+  int c, np, n, i, *pairs;
+  Particle *part1, *part2, *p1, *p2;
   double dist2;
   int target1;
   int p1molid, p2molid;
@@ -150,14 +203,16 @@ int aggregation(double dist_criteria2, int min_contact, int s_mol_id, int f_mol_
   
   /* Loop local cells */
   for (c = 0; c < local_cells.n; c++) {
+    part1 = local_cells.cell[c]->part;
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      part2 = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
       /* verlet list loop */
       for(i=0; i<2*np; i+=2) {
-	p1 = pairs[i];                    /* pointer to particle 1 */
-	p2 = pairs[i+1];                  /* pointer to particle 2 */
+	p1 = &part1[pairs[i]];            /* pointer to particle 1 */
+	p2 = &part2[pairs[i+1]];          /* pointer to particle 2 */
 	p1molid = p1->p.mol_id;
 	p2molid = p2->p.mol_id;
 	if (((p1molid <= f_mol_id) && (p1molid >= s_mol_id)) && ((p2molid <= f_mol_id) && (p2molid >= s_mol_id))) {
@@ -285,40 +340,52 @@ std::vector<double> calc_linear_momentum(int include_particles, int include_lbfl
     return linear_momentum;
 }
 
-void centermass(int type, double *com)
+/** center of mass of the particles of the given type, or of all
+    particles for type -1, from values gathered by \ref
+    gather_particles with masses. */
+static void centermass_gathered(const std::vector<double> &data, int size, int type, double *com)
 {
   int i, j;
   double M = 0.0;
   com[0]=com[1]=com[2]=0.;
-   	
-  updatePartCfg(WITHOUT_BONDS);
+
   for (j=0; j<n_part; j++) {
-    if ((partCfg[j].p.type == type) || (type == -1)) {
+    const double *val = &data[j*size];
+    if (((int)val[3] == type) || (type == -1)) {
       for (i=0; i<3; i++) {
-      	com[i] += partCfg[j].r.p[i]*PMASS(partCfg[j]);
+      	com[i] += val[i]*GATHERED_MASS(val, size);
       }
-      M += PMASS(partCfg[j]);
+      M += GATHERED_MASS(val, size);
     }
   }
   
   for (i=0; i<3; i++) {
     com[i] /= M;
   }
-  return;
+}
+
+void centermass(int type, double *com)
+{
+  std::vector<double> data;
+  std::vector<int> ids;
+  int size = gather_particles(0, 1, data, ids);
+  centermass_gathered(data, size, type, com);
 }
 
 void centermass_vel(int type, double *com)
 {
   /*center of mass velocity scaled with time_step*/
-  int i, j;
+  int i, j, size;
   int count = 0;
+  std::vector<double> data;
+  std::vector<int> ids;
   com[0]=com[1]=com[2]=0.;
 
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(1, 0, data, ids);
   for (j=0; j<n_part; j++) {
-    if (type == partCfg[j].p.type) {
+    if (type == (int)data[j*size + 3]) {
       for (i=0; i<3; i++) {
-      	com[i] += partCfg[j].m.v[i];
+      	com[i] += data[j*size + 4 + i];
       }
       count++;
     }
@@ -332,18 +399,21 @@ void centermass_vel(int type, double *com)
 
 void angularmomentum(int type, double *com)
 {
-  int i, j;
+  int i, j, size;
   double tmp[3];
   double pre_factor;
+  std::vector<double> data;
+  std::vector<int> ids;
   com[0]=com[1]=com[2]=0.;
 
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(1, 1, data, ids);
   for (j=0; j<n_part; j++) 
   {
-    if (type == partCfg[j].p.type) 
+    double *val = &data[j*size];
+    if (type == (int)val[3]) 
     {
-      vector_product(partCfg[j].r.p,partCfg[j].m.v,tmp);
-      pre_factor=PMASS(partCfg[j]);
+      vector_product(val, val + 4, tmp);
+      pre_factor=GATHERED_MASS(val, size);
       for (i=0; i<3; i++) {
         com[i] += tmp[i]*pre_factor;
       }
@@ -354,20 +424,23 @@ void angularmomentum(int type, double *com)
 
 void  momentofinertiamatrix(int type, double *MofImatrix)
 {
-  int i,j,count;
+  int i,j,count,size;
   double p1[3],com[3],massi;
+  std::vector<double> data;
+  std::vector<int> ids;
 
   count=0;
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(0, 1, data, ids);
   for(i=0;i<9;i++) MofImatrix[i]=0.;
-  centermass(type, com);
+  centermass_gathered(data, size, type, com);
   for (j=0; j<n_part; j++) {
-    if (type == partCfg[j].p.type) {
+    double *val = &data[j*size];
+    if (type == (int)val[3]) {
       count ++;
       for (i=0; i<3; i++) {
-      	p1[i] = partCfg[j].r.p[i] - com[i];
+      	p1[i] = val[i] - com[i];
       }
-      massi= PMASS(partCfg[j]);
+      massi= GATHERED_MASS(val, size);
       MofImatrix[0] += massi * (p1[1] * p1[1] + p1[2] * p1[2]) ; 
       MofImatrix[4] += massi * (p1[0] * p1[0] + p1[2] * p1[2]);
       MofImatrix[8] += massi * (p1[0] * p1[0] + p1[1] * p1[1]);
@@ -385,27 +458,29 @@ void  momentofinertiamatrix(int type, double *MofImatrix)
 
 void calc_gyration_tensor(int type, double **_gt)
 {
-  int i, j, count;
+  int i, j, count, size;
   double com[3];
   double eva[3],eve0[3],eve1[3],eve2[3];
   double *gt=NULL, tmp;
   double Smatrix[9],p1[3];
+  std::vector<double> data;
+  std::vector<int> ids;
 
   for (i=0; i<9; i++) Smatrix[i] = 0;
   /* 3*ev, rg, b, c, kappa, eve0[3], eve1[3], eve2[3]*/
   *_gt = gt = (double*)Utils::realloc(gt,16*sizeof(double)); 
 
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(0, 1, data, ids);
 
   /* Calculate the position of COM */
-  centermass(type,com);
+  centermass_gathered(data, size, type, com);
 
   /* Calculate the gyration tensor Smatrix */
   count=0;
   for (i=0;i<n_part;i++) {
-    if ((partCfg[i].p.type == type) || (type == -1)) {
+    if (((int)data[i*size + 3] == type) || (type == -1)) {
       for ( j=0; j<3 ; j++ ) { 
-        p1[j] = partCfg[i].r.p[j] - com[j];
+        p1[j] = data[i*size + j] - com[j];
       }
       count ++;
       Smatrix[0] += p1[0]*p1[0];
@@ -452,28 +527,30 @@ void calc_gyration_tensor(int type, double **_gt)
 void nbhood(double pt[3], double r, IntList *il, int planedims[3] )
 {
   double d[3];
-  int i,j;
+  int i,j,size;
   double r2;
+  std::vector<double> data;
+  std::vector<int> ids;
 
   r2 = r*r;
 
   init_intlist(il);
  
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(0, 0, data, ids);
 
   for (i = 0; i<n_part; i++) {
     if ( (planedims[0] + planedims[1] + planedims[2]) == 3 ) {
-      get_mi_vector(d, pt, partCfg[i].r.p);
+      get_mi_vector(d, pt, &data[i*size]);
     } else {
       /* Calculate the in plane distance */
       for ( j= 0 ; j < 3 ; j++ ) {
-	d[j] = planedims[j]*(partCfg[i].r.p[j]-pt[j]);
+	d[j] = planedims[j]*(data[i*size + j]-pt[j]);
       }
     }
 
     if (sqrlen(d) < r2) {
       realloc_intlist(il, il->n + 1);
-      il->e[il->n] = partCfg[i].p.identity;
+      il->e[il->n] = ids[i];
       il->n++;
     }
   }
@@ -481,17 +558,19 @@ void nbhood(double pt[3], double r, IntList *il, int planedims[3] )
 
 double distto(double p[3], int pid)
 {
-  int i;
+  int i, size;
   double d[3];
   double mindist;
+  std::vector<double> data;
+  std::vector<int> ids;
 
-  updatePartCfg(WITHOUT_BONDS);
+  size = gather_particles(0, 0, data, ids);
 
   /* larger than possible */
   mindist=SQR(box_l[0] + box_l[1] + box_l[2]);
   for (i=0; i<n_part; i++) {
-    if (pid != partCfg[i].p.identity) {
-      get_mi_vector(d, p, partCfg[i].r.p);
+    if (pid != ids[i]) {
+      get_mi_vector(d, p, &data[i*size]);
       mindist = dmin(mindist, sqrlen(d));
     }
   }
@@ -653,6 +732,81 @@ void calc_part_distribution(int *p1_types, int n_p1, int *p2_types, int n_p2,
 }
 
 
+/** Number of times type occurs in the list types. */
+static int rdf_type_count(int type, int *types, int n_types)
+{
+  int cnt = 0;
+  for (int t = 0; t < n_types; t++)
+    if (types[t] == type) cnt++;
+  return cnt;
+}
+
+int calc_rdf_local_possible(double r_max)
+{
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC)
+    return 0;
+  /* particles may have moved by up to skin/2 since the last resort,
+     as for the verlet lists */
+  for (int i = 0; i < 3; i++)
+    if (r_max + skin > dd.cell_size[i] || r_max > 0.5*box_l[i])
+      return 0;
+  return 1;
+}
+
+void calc_rdf_local(int *p1_types, int n_p1, int *p2_types, int n_p2, int mixed_flag,
+                    double r_min, double r_max, int r_bins, double *hist, double cnt[3])
+{
+  double inv_bin_width = (double)r_bins / (r_max-r_min);
+  double dist2, vec21[3];
+
+  for (int i = 0; i < r_bins; i++) hist[i] = 0.0;
+  cnt[0] = cnt[1] = cnt[2] = 0.0;
+
+  for (int c = 0; c < local_cells.n; c++) {
+    Cell *cell = local_cells.cell[c];
+    Particle *p1 = cell->part;
+    int np1 = cell->n;
+
+    for (int i = 0; i < np1; i++) {
+      int m1 = rdf_type_count(p1[i].p.type, p1_types, n_p1);
+      int m2 = rdf_type_count(p1[i].p.type, p2_types, n_p2);
+      cnt[0] += m1;
+      cnt[1] += m2;
+      cnt[2] += m1*m2;
+    }
+
+    /* every pair of particles within the cell range is found
+       exactly once, see calc_link_cell */
+    for (int n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      Particle *p2 = dd.cell_inter[c].nList[n].pList->part;
+      int np2 = dd.cell_inter[c].nList[n].pList->n;
+
+      for (int i = 0; i < np1; i++) {
+        int a1 = rdf_type_count(p1[i].p.type, p1_types, n_p1);
+        int a2 = rdf_type_count(p1[i].p.type, p2_types, n_p2);
+        if (a1 == 0 && a2 == 0)
+          continue;
+        for (int j = (n == 0) ? i+1 : 0; j < np2; j++) {
+          int weight;
+          if (mixed_flag)
+            weight = a1*rdf_type_count(p2[j].p.type, p2_types, n_p2)
+              + a2*rdf_type_count(p2[j].p.type, p1_types, n_p1);
+          else
+            weight = a1*rdf_type_count(p2[j].p.type, p2_types, n_p2);
+          if (weight == 0)
+            continue;
+          dist2 = distance2vec(p1[i].r.p, p2[j].r.p, vec21);
+          if (dist2 >= r_max*r_max)
+            continue;
+          double dist = sqrt(dist2);
+          if (dist > r_min && dist < r_max)
+            hist[(int) ((dist - r_min)*inv_bin_width)] += weight;
+        }
+      }
+    }
+  }
+}
+
 void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2, 
 	      double r_min, double r_max, int r_bins, double *rdf)
 {
@@ -670,6 +824,21 @@ void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2,
 
   bin_width     = (r_max-r_min) / (double)r_bins;
   inv_bin_width = 1.0 / bin_width;
+  volume = box_l[0]*box_l[1]*box_l[2];
+
+  /* histogram the pairs on the nodes if the cells reach up to r_max */
+  double pairs;
+  if (mpi_rdf(p1_types, n_p1, p2_types, n_p2, mixed_flag, r_min, r_max, r_bins, rdf, &pairs)) {
+    for(i=0; i<r_bins; i++) {
+      r_in       = i*bin_width + r_min; 
+      r_out      = r_in + bin_width;
+      bin_volume = (4.0/3.0) * PI * ((r_out*r_out*r_out) - (r_in*r_in*r_in));
+      rdf[i] *= volume / (bin_volume * pairs);
+    }
+    return;
+  }
+
+  updatePartCfg(WITHOUT_BONDS);
   for(i=0;i<r_bins;i++) rdf[i] = 0.0;
   /* particle loop: p1_types*/
   for(i=0; i<n_part; i++) {
@@ -696,7 +865,6 @@ void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2,
   }
 
   /* normalization */
-  volume = box_l[0]*box_l[1]*box_l[2];
   for(i=0; i<r_bins; i++) {
     r_in       = i*bin_width + r_min; 
     r_out      = r_in + bin_width;
@@ -885,6 +1053,103 @@ void calc_structurefactor(int type, int order, double **_ff) {
   }
 }
 
+int calc_density_mesh_local(int type, int mesh, int cao, double *rho)
+{
+  /* as in the P3M charge assignment, the mesh points are in the
+     centers of the mesh cells */
+  double pos_shift = (double)((cao-1)/2) - (cao%2)/2.0;
+  double ai[3], w[3][7];
+  int nmp[3], cnt = 0;
+
+  for (int d = 0; d < 3; d++)
+    ai[d] = mesh/box_l[d];
+  for (int i = 0; i < mesh*mesh*mesh; i++)
+    rho[i] = 0.0;
+
+  for (int c = 0; c < local_cells.n; c++) {
+    Cell *cell = local_cells.cell[c];
+    Particle *p = cell->part;
+    for (int i = 0; i < cell->n; i++) {
+      if (p[i].p.type != type)
+        continue;
+      for (int d = 0; d < 3; d++) {
+        double pos = p[i].r.p[d]*ai[d] - 0.5 - pos_shift;
+        nmp[d] = (int)floor(pos);
+        double dist = (pos - nmp[d]) - 0.5;
+        for (int j = 0; j < cao; j++)
+          w[d][j] = p3m_caf(j, dist, cao);
+      }
+      /* the particles may have left the box since the last resort */
+      for (int i0 = 0; i0 < cao; i0++) {
+        int x = ((nmp[0] + i0) % mesh + mesh) % mesh;
+        for (int i1 = 0; i1 < cao; i1++) {
+          int y = ((nmp[1] + i1) % mesh + mesh) % mesh;
+          double w01 = w[0][i0]*w[1][i1];
+          for (int i2 = 0; i2 < cao; i2++) {
+            int z = ((nmp[2] + i2) % mesh + mesh) % mesh;
+            rho[(x*mesh + y)*mesh + z] += w01*w[2][i2];
+          }
+        }
+      }
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+#ifdef FFTW
+void calc_structurefactor_mesh(int type, int order, int mesh, int cao, double **_ff)
+{
+  int order2 = order*order, mesh_z = mesh/2 + 1;
+  double *ff;
+
+  *_ff = ff = (double*)Utils::malloc(2*order2*sizeof(double));
+  for (int qi = 0; qi < 2*order2; qi++)
+    ff[qi] = 0.0;
+
+  if ((type < 0) || (type > n_particle_types)) { fprintf(stderr,"WARNING: Type %i does not exist!",type); fflush(NULL); errexit(); }
+  else if (order < 1) { fprintf(stderr,"WARNING: parameter \"order\" has to be a whole positive number"); fflush(NULL); errexit(); }
+  else if (mesh <= 2*order || cao < 1 || cao > 7) { fprintf(stderr,"WARNING: mesh has to be larger than 2*order and cao between 1 and 7"); fflush(NULL); errexit(); }
+
+  double *rho = (double *)fftw_malloc(mesh*mesh*mesh*sizeof(double));
+  fftw_complex *rho_k = (fftw_complex *)fftw_malloc(mesh*mesh*mesh_z*sizeof(fftw_complex));
+  int n = mpi_gather_density_mesh(type, mesh, cao, rho);
+
+  fftw_plan plan = fftw_plan_dft_r2c_3d(mesh, mesh, mesh, rho, rho_k, FFTW_ESTIMATE);
+  fftw_execute(plan);
+  fftw_destroy_plan(plan);
+
+  /* inverse of the Fourier transformed assignment function in one
+     direction, (sinc(PI k/mesh))^-cao */
+  std::vector<double> inv_caf(2*order + 1);
+  for (int k = -order; k <= order; k++) {
+    double x = PI*k/(double)mesh;
+    inv_caf[k + order] = (k == 0) ? 1.0 : pow(x/sin(x), cao);
+  }
+
+  for (int i = 0; i <= order; i++) {
+    for (int j = -order; j <= order; j++) {
+      for (int k = -order; k <= order; k++) {
+        int qn = i*i + j*j + k*k;
+        if ((qn <= order2) && (qn >= 1)) {
+          /* only k_z >= 0 is stored, and rho(-q) = rho(q)^* */
+          int s = (k < 0) ? -1 : 1;
+          int ind = (((s*i + mesh) % mesh)*mesh + (s*j + mesh) % mesh)*mesh_z + s*k;
+          double inv_w = inv_caf[i + order]*inv_caf[j + order]*inv_caf[k + order];
+          ff[2*qn-2] += (SQR(rho_k[ind][0]) + SQR(rho_k[ind][1]))*SQR(inv_w);
+          ff[2*qn-1]++;
+        }
+      }
+    }
+  }
+  for (int qi = 0; qi < order2; qi++)
+    if (ff[2*qi+1] != 0) ff[2*qi] /= n*ff[2*qi+1];
+
+  fftw_free(rho);
+  fftw_free(rho_k);
+}
+#endif
+
 std::vector< std::vector<double> > modify_stucturefactor( int order, double *sf)
 {
   int length = 0;
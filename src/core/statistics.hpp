@@ -223,6 +223,10 @@ void calc_part_distribution(int *p1_types, int n_p1, int *p2_types, int n_p2,
     the distribution function is binned into r_bin bins, which are
     equidistant. The result is stored in the array rdf.
 
+    If the cells of the domain decomposition reach up to r_max, the
+    pairs are histogrammed on the nodes (see \ref mpi_rdf), otherwise
+    all particles are collected on the master.
+
     @param p1_types list with types of particles to find the distribution for.
     @param n_p1     length of p1_types.
     @param p2_types list with types of particles the others are distributed around.
@@ -235,6 +239,31 @@ void calc_part_distribution(int *p1_types, int n_p1, int *p2_types, int n_p2,
 void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2, 
 	      double r_min, double r_max, int r_bins, double *rdf);
 
+/** Whether this node can histogram the pairs of the radial
+    distribution function up to r_max from its cells and ghosts,
+    i.e. the domain decomposition cells are larger than r_max plus the
+    skin. */
+int calc_rdf_local_possible(double r_max);
+
+/** Histograms the pairs of particles on this node for \ref calc_rdf,
+    without normalization. Every pair closer than r_max is found on
+    exactly one node.
+
+    @param p1_types   list with types of particles to find the distribution for.
+    @param n_p1       length of p1_types.
+    @param p2_types   list with types of particles the others are distributed around.
+    @param n_p2       length of p2_types.
+    @param mixed_flag 0 if p1_types and p2_types are identical.
+    @param r_min      Minimal distance for the distribution.
+    @param r_max      Maximal distance for the distribution.
+    @param r_bins     Number of bins.
+    @param hist       Array to store the number of pairs (size: r_bins).
+    @param cnt        Sums over the local particles of the multiplicity of their type
+                      in p1_types, in p2_types and of the product of both.
+*/
+void calc_rdf_local(int *p1_types, int n_p1, int *p2_types, int n_p2, int mixed_flag,
+                    double r_min, double r_max, int r_bins, double *hist, double cnt[3]);
+
 
 /** Calculates the radial distribution function averaged over last n_conf configurations.
 
@@ -319,6 +348,38 @@ double calc_vanhove(int ptype, double rmin, double rmax, int rbins, int tmax, do
 
 void calc_structurefactor(int type, int order, double **sf);
 
+#ifdef FFTW
+/** Calculates the spherically averaged structure factor from the
+    density of the particles on a mesh.
+
+    The particles of the given type are assigned to a mesh with the
+    P3M charge assignment functions on the nodes (see \ref
+    mpi_gather_density_mesh), the mesh is Fourier transformed on the
+    master, and the Fourier transform of the assignment function is
+    divided out. The result has the same layout as for \ref
+    calc_structurefactor, but the cost is independent of order up to
+    the FFT. Aliasing errors are small for mesh >= 4*order and large
+    cao.
+
+    @param type   the type of the particles to be analyzed
+    @param order  the maximum wave vector length in 2PI/L
+    @param mesh   number of mesh points in each direction (> 2*order).
+    @param cao    charge assignment order (1 to 7).
+    @param sf     pointer to hold the base of the array containing the result (size: 2*order^2).
+*/
+void calc_structurefactor_mesh(int type, int order, int mesh, int cao, double **sf);
+#endif
+
+/** Assigns the local particles of the given type to the density
+    mesh of \ref calc_structurefactor_mesh.
+    @param type   the type of the particles to be assigned.
+    @param mesh   number of mesh points in each direction.
+    @param cao    charge assignment order (1 to 7).
+    @param rho    the density mesh (size: mesh^3, z index fastest).
+    @return the number of local particles of the type.
+*/
+int calc_density_mesh_local(int type, int mesh, int cao, double *rho);
+
 std::vector< std::vector<double> > modify_stucturefactor( int order, double *sf);
 
 /** Calculates the density profile in dir direction */
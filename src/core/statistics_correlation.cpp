@@ -21,6 +21,13 @@
 #include "integrate.hpp"
 #include <cstring>
 
+/** number of components of A and B that are correlated together for
+    all lags, see \ref componentwise_product_accumulate */
+#define CORR_BLOCK 512
+/** minimal number of values to correlate in one update for using
+    the OpenMP threads */
+#define CORR_OMP_MIN_SIZE 16384
+
 /* global variables */
 double_correlation* correlations=0;
 unsigned int n_correlations = 0;
@@ -232,6 +239,8 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
 
   self->B_obs = B;
   
+  // only the common operations have a version for many lags
+  self->corr_accumulate = 0;
 
   // choose the correlation operation 
   if (corr_operation_name==0) { 
@@ -239,6 +248,7 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
   } else if ( strcmp(corr_operation_name,"componentwise_product") == 0 ) {
     dim_corr = dim_A;
     self->corr_operation = &componentwise_product;
+    self->corr_accumulate = &componentwise_product_accumulate;
     self->args = NULL;
   } else if ( strcmp(corr_operation_name,"complex_conjugate_product") == 0 ) {
     dim_corr = dim_A;
@@ -251,6 +261,7 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
   } else if ( strcmp(corr_operation_name,"square_distance_componentwise") == 0 ) {
     dim_corr = dim_A;
     self->corr_operation = &square_distance_componentwise;
+    self->corr_accumulate = &square_distance_componentwise_accumulate;
     self->args = NULL;
   } else if ( strcmp(corr_operation_name,"fcs_acf") == 0 ) {
     if (dim_A %3 )
@@ -264,10 +275,14 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
   } else if ( strcmp(corr_operation_name,"scalar_product") == 0 ) {
     dim_corr=1;
     self->corr_operation = &scalar_product;
+    self->corr_accumulate = &scalar_product_accumulate;
     self->args = NULL;
   } else {
     return 11; 
   }
+  // the operations report mismatching dimensions at the first update
+  if (dim_A != dim_B)
+    self->corr_accumulate = 0;
   self->dim_corr = dim_corr;
   self->corr_operation_name = corr_operation_name;
   
@@ -380,6 +395,10 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
       self->result[i][j]=0;
   }
 
+  self->lag_A = (double**) Utils::malloc((tau_lin+1)*sizeof(double*));
+  self->lag_result = (double**) Utils::malloc((tau_lin+1)*sizeof(double*));
+  self->temp = (double*) Utils::malloc(dim_corr*sizeof(double));
+
   self->newest = (unsigned int *)Utils::malloc(hierarchy_depth*sizeof(unsigned int));
   for ( i = 0; i<self->hierarchy_depth; i++ ) {
     self->newest[i]= self->tau_lin;
@@ -394,20 +413,54 @@ int double_correlation_init(double_correlation* self, double dt, unsigned int ta
   return 0;
 }
 
+/** Correlates the newest values of A and B on hierarchy level i with
+    the older values at the lags j_min <= j < j_max, and adds the
+    results to the estimates at j + i*tau_lin/2. All lags are handed
+    to the operation at once if it supports this. */
+static int correlation_update_level(double_correlation* self, int i, unsigned int j_min, unsigned int j_max) {
+  unsigned int tau_lin = self->tau_lin;
+  unsigned int n_lags = 0;
+  double *B_new = self->B[i][self->newest[i]];
+
+  for (unsigned int j = j_min; j < j_max; j++) {
+    unsigned int index_old = (self->newest[i] - j + tau_lin + 1) % (tau_lin + 1);
+    unsigned int index_res = j + i*tau_lin/2;
+    self->n_sweeps[index_res]++;
+    self->lag_A[n_lags] = self->A[i][index_old];
+    self->lag_result[n_lags] = self->result[index_res];
+    n_lags++;
+  }
+  if (n_lags == 0)
+    return 0;
+
+  if (self->corr_accumulate) {
+    (*self->corr_accumulate)(self->lag_A, B_new, n_lags, self->lag_result, self->dim_A, self->dim_corr);
+    return 0;
+  }
+
+  for (unsigned int l = 0; l < n_lags; l++) {
+    int error = (self->corr_operation)(self->lag_A[l], self->dim_A, B_new, self->dim_B, self->temp, self->dim_corr, self->args);
+    if ( error != 0)
+      return error;
+    for (unsigned k = 0; k < self->dim_corr; k++) {
+      self->lag_result[l][k] += self->temp[k];
+    }
+  }
+  return 0;
+}
+
 int double_correlation_get_data( double_correlation* self ) {
   // We must now go through the hierarchy and make sure there is space for the new 
   // datapoint. For every hierarchy level we have to decide if it necessary to move 
   // something
-  int i,j;
+  int i;
   int highest_level_to_compress;
-  unsigned int index_new, index_old, index_res;
   int error;
   
   self->t++;
 
   highest_level_to_compress=-1;
   i=0;
-  j=1;
   // Lets find out how far we have to go back in the hierarchy to make space for the new value
   while (1) {
     if ( ( (self->t - ((self->tau_lin + 1)*((1<<(i+1))-1) + 1) )% (1<<(i+1)) == 0) ) {
@@ -465,38 +518,16 @@ int double_correlation_get_data( double_correlation* self ) {
     }
   } 
 
-  double* temp = (double*)Utils::malloc(self->dim_corr*sizeof(double));
-  if (!temp)
-    return 4;
 // Now update the lowest level correlation estimates
-  for ( j = 0; j < int(MIN(self->tau_lin+1, self->n_vals[0]) ); j++) {
-    index_new = self->newest[0];
-    index_old =  (self->newest[0] - j + self->tau_lin + 1) % (self->tau_lin + 1);
-//    printf("old %d new %d\n", index_old, index_new);
-    error = (self->corr_operation)(self->A[0][index_old], self->dim_A, self->B[0][index_new], self->dim_B, temp, self->dim_corr, self->args);
-    if ( error != 0)
-      return error;
-    self->n_sweeps[j]++;
-    for (unsigned k = 0; k < self->dim_corr; k++) {
-      self->result[j][k] += temp[k];
-    }
-  }
+  error = correlation_update_level(self, 0, 0, MIN(self->tau_lin+1, self->n_vals[0]));
+  if ( error != 0)
+    return error;
 // Now for the higher ones
   for ( int i = 1; i < highest_level_to_compress+2; i++) {
-    for ( unsigned j = (self->tau_lin+1)/2+1; j < MIN(self->tau_lin+1, self->n_vals[i]); j++) {
-      index_new = self->newest[i];
-      index_old = (self->newest[i] - j + self->tau_lin + 1) % (self->tau_lin + 1);
-      index_res = self->tau_lin + (i-1)*self->tau_lin/2 + (j - self->tau_lin/2+1) -1;
-      error=(self->corr_operation)(self->A[i][index_old], self->dim_A, self->B[i][index_new], self->dim_B, temp, self->dim_corr, self->args);
-      if ( error != 0)
-        return error;
-      self->n_sweeps[index_res]++;
-      for (unsigned k = 0; k < self->dim_corr; k++) {
-        self->result[index_res][k] += temp[k];
-      }
-    }
+    error = correlation_update_level(self, i, (self->tau_lin+1)/2+1, MIN(self->tau_lin+1, self->n_vals[i]));
+    if ( error != 0)
+      return error;
   }
-  free(temp);
   return 0;
 }
 
@@ -628,23 +659,18 @@ int double_correlation_finalize( double_correlation* self ) {
   // We must now go through the hierarchy and make sure there is space for the new 
   // datapoint. For every hierarchy level we have to decide if it necessary to move 
   // something
-  int i,j;
+  int i;
   int ll=0; // current lowest level
   int vals_ll=0; // number of values remaining in the lowest level
   int highest_level_to_compress;
-  unsigned int index_new, index_old, index_res;
   int error;
   //int compress;
   unsigned tau_lin=self->tau_lin;
   int hierarchy_depth=self->hierarchy_depth;
 
-  double* temp = (double*)Utils::malloc(self->dim_corr*sizeof(double));
-
   // make a flag that the correlation is finalized
   self->finalized=1;
 
-  if (!temp)
-    return 4;
   //printf ("tau_lin:%d, hierarchy_depth: %d\n",tau_lin,hierarchy_depth); 
   //for(ll=0;ll<hierarchy_depth;ll++) printf("n_vals[l=%d]=%d\n",ll, self->n_vals[ll]);
   for(ll=0;ll<hierarchy_depth-1;ll++) {
@@ -664,7 +690,6 @@ int double_correlation_finalize( double_correlation* self ) {
       //printf("Compress\n"); fflush(stdout);
   
       i=ll+1; // lowest level, for which we have to check for compression 
-      j=1; 
       // Lets find out how far we have to go back in the hierarchy to make space for the new value 
       while (highest_level_to_compress>-1) { 
         //printf("test level %d for compression, n_vals=%d ... ",i,self->n_vals[i]);
@@ -704,18 +729,9 @@ int double_correlation_finalize( double_correlation* self ) {
 
       // We only need to update correlation estimates for the higher levels
       for ( i = ll+1; i < highest_level_to_compress+2; i++) {
-        for ( j = (tau_lin+1)/2+1; j < int(MIN(tau_lin+1, self->n_vals[i])); j++) {
-          index_new = self->newest[i];
-          index_old = (self->newest[i] - j + tau_lin + 1) % (tau_lin + 1);
-          index_res = tau_lin + (i-1)*tau_lin/2 + (j - tau_lin/2+1) -1;
-          error=(self->corr_operation)(self->A[i][index_old], self->dim_A, self->B[i][index_new], self->dim_B, temp, self->dim_corr, self->args);
-          if ( error != 0)
-            return error;
-          self->n_sweeps[index_res]++;
-          for (unsigned k = 0; k < self->dim_corr; k++) {
-            self->result[index_res][k] += temp[k];
-          }
-        }
+        error = correlation_update_level(self, i, (tau_lin+1)/2+1, MIN(tau_lin+1, self->n_vals[i]));
+        if ( error != 0)
+          return error;
       }
       // lowest level exploited, go upwards
       if(!vals_ll) { 
@@ -724,7 +740,6 @@ int double_correlation_finalize( double_correlation* self ) {
       }
     }
   }
-  free(temp);
   return 0;
 }
 
@@ -858,6 +873,55 @@ int fcs_acf ( double* A, unsigned int dim_A, double* B, unsigned int dim_B, doub
 }
 
 
+void scalar_product_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr ) {
+  // the lags are independent, and the sum is taken in the same order
+  // as in scalar_product
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_lags*dim_A >= CORR_OMP_MIN_SIZE)
+#endif
+  for (int l = 0; l < int(n_lags); l++) {
+    const double *a = A[l];
+    double temp = 0;
+    for (unsigned int k = 0; k < dim_A; k++)
+      temp += a[k]*B[k];
+    C[l][0] += temp;
+  }
+}
+
+void componentwise_product_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr ) {
+  int n_blocks = (dim_A + CORR_BLOCK - 1)/CORR_BLOCK;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_lags*dim_A >= CORR_OMP_MIN_SIZE)
+#endif
+  for (int b = 0; b < n_blocks; b++) {
+    unsigned int k_start = b*CORR_BLOCK;
+    unsigned int k_end = MIN(k_start + CORR_BLOCK, dim_A);
+    for (unsigned int l = 0; l < n_lags; l++) {
+      const double *a = A[l];
+      double *c = C[l];
+      for (unsigned int k = k_start; k < k_end; k++)
+        c[k] += a[k]*B[k];
+    }
+  }
+}
+
+void square_distance_componentwise_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr ) {
+  int n_blocks = (dim_A + CORR_BLOCK - 1)/CORR_BLOCK;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_lags*dim_A >= CORR_OMP_MIN_SIZE)
+#endif
+  for (int b = 0; b < n_blocks; b++) {
+    unsigned int k_start = b*CORR_BLOCK;
+    unsigned int k_end = MIN(k_start + CORR_BLOCK, dim_A);
+    for (unsigned int l = 0; l < n_lags; l++) {
+      const double *a = A[l];
+      double *c = C[l];
+      for (unsigned int k = k_start; k < k_end; k++)
+        c[k] += (a[k]-B[k])*(a[k]-B[k]);
+    }
+  }
+}
+
 void autoupdate_correlations() {
   for (unsigned i=0; i<n_correlations; i++) {
     if (correlations[i].autoupdate && sim_time-correlations[i].last_update>correlations[i].dt*0.99999) {
@@ -182,6 +182,14 @@ typedef struct {
   // correlation function
   int (*corr_operation)  ( double* A, unsigned int dim_A, double* B, unsigned int dim_B, double* C, unsigned int dim_corr, void *args );
   char *corr_operation_name;
+  // the correlation function for all lags of a level at once, or 0
+  void (*corr_accumulate) ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr );
+
+  // scratch space for the update: the old values of A and the
+  // results at the lags of a level, and one correlation
+  double** lag_A;
+  double** lag_result;
+  double* temp;
 
   // Functions producing observables A and B from the input data
   observable* A_obs;
@@ -341,4 +349,20 @@ int square_distance_cond ( double* A, unsigned int dim_A, double* B, unsigned in
 
 int square_distance_cond_chain ( double* A, unsigned int dim_A, double* B, unsigned int dim_B, double* C, unsigned int dim_corr, void *args );
 
+/* *************************
+*
+* Correlation operations for many lags
+*
+* These add the correlation of A[l] with B to C[l] for all n_lags
+* lags l. The components are processed in blocks, so that the block of
+* B stays in the cache for all lags, and the blocks are distributed
+* over the OpenMP threads.
+*
+**************************/
+void scalar_product_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr );
+
+void componentwise_product_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr );
+
+void square_distance_componentwise_accumulate ( double** A, double* B, unsigned int n_lags, double** C, unsigned int dim_A, unsigned int dim_corr );
+
 #endif
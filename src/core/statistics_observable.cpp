@@ -19,6 +19,8 @@
 #include "statistics_observable.hpp"
 #include "statistics_correlation.hpp"
 #include "particle_data.hpp"
+#include "communication.hpp"
+#include "cells.hpp"
 #include "integrate.hpp"
 #include "lb.hpp"
 #include "pressure.hpp"
@@ -100,26 +102,235 @@ int observable_read(char *filename, observable *self, bool binary) {
   return ES_ERROR;
 }
 
-int observable_calc_particle_velocities(observable* self) {
-  double* A = self->last_value;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
+void transform_to_cylinder_coordinates(double x, double y, double z_, double* r, double* phi, double* z) {
+  *z =  z_;
+  *r =  sqrt(x*x+y*y);
+  *phi = atan2(y,x);
+}
+
+/************************************************************
+ * observables accumulated from the local particles
+ ************************************************************/
+
+/** Get the unfolded position and velocity of a particle, as they are
+    stored in \ref partCfg. */
+static void observable_unfolded_particle(Particle *p, double ppos[3], double v[3]) {
+  int img[3];
+  memmove(ppos, p->r.p, 3*sizeof(double));
+  memmove(v, p->m.v, 3*sizeof(double));
+  memmove(img, p->l.i, 3*sizeof(int));
+  unfold_position(ppos, v, img);
+}
+
+/** Add the contribution of particle p, which is entry i of the id
+    list, to the local result A. */
+static void observable_add_local_particle(observable_local_params *par, int i, Particle *p, double *A) {
+  double ppos[3], v[3];
+  int img[3] = {0, 0, 0};
+  int block;
+
+  observable_unfolded_particle(p, ppos, v);
+
+  switch (par->kind) {
+  case OBS_LOCAL_PARTICLE_VELOCITIES:
+    for (int dim = 0; dim < 3; dim++)
+      A[3*i + dim] = v[dim]/time_step;
+    break;
+  case OBS_LOCAL_PARTICLE_POSITIONS:
+    for (int dim = 0; dim < 3; dim++)
+      A[3*i + dim] = ppos[dim];
+    break;
+  case OBS_LOCAL_PARTICLE_FORCES:
+    for (int dim = 0; dim < 3; dim++)
+      A[3*i + dim] = p->f.f[dim]/time_step/time_step*2;
+    break;
+#ifdef ELECTROSTATICS
+  case OBS_LOCAL_PARTICLE_CURRENTS:
+    for (int dim = 0; dim < 3; dim++)
+      A[3*i + dim] = p->p.q * v[dim]/time_step;
+    break;
+  case OBS_LOCAL_CURRENTS:
+    for (int dim = 0; dim < 3; dim++)
+      A[dim] += p->p.q * v[dim]/time_step;
+    break;
+  case OBS_LOCAL_DIPOLE_MOMENT:
+    for (int dim = 0; dim < 3; dim++)
+      A[dim] += p->p.q * ppos[dim];
+    break;
+#endif
+  case OBS_LOCAL_COM_VELOCITY:
+  case OBS_LOCAL_COM_POSITION:
+  case OBS_LOCAL_COM_FORCE:
+    /* ids beyond the last complete block are ignored */
+    block = i/par->blocksize;
+    if (3*block >= par->mass_offset)
+      break;
+    for (int dim = 0; dim < 3; dim++) {
+      if (par->kind == OBS_LOCAL_COM_VELOCITY)
+        A[3*block + dim] += PMASS(*p)*v[dim]/time_step;
+      else if (par->kind == OBS_LOCAL_COM_POSITION)
+        A[3*block + dim] += PMASS(*p)*ppos[dim];
+      else
+        A[3*block + dim] += p->f.f[dim]/time_step/time_step*2;
+    }
+    if (par->kind != OBS_LOCAL_COM_FORCE)
+      A[par->mass_offset + block] += PMASS(*p);
+    break;
+  case OBS_LOCAL_DENSITY_PROFILE:
+  case OBS_LOCAL_FORCE_DENSITY_PROFILE: {
+    profile_data* pdata = &par->profile;
+    double bin_volume=(pdata->maxx-pdata->minx)*(pdata->maxy-pdata->miny)*(pdata->maxz-pdata->minz)/pdata->xbins/pdata->ybins/pdata->zbins;
+    /* We use folded coordinates here */
+    fold_position(ppos, img);
+    int binx= (int) floor( pdata->xbins*  (ppos[0]-pdata->minx)/(pdata->maxx-pdata->minx));
+    int biny= (int) floor( pdata->ybins*  (ppos[1]-pdata->miny)/(pdata->maxy-pdata->miny));
+    int binz= (int) floor( pdata->zbins*  (ppos[2]-pdata->minz)/(pdata->maxz-pdata->minz));
+    if (binx>=0 && binx < pdata->xbins && biny>=0 && biny < pdata->ybins && binz>=0 && binz < pdata->zbins) {
+      int bin = binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz;
+      if (par->kind == OBS_LOCAL_DENSITY_PROFILE)
+        A[bin] += 1./bin_volume;
+      else
+        for(int dim = 0; dim < 3; dim++)
+          A[3*bin + dim] += p->f.f[dim]/bin_volume;
+    }
+    break;
   }
-  ids=(IntList*) self->container;
+  case OBS_LOCAL_FLUX_DENSITY_PROFILE: {
+    profile_data* pdata = &par->profile;
+    double xbinsize=(pdata->maxx - pdata->minx)/pdata->xbins;
+    double ybinsize=(pdata->maxy - pdata->miny)/pdata->ybins;
+    double zbinsize=(pdata->maxz - pdata->minz)/pdata->zbins;
+    /* We use folded coordinates here */
+    fold_position(ppos, img);
+    int binx  =(int)floor((ppos[0]-pdata->minx)/xbinsize);
+    int biny  =(int)floor((ppos[1]-pdata->miny)/ybinsize);
+    int binz  =(int)floor((ppos[2]-pdata->minz)/zbinsize);
+    if (binx>=0 && binx < pdata->xbins && biny>=0 && biny < pdata->ybins && binz>=0 && binz < pdata->zbins) {
+      double bin_volume=xbinsize*ybinsize*zbinsize;
+      for(int dim = 0; dim < 3; dim++)
+        A[3*(binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz) + dim] += v[dim]/time_step/bin_volume;
+    }
+    break;
+  }
+  case OBS_LOCAL_RADIAL_DENSITY_PROFILE: {
+    radial_profile_data* pdata = &par->radial_profile;
+    double rbinsize=(pdata->maxr - pdata->minr)/pdata->rbins;
+    double phibinsize=(pdata->maxphi - pdata->minphi)/pdata->phibins;
+    double zbinsize=(pdata->maxz - pdata->minz)/pdata->zbins;
+    double r, phi, z;
+    /* We use folded coordinates here */
+    fold_position(ppos, img);
+    transform_to_cylinder_coordinates(ppos[0]-pdata->center[0], ppos[1]-pdata->center[1], ppos[2]-pdata->center[2], &r, &phi, &z);
+    int binr  =(int)floor((r-pdata->minr)/rbinsize);
+    int binphi=(int)floor((phi-pdata->minphi)/phibinsize);
+    int binz  =(int)floor((z-pdata->minz)/zbinsize);
+    if (binr>=0 && binr < pdata->rbins && binphi>=0 && binphi < pdata->phibins && binz>=0 && binz < pdata->zbins) {
+      double bin_volume=PI*((pdata->minr+(binr+1)*rbinsize)*(pdata->minr+(binr+1)*rbinsize) - (pdata->minr+(binr)*rbinsize)*(pdata->minr+(binr)*rbinsize)) *zbinsize * phibinsize/2/PI;
+      A[binr*pdata->phibins*pdata->zbins + binphi*pdata->zbins + binz] += 1./bin_volume;
+    }
+    break;
+  }
+  }
+}
+
+void observable_calc_local(observable_local_params *par, int *ids, double *A) {
+  int max_id = 0;
+  for (int i = 0; i < par->n_ids; i++)
+    if (ids[i] > max_id)
+      max_id = ids[i];
+  /* first and next entry of the id list for each particle, such that
+     the id list is processed in a single pass over the local cells */
+  int *first = (int*)Utils::malloc((max_id + 1)*sizeof(int));
+  int *next = (int*)Utils::malloc((par->n_ids + 1)*sizeof(int));
+  for (int id = 0; id <= max_id; id++)
+    first[id] = -1;
+  for (int i = par->n_ids - 1; i >= 0; i--) {
+    next[i] = -1;
+    if (ids[i] >= 0) {
+      next[i] = first[ids[i]];
+      first[ids[i]] = i;
+    }
+  }
+
+  for (int i = 0; i < par->n; i++)
+    A[i] = 0;
+  for (int c = 0; c < local_cells.n; c++) {
+    Cell *cell = local_cells.cell[c];
+    Particle *part = cell->part;
+    for (int j = 0; j < cell->n; j++) {
+      if (part[j].p.identity > max_id)
+        continue;
+      for (int i = first[part[j].p.identity]; i != -1; i = next[i])
+        observable_add_local_particle(par, i, &part[j], A);
+    }
+  }
+  free(next);
+  free(first);
+}
+
+/** Set up the parameters of an observable that is calculated from the
+    local particles of all nodes.
+    @return 1 if one of the ids is not a particle, otherwise 0.
+*/
+static int observable_local_init(observable_local_params *par, int kind, IntList *ids, int n) {
+  if (!particle_node)
+    build_particle_node();
   for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
+    if (ids->e[i] < 0 || ids->e[i] > max_seen_particle || particle_node[ids->e[i]] == -1)
       return 1;
-    A[3*i + 0] = partCfg[ids->e[i]].m.v[0]/time_step;
-    A[3*i + 1] = partCfg[ids->e[i]].m.v[1]/time_step;
-    A[3*i + 2] = partCfg[ids->e[i]].m.v[2]/time_step;
   }
+  memset(par, 0, sizeof(observable_local_params));
+  par->kind = kind;
+  par->n = n;
+  par->n_ids = ids->n;
+  par->blocksize = ids->n;
+  par->mass_offset = n;
   return 0;
 }
 
+/** Calculate an observable of the particles in the id list stored in
+    the container of the observable. */
+static int observable_calc_local_ids(observable* self, int kind) {
+  observable_local_params par;
+  IntList* ids=(IntList*) self->container;
+  if (observable_local_init(&par, kind, ids, self->n))
+    return 1;
+  mpi_observable_local(&par, ids->e, self->last_value);
+  return 0;
+}
+
+/** Calculate the center of mass velocities, positions or total forces
+    of consecutive blocks of the id list, one block for each 3
+    entries of the observable. The masses of the blocks are summed up
+    together with the observable. */
+static int observable_calc_local_blocked_com(observable* self, int kind) {
+  observable_local_params par;
+  IntList* ids=(IntList*) self->container;
+  int n_blocks=self->n/3;
+  double* A = self->last_value;
+
+  if (observable_local_init(&par, kind, ids, 4*n_blocks))
+    return 1;
+  par.blocksize=ids->n/n_blocks;
+  par.mass_offset=3*n_blocks;
+  double* sum = (double*) Utils::malloc(par.n*sizeof(double));
+  mpi_observable_local(&par, ids->e, sum);
+  for (int block = 0; block < n_blocks; block++ ) {
+    for (int dim = 0; dim < 3; dim++) {
+      if (kind == OBS_LOCAL_COM_FORCE)
+        A[3*block + dim] = sum[3*block + dim];
+      else
+        A[3*block + dim] = sum[3*block + dim]/sum[par.mass_offset + block];
+    }
+  }
+  free(sum);
+  return 0;
+}
+
+int observable_calc_particle_velocities(observable* self) {
+  return observable_calc_local_ids(self, OBS_LOCAL_PARTICLE_VELOCITIES);
+}
+
 int observable_calc_particle_body_velocities(observable* self) {
   double* A = self->last_value;
   IntList* ids;
@@ -238,335 +449,62 @@ int observable_calc_particle_body_angular_momentum(observable* self) {
 
 #ifdef ELECTROSTATICS
 int observable_calc_particle_currents(observable* self) {
-  double* A = self->last_value;
-  double charge;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-    charge = partCfg[ids->e[i]].p.q;
-    A[3*i + 0] = charge * partCfg[ids->e[i]].m.v[0]/time_step;
-    A[3*i + 1] = charge * partCfg[ids->e[i]].m.v[1]/time_step;
-    A[3*i + 2] = charge * partCfg[ids->e[i]].m.v[2]/time_step;
-  }
-  return 0;
+  return observable_calc_local_ids(self, OBS_LOCAL_PARTICLE_CURRENTS);
 }
 
 int observable_calc_currents(observable* self) {
-  double* A = self->last_value;
-  double charge;
-  double j[3] = {0. , 0., 0. } ;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] > n_part)
-      return 1;
-    charge = partCfg[ids->e[i]].p.q;
-    j[0] += charge * partCfg[ids->e[i]].m.v[0]/time_step;
-    j[1] += charge * partCfg[ids->e[i]].m.v[1]/time_step;
-    j[2] += charge * partCfg[ids->e[i]].m.v[2]/time_step;
-  }
-  A[0]=j[0];
-  A[1]=j[1];
-  A[2]=j[2];
-  return 0;
+  return observable_calc_local_ids(self, OBS_LOCAL_CURRENTS);
 }
 
 int observable_calc_dipole_moment(observable* self) {
-  double* A = self->last_value;
-  double charge;
-  double j[3] = {0. , 0., 0. } ;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] > n_part)
-      return 1;
-    charge = partCfg[ids->e[i]].p.q;
-    j[0] += charge * partCfg[ids->e[i]].r.p[0];
-    j[1] += charge * partCfg[ids->e[i]].r.p[1];
-    j[2] += charge * partCfg[ids->e[i]].r.p[2];
-  }
-  A[0]=j[0];
-  A[1]=j[1];
-  A[2]=j[2];
-  return 0;
+  return observable_calc_local_ids(self, OBS_LOCAL_DIPOLE_MOMENT);
 }
 #endif
 
 int observable_calc_com_velocity(observable* self) {
-  double* A = self->last_value;
-  double v_com[3] = { 0. , 0., 0. } ;
-  double total_mass = 0;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-    v_com[0] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].m.v[0]/time_step;
-    v_com[1] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].m.v[1]/time_step;
-    v_com[2] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].m.v[2]/time_step;
-    total_mass += PMASS(partCfg[ids->e[i]]);
-  }
-  A[0]=v_com[0]/total_mass;
-  A[1]=v_com[1]/total_mass;
-  A[2]=v_com[2]/total_mass;
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_VELOCITY);
 }
 
 int observable_calc_blocked_com_velocity(observable* self) {
-  double* A = self->last_value;
-  unsigned int i;
-  unsigned int block;
-  unsigned int n_blocks;
-  unsigned int blocksize;
-  unsigned int id;
-  double total_mass = 0;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  n_blocks=self->n/3; 
-  blocksize=ids->n/n_blocks;
-  for ( block = 0; block < n_blocks; block++ ) {
-    total_mass = 0;
-    for ( i = 0; i < blocksize; i++ ) {
-      id = ids->e[block*blocksize+i];
-      if (ids->e[i] >= n_part)
-        return 1;
-      A[3*block+0] +=  PMASS(partCfg[id])*partCfg[id].m.v[0]/time_step;
-      A[3*block+1] +=  PMASS(partCfg[id])*partCfg[id].m.v[1]/time_step;
-      A[3*block+2] +=  PMASS(partCfg[id])*partCfg[id].m.v[2]/time_step;
-      total_mass += PMASS(partCfg[ids->e[i]]);
-    }
-    A[3*block+0] /=  total_mass;
-    A[3*block+1] /=  total_mass;
-    A[3*block+2] /=  total_mass;
-  }
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_VELOCITY);
 }
 
 int observable_calc_blocked_com_position(observable* self) {
-  double* A = self->last_value;
-  unsigned int i;
-  unsigned int block;
-  unsigned int n_blocks;
-  unsigned int blocksize;
-  unsigned int id;
-  double total_mass = 0;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  n_blocks=self->n/3; 
-  blocksize=ids->n/n_blocks;
-  for ( block = 0; block < n_blocks; block++ ) {
-    total_mass = 0;
-    for ( i = 0; i < blocksize; i++ ) {
-      id = ids->e[block*blocksize+i];
-      if (ids->e[i] >= n_part)
-        return 1;
-      A[3*block+0] +=  PMASS(partCfg[id])*partCfg[id].r.p[0];
-      A[3*block+1] +=  PMASS(partCfg[id])*partCfg[id].r.p[1];
-      A[3*block+2] +=  PMASS(partCfg[id])*partCfg[id].r.p[2];
-      total_mass += PMASS(partCfg[ids->e[i]]);
-    }
-    A[3*block+0] /=  total_mass;
-    A[3*block+1] /=  total_mass;
-    A[3*block+2] /=  total_mass;
-  }
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_POSITION);
 }
 
 int observable_calc_com_position(observable* self) {
-  double* A = self->last_value;
-  double p_com[3] = { 0. , 0., 0. } ;
-  double total_mass = 0;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-    p_com[0] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].r.p[0];
-    p_com[1] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].r.p[1];
-    p_com[2] += PMASS(partCfg[ids->e[i]])*partCfg[ids->e[i]].r.p[2];
-    total_mass += PMASS(partCfg[ids->e[i]]);
-  }
-  A[0]=p_com[0]/total_mass;
-  A[1]=p_com[1]/total_mass;
-  A[2]=p_com[2]/total_mass;
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_POSITION);
 }
 
 
 int observable_calc_com_force(observable* self) {
-  double* A = self->last_value;
-  double f_com[3] = { 0. , 0., 0. } ;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-    f_com[0] += partCfg[ids->e[i]].f.f[0]/time_step/time_step*2;
-    f_com[1] += partCfg[ids->e[i]].f.f[1]/time_step/time_step*2;
-    f_com[2] += partCfg[ids->e[i]].f.f[2]/time_step/time_step*2;
-  }
-  A[0]=f_com[0];
-  A[1]=f_com[1];
-  A[2]=f_com[2];
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_FORCE);
 }
 
 
 int observable_calc_blocked_com_force(observable* self) {
-  double* A = self->last_value;
-  unsigned int i;
-  unsigned int block;
-  unsigned int n_blocks;
-  unsigned int blocksize;
-  unsigned int id;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  n_blocks=self->n/3; 
-  blocksize=ids->n/n_blocks;
-  for ( block = 0; block < n_blocks; block++ ) {
-    for ( i = 0; i < blocksize; i++ ) {
-      id = ids->e[block*blocksize+i];
-      if (ids->e[i] >= n_part)
-        return 1;
-      A[3*block+0] +=  partCfg[id].f.f[0]/time_step/time_step*2;
-      A[3*block+1] +=  partCfg[id].f.f[1]/time_step/time_step*2;
-      A[3*block+2] +=  partCfg[id].f.f[2]/time_step/time_step*2;
-    }
-  }
-  return 0;
+  return observable_calc_local_blocked_com(self, OBS_LOCAL_COM_FORCE);
 }
 
 
 int observable_calc_density_profile(observable* self) {
-  double* A = self->last_value;
-  int binx, biny, binz;
-  double ppos[3];
-  int img[3];
-  IntList* ids;
-  profile_data* pdata;
-
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  pdata=(profile_data*) self->container;
-  ids=pdata->id_list;
-  double bin_volume=(pdata->maxx-pdata->minx)*(pdata->maxy-pdata->miny)*(pdata->maxz-pdata->minz)/pdata->xbins/pdata->ybins/pdata->zbins;
-    
-  for ( int i = 0; i<self->n; i++ ) {
-    A[i]=0;
-  }
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-/* We use folded coordinates here */
-    memmove(ppos, partCfg[ids->e[i]].r.p, 3*sizeof(double));
-    memmove(img, partCfg[ids->e[i]].l.i, 3*sizeof(int));
-    fold_position(ppos, img);
-    binx= (int) floor( pdata->xbins*  (ppos[0]-pdata->minx)/(pdata->maxx-pdata->minx));
-    biny= (int) floor( pdata->ybins*  (ppos[1]-pdata->miny)/(pdata->maxy-pdata->miny));
-    binz= (int) floor( pdata->zbins*  (ppos[2]-pdata->minz)/(pdata->maxz-pdata->minz));
-    if (binx>=0 && binx < pdata->xbins && biny>=0 && biny < pdata->ybins && binz>=0 && binz < pdata->zbins) {
-      A[binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz] += 1./bin_volume;
-    } 
-  }
+  observable_local_params par;
+  profile_data* pdata=(profile_data*) self->container;
+  if (observable_local_init(&par, OBS_LOCAL_DENSITY_PROFILE, pdata->id_list, self->n))
+    return 1;
+  par.profile = *pdata;
+  mpi_observable_local(&par, pdata->id_list->e, self->last_value);
   return 0;
 }
 
 int observable_calc_force_density_profile(observable* self) {
-  double* A = self->last_value;
-  int binx, biny, binz;
-  double ppos[3];
-  int img[3];
-  IntList* ids;
-  profile_data* pdata;
-
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  pdata=(profile_data*) self->container;
-  ids=pdata->id_list;
-  double bin_volume=(pdata->maxx-pdata->minx)*(pdata->maxy-pdata->miny)*(pdata->maxz-pdata->minz)/pdata->xbins/pdata->ybins/pdata->zbins;
-    
-  for ( int i = 0; i<self->n; i++ ) {
-    A[i]=0;
-  }
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-/* We use folded coordinates here */
-    memmove(ppos, partCfg[ids->e[i]].r.p, 3*sizeof(double));
-    memmove(img, partCfg[ids->e[i]].l.i, 3*sizeof(int));
-    fold_position(ppos, img);
-    binx= (int) floor( pdata->xbins*  (ppos[0]-pdata->minx)/(pdata->maxx-pdata->minx));
-    biny= (int) floor( pdata->ybins*  (ppos[1]-pdata->miny)/(pdata->maxy-pdata->miny));
-    binz= (int) floor( pdata->zbins*  (ppos[2]-pdata->minz)/(pdata->maxz-pdata->minz));
-    if (binx>=0 && binx < pdata->xbins && biny>=0 && biny < pdata->ybins && binz>=0 && binz < pdata->zbins) {
-      for(int dim = 0; dim < 3; dim++)
-        A[3*(binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz) + dim] += partCfg[ids->e[i]].f.f[dim]/bin_volume;
-    } 
-  }
+  observable_local_params par;
+  profile_data* pdata=(profile_data*) self->container;
+  if (observable_local_init(&par, OBS_LOCAL_FORCE_DENSITY_PROFILE, pdata->id_list, self->n))
+    return 1;
+  par.profile = *pdata;
+  mpi_observable_local(&par, pdata->id_list->e, self->last_value);
   return 0;
 }
 
@@ -789,55 +727,13 @@ int mpi_observable_lb_radial_velocity_profile_parallel(void* pdata_, double* A,
 }
 #endif
 
-void transform_to_cylinder_coordinates(double x, double y, double z_, double* r, double* phi, double* z) {
-  *z =  z_;
-  *r =  sqrt(x*x+y*y);
-  *phi = atan2(y,x);
-}
-
 int observable_calc_radial_density_profile(observable* self) {
-  double* A = self->last_value;
-  int binr, binphi, binz;
-  double ppos[3];
-  double r, phi, z;
-  int img[3];
-  double bin_volume;
-  IntList* ids;
-  
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  radial_profile_data* pdata;
-  pdata=(radial_profile_data*) self->container;
-  ids=pdata->id_list;
-  double rbinsize=(pdata->maxr - pdata->minr)/pdata->rbins;
-  double phibinsize=(pdata->maxphi - pdata->minphi)/pdata->phibins;
-  double zbinsize=(pdata->maxz - pdata->minz)/pdata->zbins;
-    
-  for (int i = 0; i< self->n; i++ ) {
-    A[i]=0;
-  }
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-/* We use folded coordinates here */
-    memmove(ppos, partCfg[ids->e[i]].r.p, 3*sizeof(double));
-    memmove(img, partCfg[ids->e[i]].l.i, 3*sizeof(int));
-    fold_position(ppos, img);
-    transform_to_cylinder_coordinates(ppos[0]-pdata->center[0], ppos[1]-pdata->center[1], ppos[2]-pdata->center[2], &r, &phi, &z);
-    //printf("%f %f %f %f %f %f\n", ppos[0], ppos[1], ppos[2], r*cos(phi)+pdata->center[0], r*sin(phi)+pdata->center[1], z+pdata->center[2]);
-    binr  =(int)floor((r-pdata->minr)/rbinsize);
-    binphi=(int)floor((phi-pdata->minphi)/phibinsize);
-    binz  =(int)floor((z-pdata->minz)/zbinsize);
-
-    if (binr>=0 && binr < pdata->rbins && binphi>=0 && binphi < pdata->phibins && binz>=0 && binz < pdata->zbins) {
-      bin_volume=PI*((pdata->minr+(binr+1)*rbinsize)*(pdata->minr+(binr+1)*rbinsize) - (pdata->minr+(binr)*rbinsize)*(pdata->minr+(binr)*rbinsize)) *zbinsize * phibinsize/2/PI;
-      A[binr*pdata->phibins*pdata->zbins + binphi*pdata->zbins + binz] += 1./bin_volume;
-    } 
-  }
+  observable_local_params par;
+  radial_profile_data* pdata=(radial_profile_data*) self->container;
+  if (observable_local_init(&par, OBS_LOCAL_RADIAL_DENSITY_PROFILE, pdata->id_list, self->n))
+    return 1;
+  par.radial_profile = *pdata;
+  mpi_observable_local(&par, pdata->id_list->e, self->last_value);
   return 0;
 }
 
@@ -930,105 +826,21 @@ int observable_calc_radial_flux_density_profile(observable* self) {
 }
 
 int observable_calc_flux_density_profile(observable* self) {
-  double* A = self->last_value;
-  int binx, biny, binz;
-  double ppos[3];
-  double x, y, z;
-  int img[3];
-  double bin_volume;
-  IntList* ids;
-
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  profile_data* pdata;
-  pdata=(profile_data*) self->container;
-  ids=pdata->id_list;
-  double xbinsize=(pdata->maxx - pdata->minx)/pdata->xbins;
-  double ybinsize=(pdata->maxy - pdata->miny)/pdata->ybins;
-  double zbinsize=(pdata->maxz - pdata->minz)/pdata->zbins;
-  double v[3];
-  double v_x, v_y, v_z;
-    
-  for (int i = 0; i< self->n; i++ ) {
-    A[i]=0;
-  }
-
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-    /* We use folded coordinates here */
-    v[0]=partCfg[ids->e[i]].m.v[0]/time_step;
-    v[1]=partCfg[ids->e[i]].m.v[1]/time_step;
-    v[2]=partCfg[ids->e[i]].m.v[2]/time_step;
-    memmove(ppos, partCfg[ids->e[i]].r.p, 3*sizeof(double));
-    memmove(img, partCfg[ids->e[i]].l.i, 3*sizeof(int));
-    fold_position(ppos, img);
-    // The position of the particle is by definition the middle of old and new position
-  
-    x=ppos[0];
-    y=ppos[1];
-    z=ppos[2];
-
-    binx  =(int)floor((x-pdata->minx)/xbinsize);
-    biny  =(int)floor((y-pdata->miny)/ybinsize);
-    binz  =(int)floor((z-pdata->minz)/zbinsize);
-
-
-    if (binx>=0 && binx < pdata->xbins && biny>=0 && biny < pdata->ybins && binz>=0 && binz < pdata->zbins) {
-      bin_volume=xbinsize*ybinsize*zbinsize;
-      v_x=v[0];
-      v_y=v[1];
-      v_z=v[2];
-      A[3*(binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz) + 0] += v_x/bin_volume;
-      A[3*(binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz) + 1] += v_y/bin_volume;
-      A[3*(binx*pdata->ybins*pdata->zbins + biny*pdata->zbins + binz) + 2] += v_z/bin_volume;
-    } 
-  }
+  observable_local_params par;
+  profile_data* pdata=(profile_data*) self->container;
+  if (observable_local_init(&par, OBS_LOCAL_FLUX_DENSITY_PROFILE, pdata->id_list, self->n))
+    return 1;
+  par.profile = *pdata;
+  mpi_observable_local(&par, pdata->id_list->e, self->last_value);
   return 0;
 }
 
 int observable_calc_particle_positions(observable* self) {
-  double* A = self->last_value;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-      A[3*i + 0] = partCfg[ids->e[i]].r.p[0];
-      A[3*i + 1] = partCfg[ids->e[i]].r.p[1];
-      A[3*i + 2] = partCfg[ids->e[i]].r.p[2];
-  }
-  return 0;
+  return observable_calc_local_ids(self, OBS_LOCAL_PARTICLE_POSITIONS);
 }
 
 int observable_calc_particle_forces(observable* self) {
-  double* A = self->last_value;
-  IntList* ids;
-  if (!sortPartCfg()) {
-      ostringstream msg;
-      msg <<"could not sort partCfg";
-      runtimeError(msg);
-    return -1;
-  }
-  ids=(IntList*) self->container;
-  for (int i = 0; i<ids->n; i++ ) {
-    if (ids->e[i] >= n_part)
-      return 1;
-      A[3*i + 0] = partCfg[ids->e[i]].f.f[0]/time_step/time_step*2;
-      A[3*i + 1] = partCfg[ids->e[i]].f.f[1]/time_step/time_step*2;
-      A[3*i + 2] = partCfg[ids->e[i]].f.f[2]/time_step/time_step*2;
-  }
-  return 0;
+  return observable_calc_local_ids(self, OBS_LOCAL_PARTICLE_FORCES);
 }
 
 
@@ -1341,9 +1153,6 @@ int observable_calc_interacts_with (observable* self) {
 }
 
 int observable_calc_rdf(observable* self){
-  if (!sortPartCfg()) {
-    return 1;
-  }
   double * last = self->last_value;
   rdf_profile_data * rdf_data = (rdf_profile_data *) self->container;
   calc_rdf(rdf_data->p1_types, rdf_data->n_p1,
@@ -172,6 +172,51 @@ typedef struct {
 
 void mpi_observable_lb_radial_velocity_profile_slave_implementation();
 
+/** Observables that are accumulated from the particles of each node
+    and summed up on the master, see \ref observable_calc_local. */
+enum ObservableLocalKind {
+  OBS_LOCAL_PARTICLE_VELOCITIES,
+  OBS_LOCAL_PARTICLE_POSITIONS,
+  OBS_LOCAL_PARTICLE_FORCES,
+  OBS_LOCAL_PARTICLE_CURRENTS,
+  OBS_LOCAL_CURRENTS,
+  OBS_LOCAL_DIPOLE_MOMENT,
+  OBS_LOCAL_COM_VELOCITY,
+  OBS_LOCAL_COM_POSITION,
+  OBS_LOCAL_COM_FORCE,
+  OBS_LOCAL_DENSITY_PROFILE,
+  OBS_LOCAL_FORCE_DENSITY_PROFILE,
+  OBS_LOCAL_FLUX_DENSITY_PROFILE,
+  OBS_LOCAL_RADIAL_DENSITY_PROFILE
+};
+
+/** Parameters of an observable calculated from the local particles.
+    The struct is broadcasted bytewise, so the pointers in the profile
+    data must not be used on the slaves. */
+typedef struct {
+  int kind;
+  /** number of entries of the result, including the masses */
+  int n;
+  /** number of particle ids */
+  int n_ids;
+  /** number of particles per block of the center of mass observables */
+  int blocksize;
+  /** first entry of the masses of the blocks in the result */
+  int mass_offset;
+  profile_data profile;
+  radial_profile_data radial_profile;
+} observable_local_params;
+
+/** Accumulate the contributions of the real particles of this node
+    with the given ids. Every entry of A that depends on a single
+    particle is only set by the node holding it, so the results of all
+    nodes can simply be summed up, see \ref mpi_observable_local.
+    @param par the parameters of the observable.
+    @param ids the particle ids (size: par->n_ids).
+    @param A   the local contributions (size: par->n).
+*/
+void observable_calc_local(observable_local_params *par, int *ids, double *A);
+
 int observable_radial_density_distribution(observable* self);
 
 typedef struct { 
@@ -66,6 +66,21 @@
  #error "No noise function defined"
 #endif
 
+/** Four values of the noise function selected above from the counter
+    based generator, see \ref counter_random_uniform. */
+inline void counter_noise(int stream, int id1, int id2, double rnd[4])
+{
+#if defined (FLATNOISE)
+  counter_random_uniform(stream, id1, id2, 0, rnd);
+  for (int i = 0; i < 4; i++)
+    rnd[i] -= 0.5;
+#elif defined (GAUSSRANDOMCUT)
+  counter_random_gaussian_cut(stream, id1, id2, 0, rnd);
+#else
+  counter_random_gaussian(stream, id1, id2, 0, rnd);
+#endif
+}
+
 
 
 
@@ -282,6 +297,12 @@ inline void friction_thermo_langevin(Particle *p)
     }
 #endif /* MULTI_TIMESTEP */
 
+  // Noise from the counter based generator, which does not depend on
+  // the order in which the particles are visited
+  double rnd[4];
+  int use_counter = rng_counter_mask & THERMO_LANGEVIN;
+  if (use_counter)
+    counter_noise(RNG_STREAM_LANGEVIN, p->p.identity, 0, rnd);
   
   // Do the actual thermostatting
   for ( j = 0 ; j < 3 ; j++) 
@@ -294,7 +315,7 @@ inline void friction_thermo_langevin(Particle *p)
     #endif
     {
       // Apply the force
-      p->f.f[j] = langevin_pref1_temp*velocity[j] + switch_trans*langevin_pref2_temp*noise;
+      p->f.f[j] = langevin_pref1_temp*velocity[j] + switch_trans*langevin_pref2_temp*(use_counter ? rnd[j] : noise);
     }
   } // END LOOP OVER ALL COMPONENTS
 
@@ -326,13 +347,18 @@ inline void friction_thermo_langevin_rotation(Particle *p)
   // so no switching here
 
 
+  double rnd[4];
+  int use_counter = rng_counter_mask & THERMO_LANGEVIN;
+  if (use_counter)
+    counter_noise(RNG_STREAM_LANGEVIN_ROT, p->p.identity, 0, rnd);
+
   // Here the thermostats happens
   for ( j = 0 ; j < 3 ; j++) 
   {
 #ifdef ROTATIONAL_INERTIA
-    p->f.torque[j] = -langevin_gamma_rotation*p->m.omega[j] + switch_rotate*langevin_pref2_rotation*noise;
+    p->f.torque[j] = -langevin_gamma_rotation*p->m.omega[j] + switch_rotate*langevin_pref2_rotation*(use_counter ? rnd[j] : noise);
 #else
-    p->f.torque[j] = -langevin_gamma_rotation*p->m.omega[j] + switch_rotate*langevin_pref2_rotation*noise;
+    p->f.torque[j] = -langevin_gamma_rotation*p->m.omega[j] + switch_rotate*langevin_pref2_rotation*(use_counter ? rnd[j] : noise);
 #endif
   }
 
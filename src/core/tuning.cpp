@@ -28,10 +28,16 @@
 #include "errorhandling.hpp"
 #include "integrate.hpp"
 #include "global.hpp"
+#include "tuning.hpp"
 #include <limits>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
 
 int timing_samples = 0;
 
+char *tune_cache_file = NULL;
+
 /* timing helper variables */
 static struct rusage time1, time2;
 
@@ -104,3 +110,107 @@ void tune_skin(double min, double max, double tol, int steps) {
   skin = 0.5*(a+b);
   mpi_bcast_parameter(FIELD_SKIN);    
 }
+
+/************************************************************/
+
+void tune_cache_set_file(const char *file)
+{
+  if (tune_cache_file)
+    free(tune_cache_file);
+  tune_cache_file = NULL;
+  if (file) {
+    tune_cache_file = (char *)Utils::malloc(strlen(file) + 1);
+    strcpy(tune_cache_file, file);
+  }
+}
+
+/** read the next entry of the cache file. Returns 0 at the end of the
+    file, -1 for an entry that does not fit the given sizes. */
+static int tune_cache_read_entry(FILE *f, char *method, double *key, int n_key,
+				 double *result, int n_result)
+{
+  char line[1024];
+  int pos, n, i, len;
+
+  if (!fgets(line, sizeof(line), f))
+    return 0;
+  if (sscanf(line, "%63s %d%n", method, &len, &pos) != 2 || len != n_key)
+    return -1;
+  for (i = 0; i < n_key; i++) {
+    if (sscanf(line + pos, "%lf%n", &key[i], &n) != 1)
+      return -1;
+    pos += n;
+  }
+  if (sscanf(line + pos, "%d%n", &len, &n) != 1 || len != n_result)
+    return -1;
+  pos += n;
+  for (i = 0; i < n_result; i++) {
+    if (sscanf(line + pos, "%lf%n", &result[i], &n) != 1)
+      return -1;
+    pos += n;
+  }
+  return 1;
+}
+
+int tune_cache_lookup(const char *method, double *key, int n_key, int n_exact,
+		      double *result, int n_result)
+{
+  char e_method[64];
+  double e_key[TUNE_CACHE_MAX], e_result[TUNE_CACHE_MAX];
+  double dist, best_dist = -1;
+  int i, ret, found = TUNE_CACHE_MISS;
+  FILE *f;
+
+  if (!tune_cache_file || n_key > TUNE_CACHE_MAX || n_result > TUNE_CACHE_MAX)
+    return TUNE_CACHE_MISS;
+  if (!(f = fopen(tune_cache_file, "r")))
+    return TUNE_CACHE_MISS;
+
+  while ((ret = tune_cache_read_entry(f, e_method, e_key, n_key, e_result, n_result)) != 0) {
+    if (ret < 0 || strcmp(e_method, method) != 0)
+      continue;
+    for (i = 0; i < n_exact; i++)
+      if (fabs(e_key[i] - key[i]) > TUNE_CACHE_PREC*fabs(key[i]))
+	break;
+    if (i < n_exact)
+      continue;
+    /* relative distance in the remaining, positive key values */
+    dist = 0;
+    for (; i < n_key; i++) {
+      if (e_key[i] <= 0 || key[i] <= 0)
+	dist += (e_key[i] == key[i]) ? 0 : 1;
+      else
+	dist += fabs(log(e_key[i]/key[i]));
+    }
+    /* later entries take precedence */
+    if (best_dist < 0 || dist <= best_dist) {
+      best_dist = dist;
+      memcpy(result, e_result, n_result*sizeof(double));
+      found = (dist <= n_key*TUNE_CACHE_PREC) ? TUNE_CACHE_HIT : TUNE_CACHE_NEAREST;
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+void tune_cache_store(const char *method, double *key, int n_key,
+		      double *result, int n_result)
+{
+  FILE *f;
+  int i;
+
+  if (!tune_cache_file)
+    return;
+  if (!(f = fopen(tune_cache_file, "a"))) {
+    fprintf(stderr, "%d: cannot write tuning cache %s\n", this_node, tune_cache_file);
+    return;
+  }
+  fprintf(f, "%s %d", method, n_key);
+  for (i = 0; i < n_key; i++)
+    fprintf(f, " %.17g", key[i]);
+  fprintf(f, " %d", n_result);
+  for (i = 0; i < n_result; i++)
+    fprintf(f, " %.17g", result[i]);
+  fprintf(f, "\n");
+  fclose(f);
+}
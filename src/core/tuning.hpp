@@ -47,4 +47,58 @@ double diffTime();
  */
 void tune_skin(double min, double max, double tol, int steps);
 
+/** \name Tuning cache
+    The results of the parameter tuning of the long range methods can
+    be stored in a text file, so that later runs of the same system do
+    not have to repeat the timings. Each entry consists of the name of
+    the tuned method, a key describing the system and the tuning
+    result. The first values of the key have to match exactly, like the
+    node grid or the accuracy, the remaining ones, like the box length
+    or the number of charges, are used to find the nearest entry for a
+    warm start of the tuning. The cache is only accessed on the master
+    node. */
+/*@{*/
+
+/** maximal length of the key and the result of a cache entry. */
+#define TUNE_CACHE_MAX 24
+/** relative tolerance for two key values to be considered equal. */
+#define TUNE_CACHE_PREC 1e-10
+
+/** \ref tune_cache_lookup found an entry with exactly the same key. */
+#define TUNE_CACHE_HIT     0
+/** \ref tune_cache_lookup found only an entry with a similar key. */
+#define TUNE_CACHE_NEAREST 1
+/** \ref tune_cache_lookup did not find any usable entry. */
+#define TUNE_CACHE_MISS    2
+
+/** name of the tuning cache file, or NULL if the tuning is not cached. */
+extern char *tune_cache_file;
+
+/** set the name of the tuning cache file. NULL switches the cache off. */
+void tune_cache_set_file(const char *file);
+
+/** look up a tuning result in the cache.
+    @param method  name of the tuned method, e.g. "p3m".
+    @param key     the key of the system to look up.
+    @param n_key   the length of the key.
+    @param n_exact how many of the first key values have to match exactly.
+    @param result  the cached result, if any.
+    @param n_result the length of the result.
+    @return \ref TUNE_CACHE_HIT, \ref TUNE_CACHE_NEAREST or \ref TUNE_CACHE_MISS.
+*/
+int tune_cache_lookup(const char *method, double *key, int n_key, int n_exact,
+		      double *result, int n_result);
+
+/** append a tuning result to the cache. Later entries take precedence
+    over earlier entries with the same key.
+    @param method  name of the tuned method, e.g. "p3m".
+    @param key     the key of the system.
+    @param n_key   the length of the key.
+    @param result  the tuning result.
+    @param n_result the length of the result.
+*/
+void tune_cache_store(const char *method, double *key, int n_key,
+		      double *result, int n_result);
+/*@}*/
+
 #endif
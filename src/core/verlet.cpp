@@ -24,6 +24,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #include "utils.hpp"
 #include "verlet.hpp"
 #include "cells.hpp"
@@ -52,20 +53,20 @@
 
 /** Add a particle pair to a verlet pair list.
     Checks verlet pair list size and reallocates memory if necessary.
- *  \param p1 Pointer to particle one.
- *  \param p2 Pointer to particle two.
+ *  \param i  Index of particle one in the local cell.
+ *  \param j  Index of particle two in the neighbor cell.
  *  \param pl Pointer to the verlet pair list.
  */
-inline void add_pair(PairList *pl, Particle *p1, Particle *p2)
+inline void add_pair(PairList *pl, int i, int j)
 {
   /* check size of verlet List */
   if(pl->n+1 >= pl->max) {
     pl->max += LIST_INCREMENT;
-    pl->pair = (Particle **)Utils::realloc(pl->pair, 2*pl->max*sizeof(Particle *));
+    pl->pair = (int *)Utils::realloc(pl->pair, 2*pl->max*sizeof(int));
   }
   /* add pair */
-  pl->pair[(2*pl->n)  ] = p1;
-  pl->pair[(2*pl->n)+1] = p2;
+  pl->pair[(2*pl->n)  ] = i;
+  pl->pair[(2*pl->n)+1] = j;
   /* increase number of pairs */
   pl->n++;
 }
@@ -89,7 +90,7 @@ void free_pairList(PairList *list)
 {
   list->n       = 0;
   list->max     = 0;
-  list->pair = (Particle **)Utils::realloc(list->pair, 0);
+  list->pair = (int *)Utils::realloc(list->pair, 0);
 }
 
 void build_verlet_lists()
@@ -147,7 +148,7 @@ void build_verlet_lists()
           {
             dist2 = distance2(p1[i].r.p, p2[j].r.p);
             if(dist2 <= SQR(get_ia_param(p1[i].p.type, p2[j].p.type)->max_cut + skin))
-              add_pair(pl, &p1[i], &p2[j]);
+              add_pair(pl, i, j);
           }
         }
       }
@@ -164,38 +165,73 @@ void build_verlet_lists()
 
 void calculate_verlet_ia()
 {
-  int c, np, n, i;
+  int c, np, n, i, *pairs;
   Cell *cell;
-  Particle *p1, *p2, **pairs;
+  Particle *part1, *part2, *p1, *p2;
   double dist2, vec21[3];
 
   /* Loop local cells */
   for (c = 0; c < local_cells.n; c++) {
     cell = local_cells.cell[c];
-    p1   = cell->part;
+    part1 = cell->part;
     np  = cell->n;
     /* calculate bonded interactions (loop local particles) */
     for(i = 0; i < np; i++)  {
 #ifdef MULTI_TIMESTEP
-      if (p1[i].p.smaller_timestep==current_time_step_is_small || smaller_time_step < 0.)
+      if (part1[i].p.smaller_timestep==current_time_step_is_small || smaller_time_step < 0.)
 #endif
       {
-        add_bonded_force(&p1[i]);
+        add_bonded_force(&part1[i]);
 #ifdef CONSTRAINTS
-        add_constraints_forces(&p1[i]);
+        add_constraints_forces(&part1[i]);
 #endif
-        add_external_potential_forces(&p1[i]);
+        add_external_potential_forces(&part1[i]);
       }
     }
 
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      part2 = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
       /* verlet list loop */
       for(i=0; i<2*np; i+=2) {
-        p1 = pairs[i];                    /* pointer to particle 1 */
-        p2 = pairs[i+1];                  /* pointer to particle 2 */
+        p1 = &part1[pairs[i]];            /* pointer to particle 1 */
+        p2 = &part2[pairs[i+1]];          /* pointer to particle 2 */
+#ifdef MULTI_TIMESTEP
+        if (smaller_time_step < 0. 
+            || (p1->p.smaller_timestep==0 && p2->p.smaller_timestep==0 && current_time_step_is_small==0)
+            || (!(p1->p.smaller_timestep==0 && p2->p.smaller_timestep==0) && current_time_step_is_small==1))
+#endif 
+        {
+          dist2 = distance2vec(p1->r.p, p2->r.p, vec21);
+          add_non_bonded_pair_force(p1, p2, vec21, sqrt(dist2), dist2);
+        }
+      }
+    }
+  }
+}
+
+/** Nonbonded forces from the verlet lists of all local cells with
+    those neighbor cells whose entry in \a ghost, indexed by the
+    position in \ref cells, is \a use_ghosts. */
+static void calculate_verlet_pairs(const std::vector<char> &ghost, char use_ghosts)
+{
+  int c, np, n, i, *pairs;
+  Particle *part1, *part2, *p1, *p2;
+  double dist2, vec21[3];
+
+  for (c = 0; c < local_cells.n; c++) {
+    part1 = local_cells.cell[c]->part;
+    for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      if (ghost[dd.cell_inter[c].nList[n].pList - cells] != use_ghosts)
+        continue;
+      part2 = dd.cell_inter[c].nList[n].pList->part;
+      pairs = dd.cell_inter[c].nList[n].vList.pair;
+      np    = dd.cell_inter[c].nList[n].vList.n;
+      for(i=0; i<2*np; i+=2) {
+        p1 = &part1[pairs[i]];
+        p2 = &part2[pairs[i+1]];
 #ifdef MULTI_TIMESTEP
         if (smaller_time_step < 0. 
             || (p1->p.smaller_timestep==0 && p2->p.smaller_timestep==0 && current_time_step_is_small==0)
@@ -210,6 +246,45 @@ void calculate_verlet_ia()
   }
 }
 
+void calculate_verlet_ia_overlapped()
+{
+  int c, i, np;
+  Particle *part;
+  static std::vector<char> ghost;
+
+  ghost.assign(n_cells, 0);
+  for (c = 0; c < ghost_cells.n; c++)
+    ghost[ghost_cells.cell[c] - cells] = 1;
+
+  /* pairs within this node, while the ghost positions are on the way */
+  calculate_verlet_pairs(ghost, 0);
+
+  /* waiting is not work, and should not count for the load balancing */
+  double t_wait = MPI_Wtime();
+  cells_update_ghosts_finish();
+  dd_force_time -= MPI_Wtime() - t_wait;
+
+  /* bonded partners can be ghosts */
+  for (c = 0; c < local_cells.n; c++) {
+    part = local_cells.cell[c]->part;
+    np   = local_cells.cell[c]->n;
+    for(i = 0; i < np; i++)  {
+#ifdef MULTI_TIMESTEP
+      if (part[i].p.smaller_timestep==current_time_step_is_small || smaller_time_step < 0.)
+#endif
+      {
+        add_bonded_force(&part[i]);
+#ifdef CONSTRAINTS
+        add_constraints_forces(&part[i]);
+#endif
+        add_external_potential_forces(&part[i]);
+      }
+    }
+  }
+
+  calculate_verlet_pairs(ghost, 1);
+}
+
 void build_verlet_lists_and_calc_verlet_ia()
 {
   int c, np1, n, np2, i ,j, j_start;
@@ -283,7 +358,7 @@ void build_verlet_lists_and_calc_verlet_ia()
           if(dist2 <= SQR(get_ia_param(p1[i].p.type, p2[j].p.type)->max_cut + skin)) {
             ONEPART_TRACE(if(p1[i].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d,%d %d,%d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,i,n,j,sqrt(dist2)));
             ONEPART_TRACE(if(p2[j].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d %d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,n,sqrt(dist2)));
-            add_pair(pl, &p1[i], &p2[j]);
+            add_pair(pl, i, j);
 #ifdef MULTI_TIMESTEP
       if (smaller_time_step < 0.
         || (p1[i].p.smaller_timestep==0 && p2[j].p.smaller_timestep==0 && current_time_step_is_small==0)
@@ -312,9 +387,9 @@ void build_verlet_lists_and_calc_verlet_ia()
 
 void calculate_verlet_energies()
 {
-  int c, np, n, i;
+  int c, np, n, i, *pairs;
   Cell *cell;
-  Particle *p1, *p2, **pairs;
+  Particle *part1, *part2, *p1, *p2;
   double dist2, vec21[3];
 
   VERLET_TRACE(fprintf(stderr,"%d: calculate verlet energies\n",this_node));
@@ -322,16 +397,16 @@ void calculate_verlet_energies()
   /* Loop local cells */
   for (c = 0; c < local_cells.n; c++) {
     cell = local_cells.cell[c];
-    p1   = cell->part;
+    part1 = cell->part;
     np  = cell->n;
     /* calculate bonded interactions (loop local particles) */
     for(i = 0; i < np; i++)  {
-      add_kinetic_energy(&p1[i]);
-      add_bonded_energy(&p1[i]);
+      add_kinetic_energy(&part1[i]);
+      add_bonded_energy(&part1[i]);
 #ifdef CONSTRAINTS
-      add_constraints_energy(&p1[i]);
+      add_constraints_energy(&part1[i]);
 #endif
-      add_external_potential_energy(&p1[i]);
+      add_external_potential_energy(&part1[i]);
     }
 
     /* no interaction set */
@@ -341,14 +416,15 @@ void calculate_verlet_energies()
     VERLET_TRACE(fprintf(stderr,"%d: cell %d with %d neighbors\n",this_node,c, dd.cell_inter[c].n_neighbors));
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      part2 = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
       VERLET_TRACE(fprintf(stderr,"%d: neighbor %d has %d particles\n",this_node,n,np));
 
       /* verlet list loop */
       for(i=0; i<2*np; i+=2) {
-        p1 = pairs[i];                    /* pointer to particle 1 */
-        p2 = pairs[i+1];                  /* pointer to particle 2 */
+        p1 = &part1[pairs[i]];            /* pointer to particle 1 */
+        p2 = &part2[pairs[i+1]];          /* pointer to particle 2 */
         dist2 = distance2vec(p1->r.p, p2->r.p, vec21);
         VERLET_TRACE(fprintf(stderr, "%d: %d <-> %d: dist2 dist2\n",this_node,p1->p.identity,p2->p.identity));
         add_non_bonded_pair_energy(p1, p2, vec21, sqrt(dist2), dist2);
@@ -361,9 +437,9 @@ void calculate_verlet_energies()
 
 void calculate_verlet_virials(int v_comp)
 {
-  int c, np, n, i;
+  int c, np, n, i, *pairs;
   Cell *cell;
-  Particle *p1, *p2, **pairs;
+  Particle *part1, *part2, *p1, *p2;
   double dist2, vec21[3];
 
   VERLET_TRACE(fprintf(stderr,"%d: calculate verlet pressure\n",this_node));
@@ -371,17 +447,17 @@ void calculate_verlet_virials(int v_comp)
   /* Loop local cells */
   for (c = 0; c < local_cells.n; c++) {
     cell = local_cells.cell[c];
-    p1   = cell->part;
+    part1 = cell->part;
     np  = cell->n;
     /* calculate bonded interactions (loop local particles) */
     for(i = 0; i < np; i++)  {
-      add_kinetic_virials(&p1[i],v_comp);
-      add_bonded_virials(&p1[i]);
+      add_kinetic_virials(&part1[i],v_comp);
+      add_bonded_virials(&part1[i]);
 #ifdef BOND_ANGLE_OLD
-      add_three_body_bonded_stress(&p1[i]);
+      add_three_body_bonded_stress(&part1[i]);
 #endif
 #ifdef BOND_ANGLE
-      add_three_body_bonded_stress(&p1[i]);
+      add_three_body_bonded_stress(&part1[i]);
 #endif
     }
 
@@ -392,14 +468,15 @@ void calculate_verlet_virials(int v_comp)
     VERLET_TRACE(fprintf(stderr,"%d: cell %d with %d neighbors\n",this_node,c, dd.cell_inter[c].n_neighbors));
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
+      part2 = dd.cell_inter[c].nList[n].pList->part;
       pairs = dd.cell_inter[c].nList[n].vList.pair;
       np    = dd.cell_inter[c].nList[n].vList.n;
       VERLET_TRACE(fprintf(stderr,"%d: neighbor %d has %d particles\n",this_node,n,np));
 
       /* verlet list loop */
       for(i=0; i<2*np; i+=2) {
-        p1 = pairs[i];                    /* pointer to particle 1 */
-        p2 = pairs[i+1];                  /* pointer to particle 2 */
+        p1 = &part1[pairs[i]];            /* pointer to particle 1 */
+        p2 = &part2[pairs[i+1]];          /* pointer to particle 2 */
         dist2 = distance2vec(p1->r.p, p2->r.p, vec21);
         add_non_bonded_pair_virials(p1, p2, vec21, sqrt(dist2), dist2);
       }
@@ -416,7 +493,7 @@ void resize_verlet_list(PairList *pl)
   if( diff > 2*LIST_INCREMENT ) {
     diff = (diff/LIST_INCREMENT)-1;
     pl->max -= diff*LIST_INCREMENT;
-    pl->pair = (Particle **)Utils::realloc(pl->pair, 2*pl->max*sizeof(Particle *));
+    pl->pair = (int *)Utils::realloc(pl->pair, 2*pl->max*sizeof(int));
   }
 }
 
@@ -37,7 +37,12 @@
  *  reused with \ref tclcommand_setmd \ref verlet_reuse.
  *
  *  The verlet algorithm uses the data type \ref PairList to store
- *  interacting particle pairs.
+ *  interacting particle pairs. There is one pair list for each pair
+ *  of a local cell and one of its neighbor cells (see \ref
+ *  IA_Neighbor), and the pairs are stored as indices into the
+ *  particle lists of these two cells, which takes half the memory of
+ *  storing particle pointers. The pair lists are therefore only valid
+ *  as long as the particles are not resorted.
  *
  *  To use verlet pair lists for the force calculation you can either
  *  use the functions \ref build_verlet_lists and \ref
@@ -60,8 +65,10 @@
     Access using \ref resize_verlet_list.
 */
 typedef struct {
-  /** The pair payload (two pointers per pair) */
-  Particle **pair;
+  /** The pair payload (two indices per pair). The first index of a
+      pair refers to the particle list of the local cell, the second
+      one to the particle list of the neighbor cell. */
+  int *pair;
   /** Number of pairs contained */
   int n;
   /** Number of pairs that fit in until a resize is needed */
@@ -85,6 +92,13 @@ void build_verlet_lists();
 /** Nonbonded and bonded force calculation using the verlet list */
 void calculate_verlet_ia();
 
+/** Same as \ref calculate_verlet_ia, while the ghost position update
+    started by \ref cells_update_ghosts_start is in flight. First the
+    pairs with neighbor cells on this node are calculated, then the
+    update is completed and the bonded forces and the pairs with ghost
+    cells follow. */
+void calculate_verlet_ia_overlapped();
+
 /** Fill verlet tables and Calculate nonbonded and bonded forces. This
     is a combination of \ref build_verlet_lists and
     \ref calculate_verlet_ia.
@@ -26,6 +26,7 @@ cdef extern from "global.hpp":
     int FIELD_NPTISO_PDIFF
     int FIELD_PERIODIC
     int FIELD_SIMTIME
+    int FIELD_KSPACE_INTERVAL
 
 cdef extern from "communication.hpp":
     extern int n_nodes
@@ -37,6 +38,7 @@ cdef extern from "integrate.hpp":
     extern int integ_switch
     extern double sim_time
     extern double verlet_reuse
+    extern int kspace_interval
 
 cdef extern from "verlet.hpp":
     double skin
@@ -51,6 +53,8 @@ cdef extern from "domain_decomposition.hpp":
         pass
     ctypedef struct  DomainDecomposition:
         int use_vList
+        int use_soa
+        int async_ghosts
         int cell_grid[3]
         double cell_size[3]
 
@@ -117,6 +121,8 @@ cdef extern from "rattle.hpp":
 
 cdef extern from "tuning.hpp":
     extern int timing_samples
+    extern char * tune_cache_file
+    void tune_cache_set_file(char * file)
 
 cdef extern from "imd.hpp":
     extern int transfer_rate
@@ -85,6 +85,18 @@ cdef class System:
         def __get__(self):
             return integ_switch
 
+    property kspace_interval:
+        def __set__(self, int _interval):
+            if _interval < 1:
+                raise ValueError("kspace_interval must be positive")
+            global kspace_interval
+            kspace_interval = _interval
+            mpi_bcast_parameter(FIELD_KSPACE_INTERVAL)
+
+        def __get__(self):
+            global kspace_interval
+            return kspace_interval
+
     property local_box_l:
         def __get__(self):
             return np.array([local_box_l[0], local_box_l[1], local_box_l[2]])
@@ -309,6 +321,18 @@ cdef class System:
             global timing_samples
             return timing_samples
 
+    property tune_cache:
+        def __set__(self, _file):
+            if _file is None:
+                tune_cache_set_file(NULL)
+            else:
+                tune_cache_set_file(_file)
+
+        def __get__(self):
+            if tune_cache_file == NULL:
+                return None
+            return tune_cache_file
+
     property transfer_rate:
         def __get__(self):
             global transfer_rate
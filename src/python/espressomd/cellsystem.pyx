@@ -20,14 +20,22 @@ cimport cellsystem
 from globals cimport *
 
 cdef class CellSystem(object):
-    def setDomainDecomposition(self, useVerletLists=True):
+    def setDomainDecomposition(self, useVerletLists=True, useSoA=False, asyncGhosts=False):
         """Activates domain decomposition cell system
-        setDomainDecomposition(useVerletList=True)
+        setDomainDecomposition(useVerletList=True, useSoA=False, asyncGhosts=False)
         """
         if useVerletLists:
             dd.use_vList = 1
         else:
             dd.use_vList = 0
+        if useSoA:
+            dd.use_soa = 1
+        else:
+            dd.use_soa = 0
+        if asyncGhosts:
+            dd.async_ghosts = 1
+        else:
+            dd.async_ghosts = 0
 
         # grid.h::node_grid
         mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC)
@@ -88,6 +96,8 @@ cdef class CellSystem(object):
         if cell_structure.type == CELL_STRUCTURE_DOMDEC:
             s["type"] = "domainDecomposition"
             s["useVerletLists"] = dd.use_vList
+            s["useSoA"] = dd.use_soa
+            s["asyncGhosts"] = dd.async_ghosts
         if cell_structure.type == CELL_STRUCTURE_NSQUARE:
             s["type"] = "nsquare"
             s["useVerletLists"] = dd.use_vList
@@ -388,6 +388,9 @@ def features():
     IF LB_ELECTROHYDRODYNAMICS == 1:
         f.append("LB_ELECTROHYDRODYNAMICS")
 
+    IF LB_SINGLE_PRECISION == 1:
+        f.append("LB_SINGLE_PRECISION")
+
     IF P3M_DEBUG == 1:
         f.append("P3M_DEBUG")
 
@@ -70,6 +70,12 @@ IF ELECTROSTATICS:
                 int    inter2
                 int    cao3
                 double additional_mesh[3]
+                int    fft_comm
+                int    store_ca_frac
+
+        cdef extern from "fft-common.hpp":
+            int FFT_COMM_SENDRECV
+            int FFT_COMM_NONBLOCKING
 
         cdef extern from "p3m.hpp":
             int p3m_set_params(double r_cut, int * mesh, int cao, double alpha, double accuracy)
@@ -77,7 +83,10 @@ IF ELECTROSTATICS:
             int p3m_set_mesh_offset(double x, double y, double z)
             int p3m_set_eps(double eps)
             int p3m_set_ninterpol(int n)
+            int p3m_set_fft_comm(int comm)
+            int p3m_set_store_ca_frac(int store)
             int p3m_adaptive_tune(char ** log)
+            int p3m_model_tune(char ** log, int n_confirm)
 
             ctypedef struct p3m_data_struct:
                 p3m_parameter_struct params
@@ -113,6 +122,12 @@ IF ELECTROSTATICS:
             response = p3m_adaptive_tune(& log)
             return response, log
 
+        cdef inline python_p3m_model_tune(n_confirm):
+            cdef char * log = NULL
+            cdef int response
+            response = p3m_model_tune(& log, n_confirm)
+            return response, log
+
         cdef inline python_p3m_set_params(p_r_cut, p_mesh, p_cao, p_alpha, p_accuracy):
             cdef int mesh[3]
             cdef double r_cut
@@ -155,8 +155,20 @@ IF P3M == 1:
                 raise ValueError(
                     "mesh_off should be a list of length 3 and values between 0.0 and 1.0")
 
+            if not self._params["fft_comm"] in ("sendrecv", "nonblocking"):
+                raise ValueError(
+                    "fft_comm should be 'sendrecv' or 'nonblocking'")
+
+            if not self._params["ca_frac"] in ("store", "recompute"):
+                raise ValueError(
+                    "ca_frac should be 'store' or 'recompute'")
+
+            if not (isinstance(self._params["tune_confirm"], int) and self._params["tune_confirm"] >= 0):
+                raise ValueError(
+                    "tune_confirm should be a non-negative integer")
+
         def validKeys(self):
-            return "alpha_L", "r_cut_iL", "mesh", "mesh_off", "cao", "inter", "accuracy", "epsilon", "cao_cut", "a", "ai", "alpha", "r_cut", "inter2", "cao3", "additional_mesh", "bjerrum_length", "tune"
+            return "alpha_L", "r_cut_iL", "mesh", "mesh_off", "cao", "inter", "accuracy", "epsilon", "cao_cut", "a", "ai", "alpha", "r_cut", "inter2", "cao3", "additional_mesh", "bjerrum_length", "tune", "tune_model", "tune_confirm", "fft_comm", "ca_frac"
 
         def requiredKeys(self):
             return ["bjerrum_length", "accuracy"]
@@ -169,19 +181,38 @@ IF P3M == 1:
                     "mesh": [-1, -1, -1],
                     "epsilon": 0.0,
                     "mesh_off": [-1, -1, -1],
-                    "tune": True}
+                    "tune": True,
+                    "tune_model": False,
+                    "tune_confirm": 3,
+                    "fft_comm": "nonblocking",
+                    "ca_frac": "store"}
 
         def _getParamsFromEsCore(self):
             params = {}
             params.update(p3m.params)
+            if p3m.params.fft_comm == FFT_COMM_SENDRECV:
+                params["fft_comm"] = "sendrecv"
+            else:
+                params["fft_comm"] = "nonblocking"
+            if p3m.params.store_ca_frac:
+                params["ca_frac"] = "store"
+            else:
+                params["ca_frac"] = "recompute"
             params["bjerrum_length"] = coulomb.bjerrum
             params["tune"] = self._params["tune"]
+            params["tune_model"] = self._params["tune_model"]
+            params["tune_confirm"] = self._params["tune_confirm"]
             return params
 
         def _setParamsInEsCore(self):
             coulomb_set_bjerrum(self._params["bjerrum_length"])
             p3m_set_ninterpol(self._params["inter"])
             python_p3m_set_mesh_offset(self._params["mesh_off"])
+            if self._params["fft_comm"] == "sendrecv":
+                p3m_set_fft_comm(FFT_COMM_SENDRECV)
+            else:
+                p3m_set_fft_comm(FFT_COMM_NONBLOCKING)
+            p3m_set_store_ca_frac(self._params["ca_frac"] == "store")
             python_p3m_set_params(self._params["r_cut"], self._params["mesh"], self._params[
                                   "cao"], self._params["alpha"], self._params["accuracy"])
             p3m_set_eps(self._params["epsilon"])
@@ -191,7 +222,10 @@ IF P3M == 1:
             p3m_set_eps(self._params["epsilon"])
             python_p3m_set_tune_params(self._params["r_cut"], self._params["mesh"], self._params[
                                        "cao"], -1.0, self._params["accuracy"], self._params["inter"])
-            resp, log = python_p3m_adaptive_tune()
+            if self._params["tune_model"]:
+                resp, log = python_p3m_model_tune(self._params["tune_confirm"])
+            else:
+                resp, log = python_p3m_adaptive_tune()
             if resp:
                 raise Exception(
                     "failed to tune P3M parameters to required accuracy")
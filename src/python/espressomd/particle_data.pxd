@@ -77,10 +77,26 @@ cdef extern from "particle_data.hpp":
                 double f_swim
                 double v_swim
 
+    int max_seen_particle
+
     # Setter/getter/modifier functions functions
 
     int get_particle_data(int part, Particle * data)
 
+    # bulk setter and getter, see set_particles_property
+    int PART_PROP_POS
+    int PART_PROP_V
+    int PART_PROP_F
+    int PART_PROP_Q
+    int PART_PROP_TYPE
+    int PART_PROP_MASS
+
+    int particles_property_size(int property)
+
+    int set_particles_property(int property, int n, const int * ids, const double * values)
+
+    int get_particles_properties(int n_props, const int * props, int n, const int * ids, double * values)
+
     int place_particle(int part, double p[3])
 
     int set_particle_v(int part, double v[3])
@@ -210,3 +226,6 @@ cdef class ParticleHandle(object):
     cdef bint valid
     cdef Particle particleData
     cdef int updateParticleData(self) except -1
+
+cdef class ParticleSlice:
+    cdef public object id_list
@@ -78,10 +78,13 @@ cdef class ParticleHandle:
                 raise Exception("particle could not be set")
 
         def __get__(self):
-            self.updateParticleData()
-            return np.array([self.particleData.r.p[0],
-                             self.particleData.r.p[1],
-                             self.particleData.r.p[2]])
+            # unfolded in the same way as by the getters of ParticleSlice
+            cdef int prop = PART_PROP_POS
+            cdef int id = self.id
+            cdef double pos[3]
+            if get_particles_properties(1, & prop, 1, & id, pos) != 0:
+                raise Exception("Error updating particle data")
+            return np.array([pos[0], pos[1], pos[2]])
 
     # Velocity
     property v:
@@ -732,8 +735,115 @@ cdef class ParticleHandle:
         if change_particle_bond(self.id, NULL, 1):
             raise Exception("Deleting all bonds failed.")
 
+cdef class ParticleSlice:
+    """Vectorized access to the properties of several particles, as
+    returned by particleList for a slice or a list of ids. Setting or getting
+    a property transfers the values of all particles in one collective
+    operation, e.g. system.part[:].v = np.zeros((n, 3))."""
+
+    def __cinit__(self, ids):
+        self.id_list = np.array(ids, dtype=np.intc).ravel()
+
+    def __len__(self):
+        return len(self.id_list)
+
+    def _set_property(self, int prop, values):
+        cdef int size = particles_property_size(prop)
+        if size == 0:
+            raise Exception("property not compiled in")
+        cdef np.ndarray[int, ndim = 1] ids = np.ascontiguousarray(self.id_list, dtype=np.intc)
+        cdef np.ndarray[double, ndim = 1] vals = np.ascontiguousarray(values, dtype=np.double).ravel()
+        if vals.shape[0] == size:
+            # one value for all particles
+            vals = np.tile(vals, len(ids))
+        if vals.shape[0] != size * len(ids):
+            raise ValueError("Expected %d values per particle for %d particles" % (size, len(ids)))
+        if len(ids) == 0:
+            return
+        if set_particles_property(prop, len(ids), &ids[0], &vals[0]) != 0:
+            raise Exception("set particle position first")
+
+    def _get_property(self, int prop):
+        cdef int size = particles_property_size(prop)
+        cdef int p = prop
+        if size == 0:
+            raise Exception("property not compiled in")
+        cdef np.ndarray[int, ndim = 1] ids = np.ascontiguousarray(self.id_list, dtype=np.intc)
+        cdef np.ndarray[double, ndim = 1] vals = np.zeros(size * len(ids) + 1)
+        if len(ids) > 0 and get_particles_properties(1, &p, len(ids), &ids[0], &vals[0]) != 0:
+            raise Exception("particle does not exist")
+        if size == 1:
+            return vals[:len(ids)]
+        return vals[:size * len(ids)].reshape((len(ids), size))
+
+    property pos:
+        """Particle positions (not folded into central image), one row per particle"""
+
+        def __set__(self, _pos):
+            self._set_property(PART_PROP_POS, _pos)
+
+        def __get__(self):
+            return self._get_property(PART_PROP_POS)
+
+    property v:
+        """Particle velocities, one row per particle"""
+
+        def __set__(self, _v):
+            self._set_property(PART_PROP_V, _v)
+
+        def __get__(self):
+            return self._get_property(PART_PROP_V)
+
+    property f:
+        """Particle forces, one row per particle"""
+
+        def __set__(self, _f):
+            self._set_property(PART_PROP_F, _f)
+
+        def __get__(self):
+            return self._get_property(PART_PROP_F)
+
+    property type:
+        """Particle types"""
+
+        def __set__(self, _type):
+            self._set_property(PART_PROP_TYPE, _type)
+
+        def __get__(self):
+            return self._get_property(PART_PROP_TYPE).astype(int)
+
+    IF ELECTROSTATICS == 1:
+        property q:
+            """Particle charges"""
+
+            def __set__(self, _q):
+                self._set_property(PART_PROP_Q, _q)
+
+            def __get__(self):
+                return self._get_property(PART_PROP_Q)
+
+    IF MASS == 1:
+        property mass:
+            """Particle masses"""
+
+            def __set__(self, _mass):
+                self._set_property(PART_PROP_MASS, _mass)
+
+            def __get__(self):
+                return self._get_property(PART_PROP_MASS)
+
+
 cdef class particleList:
-    """Provides access to the particles via [i], where i is the particle id. Returns a ParticleHandle object """
+    """Provides access to the particles via [i], where i is the particle id. Returns a ParticleHandle object.
+    A slice or a list of ids returns a ParticleSlice for vectorized access;
+    open slices end at the largest particle id."""
 
     def __getitem__(self, key):
+        if isinstance(key, slice):
+            stop = key.stop
+            if stop is None:
+                stop = max_seen_particle + 1
+            return ParticleSlice(range(*slice(key.start, stop, key.step).indices(stop)))
+        if isinstance(key, (list, tuple, np.ndarray)):
+            return ParticleSlice(key)
         return ParticleHandle(key)
@@ -24,6 +24,14 @@ cdef extern from "global.hpp":
     int FIELD_THERMO_SWITCH
     int FIELD_TEMPERATURE
     int FIELD_LANGEVIN_GAMMA
+    int FIELD_RNG_COUNTER_MASK
+    int FIELD_RNG_COUNTER_SEED
+    int FIELD_RNG_COUNTER_STEP
+
+cdef extern from "random.hpp":
+    int rng_counter_mask
+    int rng_counter_seed
+    int rng_counter_step
 
 cdef extern from "thermostat.hpp":
     double temperature
@@ -31,3 +39,7 @@ cdef extern from "thermostat.hpp":
     double langevin_gamma
     int THERMO_OFF
     int THERMO_LANGEVIN
+    int THERMO_DPD
+    int THERMO_INTER_DPD
+    int THERMO_LB
+    int THERMO_GHMC
@@ -65,3 +65,31 @@ cdef class Thermostat:
         mpi_bcast_parameter(FIELD_TEMPERATURE)
         mpi_bcast_parameter(FIELD_LANGEVIN_GAMMA)
         return True
+
+    def setCounterRNG(self, seed="", thermostats=("langevin", "dpd", "inter_dpd", "lb", "ghmc"), step=None):
+        """Draws the noise of the given thermostats from a counter based generator keyed on 'seed', the step and the particle, so that it does not depend on the particle order or the number of nodes. seed=None returns to the sequential generator. Equivalent to the tcl command 'thermostat rng'"""
+
+        global rng_counter_mask
+        global rng_counter_seed
+        global rng_counter_step
+        if seed is None:
+            rng_counter_mask = 0
+            mpi_bcast_parameter(FIELD_RNG_COUNTER_MASK)
+            return True
+        if not isinstance(seed, int):
+            raise ValueError("seed must be an integer")
+        flags = {"langevin": THERMO_LANGEVIN, "dpd": THERMO_DPD,
+                 "inter_dpd": THERMO_INTER_DPD, "lb": THERMO_LB, "ghmc": THERMO_GHMC}
+        mask = 0
+        for t in thermostats:
+            if t not in flags:
+                raise ValueError("thermostat " + str(t) + " cannot use the counter based generator")
+            mask |= flags[t]
+        rng_counter_mask = mask
+        rng_counter_seed = seed
+        if step is not None:
+            rng_counter_step = int(step)
+        mpi_bcast_parameter(FIELD_RNG_COUNTER_MASK)
+        mpi_bcast_parameter(FIELD_RNG_COUNTER_SEED)
+        mpi_bcast_parameter(FIELD_RNG_COUNTER_STEP)
+        return True
@@ -28,6 +28,7 @@
 #include "binary_file_tcl.hpp"
 #include "global.hpp"
 #include "communication.hpp"
+#include "particle_data.hpp"
 #include "grid.hpp"
 #include "interaction_data.hpp"
 
@@ -146,40 +147,113 @@ int tclcommand_writemd(ClientData data, Tcl_Interp *interp,
   Tcl_Write(channel, (char *)&header, sizeof(header));
   Tcl_Write(channel, row, header.n_rows*sizeof(char));
 
-  for (p = 0; p <= max_seen_particle; p++) {
-    Particle data;
-    if (get_particle_data(p, &data) == ES_OK) {
-      unfold_position(data.r.p, data.m.v, data.l.i);
+  /* gather only the written properties of all particles at once */
+  int props[PART_PROP_NUM], offset[PART_PROP_NUM], n_props = 0, size = 0;
+  for (i = 0; i < PART_PROP_NUM; i++)
+    offset[i] = -1;
+  for (i = 0; i < header.n_rows; i++) {
+    int prop;
+    switch (row[i]) {
+    case POSX: case POSY: case POSZ: prop = PART_PROP_POS; break;
+    case VX: case VY: case VZ: prop = PART_PROP_V; break;
+    case FX: case FY: case FZ: prop = PART_PROP_F; break;
+    case Q: prop = PART_PROP_Q; break;
+    case TYPE: prop = PART_PROP_TYPE; break;
+#ifdef MASS
+    case MASSES: prop = PART_PROP_MASS; break;
+#endif
+    default: prop = -1;
+    }
+    /* e.g. the dipoles are written from the full particle data */
+    if (prop == -1 || particles_property_size(prop) == 0) {
+      size = -1;
+      break;
+    }
+    if (offset[prop] == -1) {
+      offset[prop] = size;
+      size += particles_property_size(prop);
+      props[n_props++] = prop;
+    }
+  }
+
+  if (size >= 0) {
+    double *values = (double*)Utils::malloc(sizeof(double)*(n_part*size + 1));
+    if (get_particles_properties(n_props, props, n_part, NULL, values) == ES_ERROR) {
+      Tcl_AppendResult(interp, "could not gather the particle data", (char *) NULL);
+      free(values);
+      free(row);
+      return (TCL_ERROR);
+    }
+    double *val = values;
+    for (p = 0; p <= max_seen_particle; p++) {
+      if (particle_node[p] == -1)
+        continue;
 
       /* write particle index */
       Tcl_Write(channel, (char *)&p, sizeof(int));
 
       for (i = 0; i < header.n_rows; i++) {
+        int type;
 	switch (row[i]) {
-	case POSX: Tcl_Write(channel, (char *)&data.r.p[0], sizeof(double)); break;
-	case POSY: Tcl_Write(channel, (char *)&data.r.p[1], sizeof(double)); break;
-	case POSZ: Tcl_Write(channel, (char *)&data.r.p[2], sizeof(double)); break;
-	case VX:   Tcl_Write(channel, (char *)&data.m.v[0], sizeof(double)); break;
-	case VY:   Tcl_Write(channel, (char *)&data.m.v[1], sizeof(double)); break;
-	case VZ:   Tcl_Write(channel, (char *)&data.m.v[2], sizeof(double)); break;
-	case FX:   Tcl_Write(channel, (char *)&data.f.f[0], sizeof(double)); break;
-	case FY:   Tcl_Write(channel, (char *)&data.f.f[1], sizeof(double)); break;
-	case FZ:   Tcl_Write(channel, (char *)&data.f.f[2], sizeof(double)); break;
+	case POSX: Tcl_Write(channel, (char *)&val[offset[PART_PROP_POS]], sizeof(double)); break;
+	case POSY: Tcl_Write(channel, (char *)&val[offset[PART_PROP_POS] + 1], sizeof(double)); break;
+	case POSZ: Tcl_Write(channel, (char *)&val[offset[PART_PROP_POS] + 2], sizeof(double)); break;
+	case VX:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_V]], sizeof(double)); break;
+	case VY:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_V] + 1], sizeof(double)); break;
+	case VZ:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_V] + 2], sizeof(double)); break;
+	case FX:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_F]], sizeof(double)); break;
+	case FY:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_F] + 1], sizeof(double)); break;
+	case FZ:   Tcl_Write(channel, (char *)&val[offset[PART_PROP_F] + 2], sizeof(double)); break;
 #ifdef MASS
-	case MASSES: Tcl_Write(channel, (char *)&data.p.mass, sizeof(double)); break;
+	case MASSES: Tcl_Write(channel, (char *)&val[offset[PART_PROP_MASS]], sizeof(double)); break;
+#endif
+	case Q:    Tcl_Write(channel, (char *)&val[offset[PART_PROP_Q]], sizeof(double)); break;
+	case TYPE:
+	  type = (int)val[offset[PART_PROP_TYPE]];
+	  Tcl_Write(channel, (char *)&type, sizeof(int));
+	  break;
+	}
+      }
+      val += size;
+    }
+    free(values);
+  }
+  else {
+    for (p = 0; p <= max_seen_particle; p++) {
+      Particle data;
+      if (get_particle_data(p, &data) == ES_OK) {
+        unfold_position(data.r.p, data.m.v, data.l.i);
+
+        /* write particle index */
+        Tcl_Write(channel, (char *)&p, sizeof(int));
+
+        for (i = 0; i < header.n_rows; i++) {
+	  switch (row[i]) {
+	  case POSX: Tcl_Write(channel, (char *)&data.r.p[0], sizeof(double)); break;
+	  case POSY: Tcl_Write(channel, (char *)&data.r.p[1], sizeof(double)); break;
+	  case POSZ: Tcl_Write(channel, (char *)&data.r.p[2], sizeof(double)); break;
+	  case VX:   Tcl_Write(channel, (char *)&data.m.v[0], sizeof(double)); break;
+	  case VY:   Tcl_Write(channel, (char *)&data.m.v[1], sizeof(double)); break;
+	  case VZ:   Tcl_Write(channel, (char *)&data.m.v[2], sizeof(double)); break;
+	  case FX:   Tcl_Write(channel, (char *)&data.f.f[0], sizeof(double)); break;
+	  case FY:   Tcl_Write(channel, (char *)&data.f.f[1], sizeof(double)); break;
+	  case FZ:   Tcl_Write(channel, (char *)&data.f.f[2], sizeof(double)); break;
+#ifdef MASS
+	  case MASSES: Tcl_Write(channel, (char *)&data.p.mass, sizeof(double)); break;
 #endif
 #ifdef ELECTROSTATICS
-	case Q:    Tcl_Write(channel, (char *)&data.p.q, sizeof(double)); break;
+	  case Q:    Tcl_Write(channel, (char *)&data.p.q, sizeof(double)); break;
 #endif
 #ifdef DIPOLES
-	case MX:   Tcl_Write(channel, (char *)&data.r.dip[0], sizeof(double)); break;
-	case MY:   Tcl_Write(channel, (char *)&data.r.dip[1], sizeof(double)); break;
-	case MZ:   Tcl_Write(channel, (char *)&data.r.dip[2], sizeof(double)); break;
+	  case MX:   Tcl_Write(channel, (char *)&data.r.dip[0], sizeof(double)); break;
+	  case MY:   Tcl_Write(channel, (char *)&data.r.dip[1], sizeof(double)); break;
+	  case MZ:   Tcl_Write(channel, (char *)&data.r.dip[2], sizeof(double)); break;
 #endif
-	case TYPE: Tcl_Write(channel, (char *)&data.p.type, sizeof(int)); break;
-	}
+	  case TYPE: Tcl_Write(channel, (char *)&data.p.type, sizeof(int)); break;
+	  }
+        }
+        free_particle(&data);
       }
-      free_particle(&data);
     }
   }
   /* end marker */
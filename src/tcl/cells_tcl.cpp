@@ -39,6 +39,30 @@ int tclcommand_sort_particles(ClientData data, Tcl_Interp *interp, int argc, cha
   return TCL_OK;
 }
 
+int tclcallback_cell_sort_period(Tcl_Interp *interp, void *_data)
+{
+  int data = *(int *)_data;
+  if (data < 0) {
+    Tcl_AppendResult(interp, "cell_sort_period must be non-negative", (char *) NULL);
+    return (TCL_ERROR);
+  }
+  cell_sort_period = data;
+  mpi_bcast_parameter(FIELD_CELL_SORT_PERIOD);
+  return (TCL_OK);
+}
+
+int tclcallback_balance_interval(Tcl_Interp *interp, void *_data)
+{
+  int data = *(int *)_data;
+  if (data < 0) {
+    Tcl_AppendResult(interp, "balance_interval must be non-negative", (char *) NULL);
+    return (TCL_ERROR);
+  }
+  dd_balance_interval = data;
+  mpi_bcast_parameter(FIELD_BALANCE_INTERVAL);
+  return (TCL_OK);
+}
+
 int tclcommand_cellsystem(ClientData data, Tcl_Interp *interp,
 	       int argc, char **argv)
 {
@@ -50,20 +74,26 @@ int tclcommand_cellsystem(ClientData data, Tcl_Interp *interp,
   }
 
   if (ARG1_IS_S("domain_decomposition")) {
-    if (argc > 2) {
-      if (ARG_IS_S(2,"-verlet_list"))
+    /** by default use verlet list, no SoA mirror and blocking ghost communication */
+    dd.use_vList = 1;
+    dd.use_soa = 0;
+    dd.async_ghosts = 0;
+    for (int i = 2; i < argc; i++) {
+      if (ARG_IS_S(i,"-verlet_list"))
 	dd.use_vList = 1;
-      else if(ARG_IS_S(2,"-no_verlet_list")) 
+      else if(ARG_IS_S(i,"-no_verlet_list")) 
 	dd.use_vList = 0;
+      else if(ARG_IS_S(i,"-soa"))
+	dd.use_soa = 1;
+      else if(ARG_IS_S(i,"-async_ghosts"))
+	dd.async_ghosts = 1;
       else{
 	Tcl_AppendResult(interp, "wrong flag to",argv[0],
-			 " : should be \" -verlet_list or -no_verlet_list \"",
+			 " : should be \" -verlet_list, -no_verlet_list, -soa or -async_ghosts \"",
 			 (char *) NULL);
 	return (TCL_ERROR);
       }
     }
-    /** by default use verlet list */
-    else dd.use_vList = 1;
     mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC);
   }
   else if (ARG1_IS_S("nsquare"))
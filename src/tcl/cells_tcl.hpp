@@ -34,6 +34,14 @@ int tclcommand_cellsystem(ClientData data, Tcl_Interp *interp,
 int tclcommand_sort_particles(ClientData data, Tcl_Interp *interp,
                               int argc, char **argv);
 
+/** Callback for setmd cell_sort_period (>= 0). See also \ref
+    cell_sort_period */
+int tclcallback_cell_sort_period(Tcl_Interp *interp, void *_data);
+
+/** Callback for setmd balance_interval (>= 0). See also \ref
+    dd_balance_interval */
+int tclcallback_balance_interval(Tcl_Interp *interp, void *_data);
+
 /*@}*/
 
 #endif
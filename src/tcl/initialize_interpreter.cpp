@@ -121,6 +121,8 @@ char *get_default_scriptsdir();
 
 /** Returns runtime of the integration loop in seconds. From tuning_tcl.cpp **/
 int tclcommand_time_integration(ClientData data, Tcl_Interp *interp, int argc, char *argv[]);
+/** Sets the file of the tuning cache. From tuning_tcl.cpp **/
+int tclcommand_tune_cache(ClientData data, Tcl_Interp *interp, int argc, char *argv[]);
 
 /** Tunes the skin */
 int tclcommand_tune_skin(ClientData data, Tcl_Interp *interp, int argc, char *argv[]);
@@ -240,6 +242,7 @@ static void tcl_register_commands(Tcl_Interp* interp) {
   REGISTER_COMMAND("galilei_transform", tclcommand_galilei_transform);
   REGISTER_COMMAND("time_integration", tclcommand_time_integration);
   REGISTER_COMMAND("tune_skin", tclcommand_tune_skin);
+  REGISTER_COMMAND("tune_cache", tclcommand_tune_cache);
   REGISTER_COMMAND("electrokinetics", tclcommand_electrokinetics);
 #if defined(SD) || defined(BD)
   /* from integrate_sd_tcl.cpp */
@@ -263,6 +266,8 @@ static void tcl_register_global_variables(Tcl_Interp *interp)
   register_global_callback(FIELD_BOXL, tclcallback_box_l);
   register_global_callback(FIELD_MAXNUMCELLS, tclcallback_max_num_cells);
   register_global_callback(FIELD_MINNUMCELLS, tclcallback_min_num_cells);
+  register_global_callback(FIELD_CELL_SORT_PERIOD, tclcallback_cell_sort_period);
+  register_global_callback(FIELD_BALANCE_INTERVAL, tclcallback_balance_interval);
   register_global_callback(FIELD_NODEGRID, tclcallback_node_grid);
   register_global_callback(FIELD_NPTISO_PDIFF, tclcallback_npt_p_diff);
   register_global_callback(FIELD_NPTISO_PISTON, tclcallback_npt_piston);
@@ -279,6 +284,7 @@ static void tcl_register_global_variables(Tcl_Interp *interp)
   register_global_callback(FIELD_SD_RANDOM_PRECISION, tclcallback_sd_random_precision);
   register_global_callback(FIELD_DPD_IGNORE_FIXED_PARTICLES, tclcallback_dpd_ignore_fixed_particles);
 
+  register_global_callback(FIELD_KSPACE_INTERVAL, tclcallback_kspace_interval);
 #ifdef MULTI_TIMESTEP
   register_global_callback(FIELD_SMALLERTIMESTEP, tclcallback_smaller_time_step);
 #endif
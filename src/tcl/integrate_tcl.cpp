@@ -330,6 +330,18 @@ int tclcallback_smaller_time_step(Tcl_Interp *interp, void *_data)
 }
 #endif
 
+int tclcallback_kspace_interval(Tcl_Interp *interp, void *_data)
+{
+  int data = *(int *)_data;
+  if (data < 1) {
+    Tcl_AppendResult(interp, "kspace_interval must be positive", (char *) NULL);
+    return (TCL_ERROR);
+  }
+  kspace_interval = data;
+  mpi_bcast_parameter(FIELD_KSPACE_INTERVAL);
+  return (TCL_OK);
+}
+
 int tclcallback_time(Tcl_Interp *interp, void *_data)
 {
   double data = *(double *)_data;
@@ -34,6 +34,7 @@
 #ifdef DP3M
 #include "p3m-dipolar_tcl.hpp"
 #include "p3m-dipolar.hpp"
+#include "fft-common.hpp"
 
 int tclcommand_inter_magnetic_parse_dp3m_tune_params(Tcl_Interp * interp, int argc, char ** argv)
 {
@@ -279,6 +280,31 @@ int tclcommand_inter_magnetic_parse_dp3m_opt_params(Tcl_Interp * interp, int arg
       argc -= 2;
       argv += 2;	    
     }
+
+    /* p3m parameter: fft_comm */
+    else if(ARG0_IS_S("fft_comm")) {
+
+      if(argc < 2) {
+	Tcl_AppendResult(interp, argv[0], " needs 1 parameter",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      if (ARG1_IS_S("sendrecv"))
+	i = FFT_COMM_SENDRECV;
+      else if (ARG1_IS_S("nonblocking"))
+	i = FFT_COMM_NONBLOCKING;
+      else {
+	Tcl_AppendResult(interp, argv[0], " must be \"sendrecv\" or \"nonblocking\"",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      dp3m_set_fft_comm(i);
+
+      argc -= 2;
+      argv += 2;
+    }
     else {
       Tcl_AppendResult(interp, "Unknown coulomb p3m parameter: \"",argv[0],"\"",(char *) NULL);
       return TCL_ERROR;
@@ -319,6 +345,10 @@ int tclprint_to_result_dp3m(Tcl_Interp *interp)
   Tcl_AppendResult(interp, buffer, " ", (char *) NULL);
   Tcl_PrintDouble(interp, dp3m.params.mesh_off[2], buffer);
   Tcl_AppendResult(interp, buffer, (char *) NULL);
+  if (dp3m.params.fft_comm == FFT_COMM_SENDRECV)
+    Tcl_AppendResult(interp, " fft_comm sendrecv", (char *) NULL);
+  else
+    Tcl_AppendResult(interp, " fft_comm nonblocking", (char *) NULL);
 #endif 
 
   return TCL_OK;
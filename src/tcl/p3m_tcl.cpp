@@ -23,10 +23,11 @@
 #ifdef P3M
 #include "p3m_tcl.hpp"
 #include "p3m.hpp"
+#include "fft-common.hpp"
 
 int tclcommand_inter_coulomb_parse_p3m_tune(Tcl_Interp * interp, int argc, char ** argv, int adaptive)
 {
-  int cao = -1, n_interpol = -1;
+  int cao = -1, n_interpol = -1, n_confirm = 3;
   double r_cut = -1, accuracy = -1;
   int mesh[3];
   IntList il;
@@ -77,6 +78,11 @@ int tclcommand_inter_coulomb_parse_p3m_tune(Tcl_Interp * interp, int argc, char
         Tcl_AppendResult(interp, "n_interpol expects an nonnegative integer", (char *) NULL);
         return TCL_ERROR;
       }
+    } else if (adaptive == 2 && ARG0_IS_S("confirm")) {
+      if (! (argc > 1 && ARG1_IS_I(n_confirm) && n_confirm >= 0)) {
+        Tcl_AppendResult(interp, "confirm expects an nonnegative integer", (char *) NULL);
+        return TCL_ERROR;
+      }
     }
     /* unknown parameter. Probably one of the optionals */
     else break;
@@ -102,7 +108,12 @@ int tclcommand_inter_coulomb_parse_p3m_tune(Tcl_Interp * interp, int argc, char
 
   /* do the tuning */
   char *log = NULL;
-  if (p3m_adaptive_tune(&log) == ES_ERROR) {  
+  int ret;
+  if (adaptive == 2)
+    ret = p3m_model_tune(&log, n_confirm);
+  else
+    ret = p3m_adaptive_tune(&log);
+  if (ret == ES_ERROR) {  
     Tcl_AppendResult(interp, log, "\nfailed to tune P3M parameters to required accuracy", (char *) NULL);
     if (log)
       free(log);
@@ -126,7 +137,7 @@ int tclcommand_inter_coulomb_parse_p3m(Tcl_Interp * interp, int argc, char ** ar
   init_intlist(&il);
 
   if (argc < 1) {
-    Tcl_AppendResult(interp, "expected: inter coulomb <bjerrum> p3m tune | [gpu] <r_cut> { <mesh> | \\{ <mesh_x> <mesh_y> <mesh_z> \\} } <cao> [<alpha> [<accuracy>]]",
+    Tcl_AppendResult(interp, "expected: inter coulomb <bjerrum> p3m tune | tunemodel | [gpu] <r_cut> { <mesh> | \\{ <mesh_x> <mesh_y> <mesh_z> \\} } <cao> [<alpha> [<accuracy>]]",
 		     (char *) NULL);
     return TCL_ERROR;  
   }
@@ -143,6 +154,9 @@ int tclcommand_inter_coulomb_parse_p3m(Tcl_Interp * interp, int argc, char ** ar
 
   if (ARG0_IS_S("tunev2"))
     return tclcommand_inter_coulomb_parse_p3m_tune(interp, argc-1, argv+1, 1);
+
+  if (ARG0_IS_S("tunemodel"))
+    return tclcommand_inter_coulomb_parse_p3m_tune(interp, argc-1, argv+1, 2);
       
   if(! ARG0_IS_D(r_cut))
     return TCL_ERROR;  
@@ -310,6 +324,54 @@ int tclcommand_inter_coulomb_parse_p3m_opt_params(Tcl_Interp * interp, int argc,
       argc -= 2;
       argv += 2;	    
     }
+
+    /* p3m parameter: fft_comm */
+    else if(ARG0_IS_S("fft_comm")) {
+
+      if(argc < 2) {
+	Tcl_AppendResult(interp, argv[0], " needs 1 parameter",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      if (ARG1_IS_S("sendrecv"))
+	i = FFT_COMM_SENDRECV;
+      else if (ARG1_IS_S("nonblocking"))
+	i = FFT_COMM_NONBLOCKING;
+      else {
+	Tcl_AppendResult(interp, argv[0], " must be \"sendrecv\" or \"nonblocking\"",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      p3m_set_fft_comm(i);
+
+      argc -= 2;
+      argv += 2;
+    }
+
+    /* p3m parameter: ca_frac */
+    else if(ARG0_IS_S("ca_frac")) {
+
+      if(argc < 2) {
+	Tcl_AppendResult(interp, argv[0], " needs 1 parameter",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      if (ARG1_IS_S("store"))
+	p3m_set_store_ca_frac(1);
+      else if (ARG1_IS_S("recompute"))
+	p3m_set_store_ca_frac(0);
+      else {
+	Tcl_AppendResult(interp, argv[0], " must be \"store\" or \"recompute\"",
+			 (char *) NULL);
+	return TCL_ERROR;
+      }
+
+      argc -= 2;
+      argv += 2;
+    }
     else {
       Tcl_AppendResult(interp, "Unknown coulomb p3m parameter: \"",argv[0],"\"",(char *) NULL);
       return TCL_ERROR;
@@ -358,6 +420,14 @@ int tclprint_to_result_p3m(Tcl_Interp *interp)
   Tcl_AppendResult(interp, buffer, " ", (char *) NULL);
   Tcl_PrintDouble(interp, p3m.params.mesh_off[2], buffer);
   Tcl_AppendResult(interp, buffer, (char *) NULL);
+  if (p3m.params.fft_comm == FFT_COMM_SENDRECV)
+    Tcl_AppendResult(interp, " fft_comm sendrecv", (char *) NULL);
+  else
+    Tcl_AppendResult(interp, " fft_comm nonblocking", (char *) NULL);
+  if (p3m.params.store_ca_frac)
+    Tcl_AppendResult(interp, " ca_frac store", (char *) NULL);
+  else
+    Tcl_AppendResult(interp, " ca_frac recompute", (char *) NULL);
 
   return TCL_OK;
 }
@@ -35,9 +35,12 @@ int tclcommand_inter_coulomb_parse_p3m_opt_params(Tcl_Interp * interp, int argc,
 
     Usage:
     \verbatim inter coulomb <bjerrum> p3m tune accuracy <value> [r_cut <value> mesh <value> cao <value>] \endverbatim
+    \verbatim inter coulomb <bjerrum> p3m tunemodel accuracy <value> [r_cut <value> mesh <value> cao <value>] [confirm <n>] \endverbatim
 
     The parameters are tuned to obtain the desired accuracy in best
     time, by running mpi_integrate(0) for several parameter sets.
+    With tunemodel, the times are predicted by a cost model, and only
+    the best n parameter sets are timed, see \ref p3m_model_tune.
 
     The function utilizes the analytic expression of the error estimate 
     for the P3M method in the book of Hockney and Eastwood (Eqn. 8.23) in 
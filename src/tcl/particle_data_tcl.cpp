@@ -21,6 +21,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <vector>
+#include <string>
 #include <mpi.h>
 #include "utils.hpp"
 #include "particle_data.hpp"
@@ -2112,6 +2114,220 @@ int part_parse_gamma(Tcl_Interp *interp, int argc, char **argv,
 
 #endif
 
+/** parse "part bulk print <ids|all> <property> ...". Prints the
+    properties of many particles like "part <id> print", one list
+    element per particle and "na" for particles that do not exist. Only
+    the requested properties are sent to the master. */
+int tclcommand_part_parse_bulk_print(Tcl_Interp *interp, int argc, char **argv)
+{
+  char buffer[TCL_DOUBLE_SPACE + TCL_INTEGER_SPACE];
+  /* offset of each property in the gathered values, -1 if not gathered */
+  int offset[PART_PROP_NUM];
+  std::vector<int> fields, props, present;
+  IntList ids;
+  int size = 0;
+
+  if (argc < 2) {
+    Tcl_AppendResult(interp, "usage: part bulk print <ids|all> <id|pos|v|f|q|type|mass> ...", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  for (int k = 0; k < PART_PROP_NUM; k++)
+    offset[k] = -1;
+  for (int i = 1; i < argc; i++) {
+    int property;
+    if (ARG_IS_S_EXACT(i, "id") || ARG_IS_S_EXACT(i, "identity")) {
+      fields.push_back(-1);
+      continue;
+    }
+    else if (ARG_IS_S_EXACT(i, "pos") || ARG_IS_S_EXACT(i, "position")) property = PART_PROP_POS;
+    else if (ARG_IS_S_EXACT(i, "v")) property = PART_PROP_V;
+    else if (ARG_IS_S_EXACT(i, "f") || ARG_IS_S_EXACT(i, "force")) property = PART_PROP_F;
+    else if (ARG_IS_S_EXACT(i, "q")) property = PART_PROP_Q;
+    else if (ARG_IS_S_EXACT(i, "type")) property = PART_PROP_TYPE;
+    else if (ARG_IS_S_EXACT(i, "mass")) property = PART_PROP_MASS;
+    else {
+      Tcl_AppendResult(interp, "unknown particle property \"", argv[i], "\"", (char *)NULL);
+      return TCL_ERROR;
+    }
+    if (particles_property_size(property) == 0) {
+      Tcl_AppendResult(interp, "particle property \"", argv[i], "\" not compiled in", (char *)NULL);
+      return TCL_ERROR;
+    }
+#ifdef MULTI_TIMESTEP
+    if (property == PART_PROP_V && smaller_time_step > 0.) {
+      Tcl_AppendResult(interp, "part bulk print v does not support multiple time steps", (char *)NULL);
+      return TCL_ERROR;
+    }
+#endif
+    fields.push_back(property);
+  }
+  /* the forces are printed including the mass */
+  for (size_t i = 0; i < fields.size(); i++)
+    if (fields[i] == PART_PROP_F && particles_property_size(PART_PROP_MASS))
+      fields.push_back(PART_PROP_MASS);
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (fields[i] >= 0 && offset[fields[i]] == -1) {
+      offset[fields[i]] = size;
+      size += particles_property_size(fields[i]);
+      props.push_back(fields[i]);
+    }
+  }
+  fields.resize(argc - 1);
+
+  if (!particle_node)
+    build_particle_node();
+  init_intlist(&ids);
+  if (ARG0_IS_S_EXACT("all")) {
+    for (int id = 0; id <= max_seen_particle; id++)
+      if (particle_node[id] != -1)
+        present.push_back(id);
+  }
+  else if (ARG_IS_INTLIST(0, ids)) {
+    for (int i = 0; i < ids.n; i++)
+      if (ids.e[i] >= 0 && ids.e[i] <= max_seen_particle && particle_node[ids.e[i]] != -1)
+        present.push_back(ids.e[i]);
+  }
+  else {
+    Tcl_AppendResult(interp, "part bulk print expects a list of identities or \"all\"", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  std::vector<double> values(present.size()*size + 1);
+  int ret = ES_OK;
+  if (props.empty())
+    ;
+  else if (ARG0_IS_S_EXACT("all"))
+    ret = get_particles_properties(props.size(), &props[0], present.size(), NULL, &values[0]);
+  else if (!present.empty())
+    ret = get_particles_properties(props.size(), &props[0], present.size(), &present[0], &values[0]);
+  if (ret == ES_ERROR) {
+    realloc_intlist(&ids, 0);
+    Tcl_AppendResult(interp, "could not gather the particle properties", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  int n = ARG0_IS_S_EXACT("all") ? present.size() : ids.n;
+  for (int i = 0, k = 0; i < n; i++) {
+    if (!ARG0_IS_S_EXACT("all") && (k == (int)present.size() || present[k] != ids.e[i])) {
+      Tcl_AppendElement(interp, "na");
+      continue;
+    }
+    double *val = &values[(size_t)k*size];
+    double mass = (offset[PART_PROP_MASS] >= 0) ? val[offset[PART_PROP_MASS]] : 1;
+    std::string line;
+    for (size_t j = 0; j < fields.size(); j++) {
+      double *x = val + offset[fields[j] >= 0 ? fields[j] : 0];
+      if (j > 0)
+        line += " ";
+      switch (fields[j]) {
+      case -1:
+        sprintf(buffer, "%d", present[k]);
+        line += buffer;
+        break;
+      case PART_PROP_TYPE:
+        sprintf(buffer, "%d", (int)x[0]);
+        line += buffer;
+        break;
+      case PART_PROP_POS:
+      case PART_PROP_V:
+      case PART_PROP_F:
+        for (int d = 0; d < 3; d++) {
+          double value = x[d];
+          if (fields[j] == PART_PROP_V)
+            value = x[d]/time_step;
+          else if (fields[j] == PART_PROP_F)
+            value = x[d]*mass/(0.5*time_step*time_step);
+          Tcl_PrintDouble(interp, value, buffer);
+          if (d > 0)
+            line += " ";
+          line += buffer;
+        }
+        break;
+      default:
+        Tcl_PrintDouble(interp, x[0], buffer);
+        line += buffer;
+      }
+    }
+    Tcl_AppendElement(interp, line.c_str());
+    k++;
+  }
+
+  realloc_intlist(&ids, 0);
+  return TCL_OK;
+}
+
+/** parse "part bulk <property> <ids> <values>". Sets one property of
+    many particles with a single collective instead of one message per
+    particle. */
+int tclcommand_part_parse_bulk(Tcl_Interp *interp, int argc, char **argv)
+{
+  int property, size;
+  IntList ids;
+  DoubleList values;
+
+  if (argc > 0 && ARG0_IS_S_EXACT("print"))
+    return tclcommand_part_parse_bulk_print(interp, argc-1, argv+1);
+
+  if (argc != 3) {
+    Tcl_AppendResult(interp, "usage: part bulk <pos|v|f|q|type|mass> <ids> <values>", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  if (ARG0_IS_S("pos")) property = PART_PROP_POS;
+  else if (ARG0_IS_S("v")) property = PART_PROP_V;
+  else if (ARG0_IS_S("f")) property = PART_PROP_F;
+  else if (ARG0_IS_S("q")) property = PART_PROP_Q;
+  else if (ARG0_IS_S("type")) property = PART_PROP_TYPE;
+  else if (ARG0_IS_S("mass")) property = PART_PROP_MASS;
+  else {
+    Tcl_AppendResult(interp, "unknown particle property \"", argv[0], "\"", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  size = particles_property_size(property);
+  if (size == 0) {
+    Tcl_AppendResult(interp, "particle property \"", argv[0], "\" not compiled in", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  init_intlist(&ids);
+  init_doublelist(&values);
+  if (!ARG_IS_INTLIST(1, ids) || !ARG_IS_DOUBLELIST(2, values)) {
+    realloc_intlist(&ids, 0);
+    realloc_doublelist(&values, 0);
+    Tcl_AppendResult(interp, "part bulk expects a list of identities and a list of values", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  if (values.n != size*ids.n) {
+    realloc_intlist(&ids, 0);
+    realloc_doublelist(&values, 0);
+    Tcl_AppendResult(interp, "number of values does not match the number of particles", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  /* scale velocities and forces with the time step, like the single
+     particle setters */
+  if (property == PART_PROP_V)
+    for (int i = 0; i < values.n; i++)
+      values.e[i] *= time_step;
+  else if (property == PART_PROP_F)
+    for (int i = 0; i < values.n; i++)
+      values.e[i] *= 0.5*time_step*time_step;
+
+  if (set_particles_property(property, ids.n, ids.e, values.e) == ES_ERROR) {
+    realloc_intlist(&ids, 0);
+    realloc_doublelist(&values, 0);
+    Tcl_AppendResult(interp, "invalid or nonexisting particle identity; set particle positions first", (char *)NULL);
+    return TCL_ERROR;
+  }
+
+  realloc_intlist(&ids, 0);
+  realloc_doublelist(&values, 0);
+  return gather_runtime_errors(interp, TCL_OK);
+}
+
 int part_parse_gc(Tcl_Interp *interp, int argc, char **argv){
 
   char buffer[100 + TCL_DOUBLE_SPACE + 3*TCL_INTEGER_SPACE];
@@ -2772,6 +2988,9 @@ int tclcommand_part(ClientData data, Tcl_Interp *interp,
   }
 #endif
 
+  else if (ARG1_IS_S("bulk"))
+    return tclcommand_part_parse_bulk(interp, argc-2, argv+2);
+
   else if ( ARG1_IS_S("gc")) {
 	 argc-=2;
 	 argv+=2;
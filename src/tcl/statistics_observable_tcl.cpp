@@ -558,12 +558,6 @@ int tclcommand_observable_rdf(Tcl_Interp* interp, int argc, char** argv, int* ch
   /* if not given use default */
   if (pdata->r_max < 0) pdata->r_max = min_box_l / 2.0;
 
-  
-  if (!sortPartCfg()) {
-    Tcl_AppendResult(interp, "for analyze, store particles consecutively starting with 0.", (char *) NULL);
-    return (TCL_ERROR);
-  }
-  
   //calc_rdf(p1.e, p1.max, p2.e, p2.max, r_min, r_max, r_bins, rdf);
   
   pdata->p1_types = (int *) Utils::malloc(p1.n * sizeof(int));
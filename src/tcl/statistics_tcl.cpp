@@ -1764,13 +1764,15 @@ static int tclcommand_analyze_parse_rdf(Tcl_Interp *interp, int average, int arg
         Tcl_AppendResult(interp, buffer, " }", (char *) NULL);
     } else
         Tcl_AppendResult(interp, " }", (char *) NULL);
-    rdf = (double*) Utils::malloc(r_bins * sizeof (double));
-
-    if (!sortPartCfg()) {
+    /* the averages need the particle configuration in the order
+       of the stored configurations */
+    if (average != 0 && !sortPartCfg()) {
         Tcl_AppendResult(interp, "for analyze, store particles consecutively starting with 0.", (char *) NULL);
         return (TCL_ERROR);
     }
 
+    rdf = (double*) Utils::malloc(r_bins * sizeof (double));
+
     switch (average) {
         case 0:
             calc_rdf(p1.e, p1.max, p2.e, p2.max, r_min, r_max, r_bins, rdf);
@@ -1802,13 +1804,13 @@ static int tclcommand_analyze_parse_rdf(Tcl_Interp *interp, int average, int arg
 }
 
 int tclcommand_analyze_parse_structurefactor(Tcl_Interp *interp, int argc, char **argv) {
-    /* 'analyze { stucturefactor } <type> <order>' */
+    /* 'analyze { stucturefactor } <type> <order> [mesh [<mesh> [<cao>]]]' */
     /***********************************************************************************************************/
     char buffer[2 * TCL_DOUBLE_SPACE + 4];
-    int i, type, order;
+    int i, type, order, use_mesh = 0, mesh = 0, cao = 7;
     double qfak, *sf;
     if (argc < 2) {
-        Tcl_AppendResult(interp, "Wrong # of args! Usage: analyze structurefactor <type> <order> [<chain_start> <n_chains> <chain_length>]",
+        Tcl_AppendResult(interp, "Wrong # of args! Usage: analyze structurefactor <type> <order> [mesh [<mesh> [<cao>]]]",
                 (char *) NULL);
         return (TCL_ERROR);
     } else {
@@ -1819,8 +1821,34 @@ int tclcommand_analyze_parse_structurefactor(Tcl_Interp *interp, int argc, char
         argc -= 2;
         argv += 2;
     }
-    updatePartCfg(WITHOUT_BONDS);
-    calc_structurefactor(type, order, &sf);
+    if (argc > 0 && ARG0_IS_S("mesh")) {
+        use_mesh = 1;
+        /* default: the next power of two to 4*order */
+        for (mesh = 2; mesh < 4 * order; mesh *= 2);
+        if (argc > 1) {
+            if (!ARG1_IS_I(mesh))
+                return (TCL_ERROR);
+            if (argc > 2 && !ARG_IS_I(2, cao))
+                return (TCL_ERROR);
+        }
+        if (order < 1 || mesh <= 2 * order || cao < 1 || cao > 7) {
+            Tcl_AppendResult(interp, "analyze structurefactor: mesh has to be larger than 2*order, and cao between 1 and 7",
+                    (char *) NULL);
+            return (TCL_ERROR);
+        }
+    }
+
+    if (use_mesh) {
+#ifdef FFTW
+        calc_structurefactor_mesh(type, order, mesh, cao, &sf);
+#else
+        Tcl_AppendResult(interp, "analyze structurefactor mesh requires FFTW", (char *) NULL);
+        return (TCL_ERROR);
+#endif
+    } else {
+        updatePartCfg(WITHOUT_BONDS);
+        calc_structurefactor(type, order, &sf);
+    }
 
     qfak = 2.0 * PI / box_l[0];
     for (i = 0; i < order * order; i++) {
@@ -373,6 +373,91 @@ int tclcommand_thermostat_parse_cpu(Tcl_Interp *interp, int argc, char **argv)
   return (TCL_OK);
 }
 
+/** Names of the thermostats that can use the counter based generator. */
+static const struct { const char *name; int flag; } rng_counter_thermostats[] = {
+  { "langevin",  THERMO_LANGEVIN },
+  { "dpd",       THERMO_DPD },
+  { "inter_dpd", THERMO_INTER_DPD },
+  { "lb",        THERMO_LB },
+  { "ghmc",      THERMO_GHMC },
+  { NULL, 0 }
+};
+
+int tclcommand_thermostat_parse_rng(Tcl_Interp *interp, int argc, char **argv)
+{
+  int seed, mask = 0, step = rng_counter_step;
+
+  if (argc >= 3 && ARG_IS_S(2, "sequential")) {
+    rng_counter_mask = 0;
+    mpi_bcast_parameter(FIELD_RNG_COUNTER_MASK);
+    return (TCL_OK);
+  }
+
+  if (argc < 4 || !ARG_IS_S(2, "counter")) {
+    Tcl_AppendResult(interp, "wrong # args:  should be \n\"",
+                     argv[0]," ",argv[1]," counter <seed> [-step <step>] {langevin|dpd|inter_dpd|lb|ghmc|all}...\" or \n\"",
+                     argv[0]," ",argv[1]," sequential\"", (char *)NULL);
+    return (TCL_ERROR);
+  }
+  if (!ARG_IS_I(3, seed)) {
+    Tcl_AppendResult(interp, argv[0]," ",argv[1]," counter needs an INTEGER seed", (char *)NULL);
+    return (TCL_ERROR);
+  }
+  for (int i = 4; i < argc; i++) {
+    if (ARG_IS_S(i, "-step")) {
+      if (i + 1 >= argc || !ARG_IS_I(i + 1, step)) {
+        Tcl_AppendResult(interp, "-step needs an INTEGER", (char *)NULL);
+        return (TCL_ERROR);
+      }
+      i++;
+      continue;
+    }
+    if (ARG_IS_S(i, "all")) {
+      for (int t = 0; rng_counter_thermostats[t].name; t++)
+        mask |= rng_counter_thermostats[t].flag;
+      continue;
+    }
+    int t;
+    for (t = 0; rng_counter_thermostats[t].name; t++)
+      if (ARG_IS_S(i, rng_counter_thermostats[t].name))
+        break;
+    if (!rng_counter_thermostats[t].name) {
+      Tcl_AppendResult(interp, "thermostat ", argv[i], " cannot use the counter based generator", (char *)NULL);
+      return (TCL_ERROR);
+    }
+    mask |= rng_counter_thermostats[t].flag;
+  }
+  /* no list means all */
+  if (mask == 0)
+    for (int t = 0; rng_counter_thermostats[t].name; t++)
+      mask |= rng_counter_thermostats[t].flag;
+
+  rng_counter_mask = mask;
+  rng_counter_seed = seed;
+  rng_counter_step = step;
+  mpi_bcast_parameter(FIELD_RNG_COUNTER_MASK);
+  mpi_bcast_parameter(FIELD_RNG_COUNTER_SEED);
+  mpi_bcast_parameter(FIELD_RNG_COUNTER_STEP);
+  return (TCL_OK);
+}
+
+/** Print the random number generator setting, if not the default. */
+static void tclcommand_thermostat_print_rng(Tcl_Interp *interp)
+{
+  char buffer[TCL_INTEGER_SPACE];
+
+  if (rng_counter_mask == 0)
+    return;
+  sprintf(buffer, "%d", rng_counter_seed);
+  Tcl_AppendResult(interp, "{ rng counter ", buffer, (char *)NULL);
+  sprintf(buffer, "%d", rng_counter_step);
+  Tcl_AppendResult(interp, " -step ", buffer, (char *)NULL);
+  for (int t = 0; rng_counter_thermostats[t].name; t++)
+    if (rng_counter_mask & rng_counter_thermostats[t].flag)
+      Tcl_AppendResult(interp, " ", rng_counter_thermostats[t].name, (char *)NULL);
+  Tcl_AppendResult(interp, " } ", (char *)NULL);
+}
+
 int tclcommand_thermostat_print_all(Tcl_Interp *interp)
 {
   char buffer[TCL_DOUBLE_SPACE];
@@ -385,6 +470,7 @@ int tclcommand_thermostat_print_all(Tcl_Interp *interp)
   /* no thermostat on */
   if(thermo_switch == THERMO_OFF) {
     Tcl_AppendResult(interp,"{ off } ", (char *)NULL);
+    tclcommand_thermostat_print_rng(interp);
     return (TCL_OK);
   }
 
@@ -473,6 +559,7 @@ int tclcommand_thermostat_print_all(Tcl_Interp *interp)
     Tcl_AppendResult(interp,"{ bd ",buffer, " } ", (char *)NULL);
   }
 #endif
+  tclcommand_thermostat_print_rng(interp);
   return (TCL_OK);
 }
 
@@ -498,6 +585,8 @@ int tclcommand_thermostat_print_usage(Tcl_Interp *interp, int argc, char **argv)
   Tcl_AppendResult(interp, "'", argv[0], " set sd <temperature>" , (char *)NULL);
   Tcl_AppendResult(interp, "'", argv[0], " set bd <temperature>" , (char *)NULL);
 #endif
+  Tcl_AppendResult(interp, "'", argv[0], " rng counter <seed> [-step <step>] [<thermostats>]' or \n ", (char *)NULL);
+  Tcl_AppendResult(interp, "'", argv[0], " rng sequential'", (char *)NULL);
   return (TCL_ERROR);
 }
 
@@ -544,6 +633,8 @@ int tclcommand_thermostat(ClientData data, Tcl_Interp *interp, int argc, char **
 #endif
   else if ( ARG1_IS_S("cpu"))
     err = tclcommand_thermostat_parse_cpu(interp, argc, argv);
+  else if ( ARG1_IS_S("rng"))
+    err = tclcommand_thermostat_parse_rng(interp, argc, argv);
 #if defined(SD) || defined(BD)
 #ifdef SD
   else if ( ARG1_IS_S("sd") )
@@ -56,6 +56,22 @@ int tclcommand_time_integration(ClientData data, Tcl_Interp *interp, int argc, c
   return TCL_OK;
 }
 
+int tclcommand_tune_cache(ClientData data, Tcl_Interp *interp, int argc, char *argv[]) {
+  if(argc > 2) {
+    Tcl_AppendResult(interp, "usage: tune_cache [<file>|off]", (char *)NULL);
+    return TCL_ERROR;
+  }
+  if(argc == 2) {
+    if(ARG1_IS_S("off"))
+      tune_cache_set_file(NULL);
+    else
+      tune_cache_set_file(argv[1]);
+  }
+
+  Tcl_AppendResult(interp, tune_cache_file ? tune_cache_file : "off", (char *)NULL);
+  return TCL_OK;
+}
+
 int tclcommand_tune_skin(ClientData data, Tcl_Interp *interp, int argc, char *argv[]) {
   if(argc != 5) {
     puts("usage:");
@@ -0,0 +1,105 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the nonblocking ghost communication (cellsystem
+# domain_decomposition -async_ghosts) and the pair forces calculated
+# while the ghost positions are updated give the same forces as the
+# blocking communication.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase async_ghosts.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-4
+thermostat off
+setmd time_step 1
+setmd skin 0
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+proc check_forces {ref what} {
+    global epsilon
+    upvar $ref F
+    set maxd 0
+    set maxp 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set resF [part $i pr f]
+	for { set k 0 } { $k < 3 } { incr k } {
+	    set d [expr abs([lindex $resF $k] - [lindex $F($i) $k])]
+	    if { $d > $maxd } {
+		set maxd $d
+		set maxp $i
+	    }
+	}
+    }
+    puts "$what: maximal force deviation $maxd for particle $maxp"
+    if { $maxd > $epsilon } {
+	error "$what: force of particle $maxp: [part $maxp pr f] != $F($maxp)"
+    }
+}
+
+if { [catch {
+    read_data "lj_system.data"
+
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set F($i) [part $i pr f]
+	set pos($i) [part $i pr pos]
+    }
+
+    inter 0 0 lennard-jones 1.0 1.0 1.12246
+    inter 1 1 lennard-jones 1.3 0.5 2 auto 0.0
+    inter 0 1 lennard-jones 2.2 1.0 1.12246 0.0 0.5
+
+    # static forces
+    cellsystem domain_decomposition -async_ghosts
+    integrate 0
+    check_forces F "nonblocking ghosts"
+
+    # short capped run with blocking communication as reference. With a
+    # skin, most steps reuse the verlet lists and overlap the position
+    # update with the pair forces.
+    inter forcecap 20
+    setmd time_step 0.001
+    setmd skin 0.2
+    cellsystem domain_decomposition
+    integrate 20
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set Fref($i) [part $i pr f]
+	set posref($i) [part $i pr pos]
+	part $i pos [lindex $pos($i) 0] [lindex $pos($i) 1] [lindex $pos($i) 2] v 0 0 0
+    }
+
+    cellsystem domain_decomposition -async_ghosts
+    integrate 20
+    check_forces Fref "nonblocking ghosts, 20 steps"
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	if { [veclen [vecsub [part $i pr pos] $posref($i)]] > $epsilon } {
+	    error "particle $i at [part $i pr pos] instead of $posref($i)"
+	}
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,123 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the reordering of the particles in the cells along a
+# space filling curve (setmd cell_sort_period) changes neither the
+# forces nor the particle data, and that the locality drift vanishes
+# after a reordering and grows as the particles diffuse.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase cell_sort.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-4
+thermostat off
+setmd time_step 1
+setmd skin 0
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+proc check_forces {ref what} {
+    global epsilon
+    upvar $ref F
+    set maxd 0
+    set maxp 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set resF [part $i pr f]
+	for { set k 0 } { $k < 3 } { incr k } {
+	    set d [expr abs([lindex $resF $k] - [lindex $F($i) $k])]
+	    if { $d > $maxd } {
+		set maxd $d
+		set maxp $i
+	    }
+	}
+    }
+    puts "$what: maximal force deviation $maxd for particle $maxp"
+    if { $maxd > $epsilon } {
+	error "$what: force of particle $maxp: [part $maxp pr f] != $F($maxp)"
+    }
+}
+
+proc check_drift {what min max} {
+    set drift [setmd locality_drift]
+    puts "$what: locality drift $drift"
+    if { $drift < $min || $drift > $max } {
+	error "$what: locality drift $drift not in \[$min, $max\]"
+    }
+    return $drift
+}
+
+if { [catch {
+    read_data "lj_system.data"
+
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set F($i) [part $i pr f]
+	set pos($i) [part $i pr pos]
+    }
+
+    inter 0 0 lennard-jones 1.0 1.0 1.12246
+    inter 1 1 lennard-jones 1.3 0.5 2 auto 0.0
+    inter 0 1 lennard-jones 2.2 1.0 1.12246 0.0 0.5
+
+    # static forces with reordered cells
+    setmd cell_sort_period 1
+    integrate 0
+    check_forces F "reordered cells"
+    # nothing moved since the reordering
+    check_drift "reordered cells" 0 1e-10
+
+    # the particles must still be found at their old positions
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	if { [veclen [vecsub [part $i pr pos] $pos($i)]] > $epsilon } {
+	    error "particle $i moved from $pos($i) to [part $i pr pos]"
+	}
+    }
+
+    # short capped run without reordering as reference
+    inter forcecap 20
+    setmd time_step 0.001
+    setmd skin 0.2
+    setmd cell_sort_period 0
+    integrate 20
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set Fref($i) [part $i pr f]
+	part $i pos [lindex $pos($i) 0] [lindex $pos($i) 1] [lindex $pos($i) 2] v 0 0 0
+    }
+
+    setmd cell_sort_period 1
+    integrate 20
+    check_forces Fref "reordered cells, 20 steps"
+    set sorted_drift [check_drift "reordered cells, 20 steps" 0 0.05]
+
+    # without reordering, the order decays as the particles diffuse
+    setmd cell_sort_period 0
+    thermostat langevin 1.0 1.0
+    setmd time_step 0.01
+    integrate 200
+    check_drift "no reordering, 200 steps" [expr $sorted_drift + 0.05] 1
+} res ] } {
+    error_exit $res
+}
+
+exit 0
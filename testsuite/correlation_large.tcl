@@ -0,0 +1,83 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Correlates per-particle observables with many components, which are
+# processed in several blocks and, with OpenMP, by several threads,
+# and compares them to the analytic result for free particles.
+source "tests_common.tcl"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase correlation_large.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+set epsilon 1e-8
+
+if { [catch {
+    setmd box_l 10 10 10
+    setmd time_step 0.01
+    setmd skin 0.5
+    thermostat off
+
+    # 1200 components, more than two blocks of 512, and with 17 lags
+    # per level enough values for the threaded update
+    set n_part 400
+    for { set i 0 } { $i < $n_part } { incr i } {
+	set V($i) [list [expr 0.1*($i % 7) - 0.3] [expr 0.05*($i % 5) + 0.1] [expr -0.02*($i % 11)]]
+	part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] \
+	    v [lindex $V($i) 0] [lindex $V($i) 1] [lindex $V($i) 2]
+    }
+
+    set vel [observable new particle_velocities all]
+    set pos [observable new particle_positions all]
+    set c_vel [correlation new obs1 $vel corr_operation componentwise_product \
+		   dt 0.01 tau_lin 16 tau_max 1]
+    set c_pos [correlation new obs1 $pos corr_operation square_distance_componentwise \
+		   dt 0.01 tau_lin 16 tau_max 1]
+    correlation $c_vel autoupdate start
+    correlation $c_pos autoupdate start
+    integrate 300
+
+    foreach c [list $c_vel $c_pos] what {componentwise_product square_distance_componentwise} {
+	set res [correlation $c print]
+	foreach row $res {
+	    set t [lindex $row 0]
+	    if { [lindex $row 1] == 0 } { continue }
+	    if { [llength $row] != 3*$n_part + 2 } {
+		error "$what: [expr [llength $row] - 2] components instead of [expr 3*$n_part]"
+	    }
+	    for { set i 0 } { $i < $n_part } { incr i } {
+		for { set k 0 } { $k < 3 } { incr k } {
+		    set v [lindex $V($i) $k]
+		    if { $what == "componentwise_product" } {
+			set ref [expr $v*$v]
+		    } {
+			set ref [expr $v*$v*$t*$t]
+		    }
+		    set val [lindex $row [expr 2 + 3*$i + $k]]
+		    if { abs($val - $ref) > $epsilon*(1 + abs($ref)) } {
+			error "$what: component [expr 3*$i + $k] at tau $t is $val instead of $ref"
+		    }
+		}
+	    }
+	}
+	puts "$what: [llength $res] lags ok"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,125 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the thermostats with the counter based random numbers
+# (thermostat rng counter) give the same trajectory independent of the
+# order and the distribution of the particles, and that the Langevin
+# thermostat still reaches the right temperature.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase counter_rng.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+set n_part 300
+
+proc setup {reverse} {
+    global n_part pos
+    part deleteall
+    for { set k 0 } { $k < $n_part } { incr k } {
+	if { $reverse } { set i [expr $n_part - 1 - $k] } { set i $k }
+	part $i pos [lindex $pos($i) 0] [lindex $pos($i) 1] [lindex $pos($i) 2] v 0 0 0
+    }
+    thermostat rng counter 4711 -step 0
+}
+
+proc compare {what} {
+    global n_part posref epsilon
+    set maxd 0
+    for { set i 0 } { $i < $n_part } { incr i } {
+	set d [veclen [vecsub [part $i pr pos] $posref($i)]]
+	if { $d > $maxd } { set maxd $d }
+    }
+    puts "$what: maximal deviation $maxd"
+    if { $maxd > $epsilon } {
+	error "$what: trajectories differ by $maxd"
+    }
+}
+
+if { [catch {
+    setmd box_l 8 8 8
+    setmd time_step 0.01
+    setmd skin 0.3
+    expr srand(17)
+    for { set i 0 } { $i < $n_part } { incr i } {
+	set pos($i) [list [expr 8*rand()] [expr 8*rand()] [expr 8*rand()]]
+    }
+    inter 0 0 lennard-jones 1.0 1.0 1.12246 0.25 0
+    inter forcecap 20
+
+    # Langevin with domain decomposition in the insertion order as reference
+    thermostat langevin 1.0 1.0
+    cellsystem domain_decomposition
+    setup 0
+    integrate 100
+    for { set i 0 } { $i < $n_part } { incr i } { set posref($i) [part $i pr pos] }
+
+    # reverse order, and different distribution over the nodes
+    cellsystem nsquare
+    setup 1
+    integrate 100
+    compare "langevin"
+
+    if { [has_feature "DPD"] } {
+	thermostat off
+	thermostat dpd 1.0 2.0 1.2
+	cellsystem domain_decomposition
+	setup 0
+	integrate 100
+	for { set i 0 } { $i < $n_part } { incr i } { set posref($i) [part $i pr pos] }
+	cellsystem nsquare
+	setup 1
+	integrate 100
+	compare "dpd"
+	thermostat off
+    }
+
+    # the temperature of an ideal gas
+    inter forcecap 0
+    inter 0 0 lennard-jones 0 1.0 1.12246 0.25 0
+    thermostat off
+    thermostat langevin 1.0 1.0
+    cellsystem domain_decomposition
+    setup 0
+    integrate 500
+    set temp 0
+    set samples 200
+    for { set s 0 } { $s < $samples } { incr s } {
+	integrate 10
+	for { set i 0 } { $i < $n_part } { incr i } {
+	    set temp [expr $temp + pow([veclen [part $i pr v]],2)/(3*$n_part)]
+	}
+    }
+    set temp [expr $temp/$samples]
+    puts "temperature $temp"
+    if { abs($temp - 1.0) > 0.05 } {
+	error "temperature $temp instead of 1.0"
+    }
+
+    # switch back
+    thermostat rng sequential
+    if { [setmd rng_counter_mask] != 0 } {
+	error "counter based generator still active"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,151 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks the packed SoA force loop of the domain decomposition
+# (cellsystem domain_decomposition -soa) against the reference
+# forces of lj.tcl and against the normal force loop during a short
+# run with Verlet lists.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase lj_soa.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-4
+thermostat off
+setmd time_step 1
+setmd skin 0
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+proc check_forces {ref what} {
+    global epsilon
+    upvar $ref F
+    set maxd 0
+    set maxp 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set resF [part $i pr f]
+	for { set k 0 } { $k < 3 } { incr k } {
+	    set d [expr abs([lindex $resF $k] - [lindex $F($i) $k])]
+	    if { $d > $maxd } {
+		set maxd $d
+		set maxp $i
+	    }
+	}
+    }
+    puts "$what: maximal force deviation $maxd for particle $maxp"
+    if { $maxd > $epsilon } {
+	error "$what: force of particle $maxp: [part $maxp pr f] != $F($maxp)"
+    }
+}
+
+if { [catch {
+    read_data "lj_system.data"
+
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set F($i) [part $i pr f]
+	set pos($i) [part $i pr pos]
+    }
+
+    inter 0 0 lennard-jones 1.0 1.0 1.12246
+    inter 1 1 lennard-jones 1.3 0.5 2 auto 0.0
+    inter 0 1 lennard-jones 2.2 1.0 1.12246 0.0 0.5
+
+    # static forces, with and without Verlet lists
+    cellsystem domain_decomposition -soa
+    integrate 0
+    check_forces F "soa, verlet lists"
+
+    # energies are calculated by the linked cell loops while the SoA
+    # kernel has its own verlet lists
+    set rel_eng_error [expr abs(([analyze energy total] - $energy)/$energy)]
+    puts "relative energy deviations: $rel_eng_error"
+    if { $rel_eng_error > $epsilon } {
+	error "relative energy error too large"
+    }
+
+    cellsystem domain_decomposition -no_verlet_list -soa
+    integrate 0
+    check_forces F "soa, linked cells"
+
+    # short capped run with the normal force loop as reference
+    inter forcecap 20
+    setmd time_step 0.001
+    setmd skin 0.2
+    cellsystem domain_decomposition
+    integrate 20
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set Fref($i) [part $i pr f]
+	part $i pos [lindex $pos($i) 0] [lindex $pos($i) 1] [lindex $pos($i) 2] v 0 0 0
+    }
+
+    cellsystem domain_decomposition -soa
+    integrate 20
+    check_forces Fref "soa, 20 steps"
+
+    # plain LJ without offset or capping takes a separate code path
+    inter forcecap 0
+    inter 0 1 lennard-jones 2.2 1.0 1.12246 auto 0.0
+    cellsystem domain_decomposition
+    integrate 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set Fplain($i) [part $i pr f]
+    }
+    cellsystem domain_decomposition -soa
+    integrate 0
+    check_forces Fplain "soa, plain lj"
+
+    # the local stress tensor walks the normal verlet lists, which the
+    # SoA kernel only builds on demand
+    set box [setmd box_l]
+    cellsystem domain_decomposition
+    integrate 0
+    set ref [lindex [lindex [analyze local_stress_tensor 1 1 1 0 0 0 \
+			       [lindex $box 0] [lindex $box 1] [lindex $box 2] 1 1 1] 1] 1]
+    cellsystem domain_decomposition -soa
+    integrate 0
+    set res [lindex [lindex [analyze local_stress_tensor 1 1 1 0 0 0 \
+			       [lindex $box 0] [lindex $box 1] [lindex $box 2] 1 1 1] 1] 1]
+    for { set k 0 } { $k < 9 } { incr k } {
+	set d [expr abs([lindex $res $k] - [lindex $ref $k])]
+	if { $d > $epsilon*abs([lindex $ref $k]) + $epsilon } {
+	    error "soa: local stress tensor $res != $ref"
+	}
+    }
+
+    # two particles at the same position do not interact
+    set p0 [part 0 pr pos]
+    part [expr [setmd max_part] + 1] pos [lindex $p0 0] [lindex $p0 1] [lindex $p0 2] type 0
+    cellsystem domain_decomposition
+    integrate 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set Foverlap($i) [part $i pr f]
+    }
+    cellsystem domain_decomposition -soa
+    integrate 0
+    check_forces Foverlap "soa, plain lj, overlapping particles"
+} res ] } {
+    error_exit $res
+}
+
+exit 0
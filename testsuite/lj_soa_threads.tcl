@@ -0,0 +1,81 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the threaded SoA force loop is bitwise reproducible for
+# a fixed number of threads: the same short run is done twice and the
+# forces and positions have to agree exactly. The number of threads
+# is taken from OMP_NUM_THREADS, which has to be larger than 1.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase lj_soa_threads.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+if { ![info exists env(OMP_NUM_THREADS)] || $env(OMP_NUM_THREADS) < 2 } {
+    puts "OMP_NUM_THREADS is not larger than 1, nothing to test"
+    ignore_exit
+}
+puts "running with $env(OMP_NUM_THREADS) threads per process"
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+# the same run from scratch, so that the particles are stored in the
+# same order
+proc run {} {
+    part deleteall
+    read_data "lj_system.data"
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	part $i v 0 0 0
+    }
+    integrate 20
+    set res {}
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	lappend res [part $i pr pos f]
+    }
+    return $res
+}
+
+if { [catch {
+    read_data "lj_system.data"
+    thermostat off
+    setmd time_step 0.001
+    setmd skin 0.2
+    inter 0 0 lennard-jones 1.0 1.0 1.12246
+    inter 1 1 lennard-jones 1.3 0.5 2 auto 0.0
+    inter 0 1 lennard-jones 2.2 1.0 1.12246 0.0 0.5
+    inter forcecap 20
+    cellsystem domain_decomposition -soa
+
+    set first [run]
+    set second [run]
+    for { set i 0 } { $i < [llength $first] } { incr i } {
+	if { [lindex $first $i] ne [lindex $second $i] } {
+	    error "particle $i: [lindex $second $i] != [lindex $first $i]"
+	}
+    }
+    puts "[llength $first] particles agree bitwise"
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,115 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the dynamic load balancing of the domain decomposition
+# (setmd balance_interval) does not change the trajectory. The particles
+# only fill half of the box, so that the nodes with the dense half have
+# more work, and the domain boundaries are moved.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase load_balance.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-6
+
+proc setup {} {
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	part $i pos [lindex $::pos($i) 0] [lindex $::pos($i) 1] [lindex $::pos($i) 2] v 0 0 0
+    }
+}
+
+if { [catch {
+    setmd box_l 12 12 12
+    setmd time_step 0.002
+    setmd skin 0.3
+    thermostat off
+    cellsystem domain_decomposition -no_verlet_list
+
+    # a perturbed lattice in one half of the box
+    expr srand(42)
+    set i 0
+    for { set x 0 } { $x < 6 } { incr x } {
+	for { set y 0 } { $y < 12 } { incr y } {
+	    for { set z 0 } { $z < 12 } { incr z } {
+		set pos($i) [list [expr $x + 0.1*rand()] [expr $y + 0.1*rand()] [expr $z + 0.1*rand()]]
+		part $i pos 0 0 0
+		incr i
+	    }
+	}
+    }
+    inter 0 0 lennard-jones 1.0 1.0 2.5 auto 0
+    inter forcecap 50
+
+    # reference with equal domains
+    setup
+    integrate 200
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set posref($i) [part $i pr pos]
+	set Fref($i) [part $i pr f]
+    }
+
+    setup
+    setmd balance_interval 10
+    integrate 200
+    set imbalance [setmd load_imbalance]
+    puts "load imbalance $imbalance, local box [setmd local_box_l]"
+    if { $imbalance < 1 } {
+	error "load imbalance $imbalance is smaller than 1"
+    }
+
+    set maxd 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+	set dp [veclen [vecsub [part $i pr pos] $posref($i)]]
+	set df [veclen [vecsub [part $i pr f] $Fref($i)]]
+	if { $dp > $maxd } { set maxd $dp }
+	if { $dp > $epsilon || $df > 100*$epsilon } {
+	    error "particle $i at [part $i pr pos] with force [part $i pr f] instead of $posref($i), $Fref($i)"
+	}
+    }
+    puts "maximal position deviation $maxd"
+
+    # switching off restores the equal domains
+    setmd balance_interval 0
+    integrate 10
+    setup
+    integrate 0
+
+    # as does switching on a method that needs them, before it is set up
+    if { [has_feature "LB"] } {
+	setup
+	setmd balance_interval 10
+	integrate 200
+	puts "local box [setmd local_box_l] before setting up the fluid"
+	lbfluid cpu agrid 1 dens 1 visc 1 tau 0.002 friction 1
+	set box [setmd box_l]
+	set grid [setmd node_grid]
+	set lbox [setmd local_box_l]
+	for { set d 0 } { $d < 3 } { incr d } {
+	    if { abs([lindex $lbox $d] - [lindex $box $d]/[lindex $grid $d]) > $epsilon } {
+		error "local box $lbox is not regular after switching on LB"
+	    }
+	}
+	integrate 10
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,165 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the particle observables, which are accumulated on the
+# nodes that hold the particles and summed up on the master, agree
+# with the particle properties seen from the script.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase observable_dist.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+
+proc check_obs {obs ref what} {
+    global epsilon
+    set res [observable $obs print]
+    if { [llength $res] != [llength $ref] } {
+	error "$what: [llength $res] values instead of [llength $ref]"
+    }
+    foreach a $ref b $res {
+	if { abs($a - $b) > $epsilon*(1 + abs($a)) } {
+	    error "$what: $b instead of $a"
+	}
+    }
+    puts "$what: ok"
+}
+
+if { [catch {
+    setmd box_l 10 10 10
+    setmd time_step 0.01
+    setmd skin 0.4
+    thermostat off
+    cellsystem domain_decomposition
+
+    set n_part 200
+    expr srand(42)
+    for { set i 0 } { $i < $n_part } { incr i } {
+	part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] \
+	    v [expr rand()-0.5] [expr rand()-0.5] [expr rand()-0.5] type [expr $i % 2]
+	if { [has_feature "MASS"] } {
+	    part $i mass [expr 1 + rand()]
+	}
+    }
+    inter 0 0 lennard-jones 1.0 1.0 2.5 auto 0
+    inter forcecap 10
+    # calculate the forces without moving the particles
+    integrate 0
+
+    # take every fourth particle, such that the ids are spread over the nodes
+    set ids {}
+    for { set i 0 } { $i < $n_part } { incr i 4 } {
+	lappend ids $i
+    }
+    set blocksize 5
+    set n_blocks [expr [llength $ids]/$blocksize]
+
+    set pos {}
+    set vel {}
+    set force {}
+    for { set b 0 } { $b < $n_blocks } { incr b } {
+	set m($b) 0
+	foreach q {pos vel force} { set sum_$q\($b) {0 0 0} }
+    }
+    set k 0
+    foreach i $ids {
+	set b [expr $k/$blocksize]
+	set mass [expr [has_feature "MASS"] ? [part $i print mass] : 1]
+	set p [part $i print pos]
+	set v [part $i print v]
+	# unlike part print f, the force observables do not include the mass
+	set f {}
+	foreach c [part $i print f] {
+	    lappend f [expr $c/$mass]
+	}
+	eval lappend pos $p
+	eval lappend vel $v
+	eval lappend force $f
+	set m($b) [expr $m($b) + $mass]
+	foreach d {0 1 2} {
+	    lset sum_pos($b) $d [expr [lindex $sum_pos($b) $d] + $mass*[lindex $p $d]]
+	    lset sum_vel($b) $d [expr [lindex $sum_vel($b) $d] + $mass*[lindex $v $d]]
+	    lset sum_force($b) $d [expr [lindex $sum_force($b) $d] + [lindex $f $d]]
+	}
+	incr k
+    }
+    set com_pos {}
+    set com_vel {}
+    set com_force {}
+    for { set b 0 } { $b < $n_blocks } { incr b } {
+	foreach d {0 1 2} {
+	    lappend com_pos [expr [lindex $sum_pos($b) $d]/$m($b)]
+	    lappend com_vel [expr [lindex $sum_vel($b) $d]/$m($b)]
+	    lappend com_force [lindex $sum_force($b) $d]
+	}
+    }
+
+    check_obs [observable new particle_positions id $ids] $pos "particle_positions"
+    check_obs [observable new particle_velocities id $ids] $vel "particle_velocities"
+    check_obs [observable new particle_forces id $ids] $force "particle_forces"
+    check_obs [observable new com_position id $ids blocked $blocksize] $com_pos "blocked com_position"
+    check_obs [observable new com_velocity id $ids blocked $blocksize] $com_vel "blocked com_velocity"
+    check_obs [observable new com_force id $ids blocked $blocksize] $com_force "blocked com_force"
+    check_obs [observable new com_position id [lrange $ids 0 [expr $blocksize-1]]] \
+	[lrange $com_pos 0 2] "com_position"
+
+    # repeated calculations must not accumulate
+    set obs [observable new com_velocity id $ids blocked $blocksize]
+    observable $obs print
+    check_obs $obs $com_vel "blocked com_velocity, second calculation"
+
+    # the positions are unfolded, also after the particles crossed the box
+    integrate 200
+    set pos {}
+    foreach i $ids {
+	eval lappend pos [part $i print pos]
+    }
+    check_obs [observable new particle_positions id $ids] $pos "particle_positions after integration"
+
+    # density profile of all particles of type 0 in 2x2x2 bins
+    set bin_volume [expr 1000.0/8]
+    set type0 {}
+    set dens {0 0 0 0 0 0 0 0}
+    for { set i 0 } { $i < $n_part } { incr i 2 } {
+	lappend type0 $i
+	set p [part $i print folded_position]
+	set bin 0
+	foreach d {0 1 2} {
+	    set bin [expr 2*$bin + int([lindex $p $d]/5.0)]
+	}
+	lset dens $bin [expr [lindex $dens $bin] + 1/$bin_volume]
+    }
+    check_obs [observable new density_profile ids $type0 xbins 2 ybins 2 zbins 2] $dens "density_profile"
+
+    # particles deleted after setting up the observables are an error
+    set obs [observable new particle_positions id {2 3}]
+    set obs_com [observable new com_velocity id {2 3 4 5} blocked 2]
+    part 3 delete
+    if { ![catch { observable $obs print }] } {
+	error "particle_positions of a deleted particle did not fail"
+    }
+    if { ![catch { observable $obs_com print }] } {
+	error "com_velocity of a deleted particle did not fail"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
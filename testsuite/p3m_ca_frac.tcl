@@ -0,0 +1,74 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that storing and recomputing the charge assignment fractions
+# (inter coulomb ca_frac) give the same P3M forces.
+source "tests_common.tcl"
+
+require_feature "ELECTROSTATICS"
+require_feature "FFTW"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase p3m_ca_frac.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+set epsilon 1e-10
+thermostat off
+setmd time_step 0.01
+setmd skin 0.05
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+proc check_forces {what} {
+    global epsilon F
+    set maxdf 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+        set df [veclen [vecsub [part $i pr f] $F($i)]]
+        if { $df > $maxdf } { set maxdf $df }
+    }
+    puts "$what: maximal force deviation $maxdf"
+    if { $maxdf > $epsilon } {
+        error "$what: forces differ by $maxdf from the stored fractions"
+    }
+}
+
+if { [catch {
+    read_data "p3m_system.data"
+
+    foreach n_interpol {32768 0} {
+        inter coulomb n_interpol $n_interpol ca_frac store
+        integrate 0
+        for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+            set F($i) [part $i pr f]
+        }
+
+        inter coulomb ca_frac recompute
+        if { [lsearch [lindex [inter coulomb] 1] "recompute"] == -1 } {
+            error "ca_frac recompute not set: [inter coulomb]"
+        }
+        integrate 0
+        check_forces "n_interpol $n_interpol"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,75 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that both communication schemes of the parallel FFT (inter
+# coulomb fft_comm) give the same P3M forces and energies.
+source "tests_common.tcl"
+
+require_feature "ELECTROSTATICS"
+require_feature "FFTW"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase p3m_fft_comm.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+set epsilon 1e-10
+thermostat off
+setmd time_step 0.01
+setmd skin 0.05
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+if { [catch {
+    read_data "p3m_system.data"
+
+    inter coulomb fft_comm sendrecv
+    if { [lsearch [lindex [inter coulomb] 1] "sendrecv"] == -1 } {
+        error "fft_comm sendrecv not set: [inter coulomb]"
+    }
+    integrate 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+        set F($i) [part $i pr f]
+    }
+    set eng [lindex [analyze energy coulomb] 0]
+
+    inter coulomb fft_comm nonblocking
+    if { [lsearch [lindex [inter coulomb] 1] "nonblocking"] == -1 } {
+        error "fft_comm nonblocking not set: [inter coulomb]"
+    }
+    integrate 0
+    set maxdf 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+        set df [veclen [vecsub [part $i pr f] $F($i)]]
+        if { $df > $maxdf } { set maxdf $df }
+    }
+    puts "maximal force deviation $maxdf"
+    if { $maxdf > $epsilon } {
+        error "forces differ by $maxdf between the FFT communication schemes"
+    }
+    set deng [expr abs([lindex [analyze energy coulomb] 0] - $eng)]
+    if { $deng > $epsilon*abs($eng) } {
+        error "coulomb energy differs by $deng between the FFT communication schemes"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
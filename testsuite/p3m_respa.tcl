@@ -0,0 +1,80 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that calculating the P3M k-space forces only every
+# kspace_interval steps (setmd kspace_interval) gives the same
+# trajectory and energy conservation as calculating them every step.
+source "tests_common.tcl"
+
+require_feature "ELECTROSTATICS"
+require_feature "FFTW"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase p3m_respa.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+set epsilon 1e-4
+thermostat off
+setmd time_step 0.01
+setmd skin 0.5
+
+proc read_data {file} {
+    set f [open $file "r"]
+    while {![eof $f]} { blockfile $f read auto}
+    close $f
+}
+
+proc run {k} {
+    read_data "p3m_system.data"
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } { part $i v 0 0 0 }
+    setmd time 0
+    setmd kspace_interval $k
+    return [energy_drift 40 4]
+}
+
+if { [catch {
+    if { ![catch { setmd kspace_interval 0 }] } {
+        error "kspace_interval 0 was accepted"
+    }
+
+    set ref [run 1]
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+        set P($i) [part $i pr pos]
+    }
+
+    set res [run 4]
+    set maxdp 0
+    for { set i 0 } { $i <= [setmd max_part] } { incr i } {
+        set dp [veclen [vecsub [part $i pr pos] $P($i)]]
+        if { $dp > $maxdp } { set maxdp $dp }
+    }
+    puts "maximal position deviation $maxdp"
+    if { $maxdp > $epsilon } {
+        error "positions differ by $maxdp with kspace_interval 4"
+    }
+
+    puts "energy drift [lindex $ref 0] (kspace_interval 1), [lindex $res 0] (kspace_interval 4)"
+    set ddrift [expr abs([lindex $res 0] - [lindex $ref 0])]
+    if { $ddrift > 0.01*abs([lindex $ref 0]) + $epsilon } {
+        error "energy drift [lindex $res 0] with kspace_interval 4 instead of [lindex $ref 0]"
+    }
+    setmd kspace_interval 1
+} res ] } {
+    error_exit $res
+}
+
+exit 0
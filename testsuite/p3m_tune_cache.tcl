@@ -0,0 +1,94 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the P3M tuning reuses the parameters stored in the
+# tuning cache (tune_cache) for the same system, and warm starts
+# from them for a similar system.
+source "tests_common.tcl"
+
+require_feature "ELECTROSTATICS"
+require_feature "FFTW"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase p3m_tune_cache.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+set cache "p3m_tune_cache.tmp"
+file delete $cache
+
+setmd box_l 10 10 10
+setmd skin 0.3
+setmd time_step 0.01
+thermostat off
+expr srand(17)
+
+for { set i 0 } { $i < 200 } { incr i } {
+    part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] q [expr $i % 2 ? -1 : 1]
+}
+
+# tunes from scratch, like in a new run
+proc tune {accuracy} {
+    return [inter coulomb 1.0 p3m tune accuracy $accuracy r_cut 0 mesh 0 cao 0]
+}
+
+if { [catch {
+    if { [tune_cache $cache] != $cache } {
+        error "tune_cache does not report $cache"
+    }
+
+    set log [tune 1e-3]
+    if { [string first "cached" $log] != -1 } {
+        error "first tuning used the empty cache: $log"
+    }
+    set params [inter coulomb]
+
+    # same system, the parameters are taken from the cache
+    set log [tune 1e-3]
+    if { [string first "using cached parameters" $log] == -1 } {
+        error "second tuning did not use the cache: $log"
+    }
+    if { [inter coulomb] != $params } {
+        error "cached parameters [inter coulomb] differ from tuned $params"
+    }
+
+    # a slightly smaller system, the tuning starts from the cached parameters
+    for { set i 180 } { $i < 200 } { incr i } { part $i delete }
+    set log [tune 1e-3]
+    if { [string first "warm start" $log] == -1 } {
+        error "tuning of a similar system did not warm start: $log"
+    }
+
+    # a different accuracy has to be tuned from scratch
+    set log [tune 1e-4]
+    if { [string first "cached" $log] != -1 } {
+        error "tuning for another accuracy used the cache: $log"
+    }
+
+    if { [tune_cache off] != "off" } {
+        error "tune_cache could not be switched off"
+    }
+    set log [tune 1e-3]
+    if { [string first "cached" $log] != -1 } {
+        error "switched off cache was used: $log"
+    }
+    file delete $cache
+} res ] } {
+    file delete $cache
+    error_exit $res
+}
+
+exit 0
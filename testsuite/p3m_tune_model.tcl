@@ -0,0 +1,86 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the P3M tuning with the cost model (p3m tunemodel) finds
+# parameters that reach the accuracy, and that once the model is
+# calibrated, it tunes without any timing.
+source "tests_common.tcl"
+
+require_feature "ELECTROSTATICS"
+require_feature "FFTW"
+
+puts "---------------------------------------------------------------"
+puts "- Testcase p3m_tune_model.tcl running on [format %02d [setmd n_nodes]] nodes"
+puts "---------------------------------------------------------------"
+
+setmd box_l 10 10 10
+setmd skin 0.3
+setmd time_step 0.01
+thermostat off
+expr srand(17)
+
+for { set i 0 } { $i < 200 } { incr i } {
+    part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] q [expr $i % 2 ? -1 : 1]
+}
+
+proc check_accuracy {accuracy} {
+    set reached [lindex [lindex [inter coulomb] 0] 7]
+    if { $reached > $accuracy } {
+        error "tuned accuracy $reached does not reach $accuracy"
+    }
+}
+
+if { [catch {
+    # first tuning calibrates the cost model with a few timings
+    set log [inter coulomb 1.0 p3m tunemodel accuracy 1e-3 r_cut 0 mesh 0 cao 0]
+    if { [string first "cost model" $log] == -1 } {
+        error "tuning did not report the cost model: $log"
+    }
+    check_accuracy 1e-3
+    integrate 0
+
+    # with the calibrated model and without confirmation, nothing is timed
+    set log [inter coulomb 1.0 p3m tunemodel accuracy 1e-4 r_cut 0 mesh 0 cao 0 confirm 0]
+    set lines [split $log "\n"]
+    set header [lsearch -glob $lines "mesh cao*"]
+    if { ![string match "cost model*" [lindex $lines [expr $header + 1]]] } {
+        error "calibrated tuning timed parameter sets: $log"
+    }
+    check_accuracy 1e-4
+    integrate 0
+
+    # the fixed parameters are kept
+    inter coulomb 1.0 p3m tunemodel accuracy 1e-3 r_cut 0 mesh 16 cao 5 confirm 1
+    set p [lindex [inter coulomb] 0]
+    if { [join [lindex $p 4]] != "16 16 16" || [lindex $p 5] != 5 } {
+        error "fixed mesh and cao not kept: $p"
+    }
+    check_accuracy 1e-3
+
+    # a fixed odd mesh is rejected, as by the adaptive tuning
+    if { ![catch { inter coulomb 1.0 p3m tunemodel accuracy 1e-3 r_cut 0 mesh 15 cao 0 confirm 1 }] } {
+        error "fixed odd mesh 15 did not fail"
+    }
+
+    if { ![catch { inter coulomb 1.0 p3m tunemodel accuracy 1e-3 confirm -1 }] } {
+        error "negative confirm did not fail"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
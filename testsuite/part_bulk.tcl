@@ -0,0 +1,174 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that setting particle properties with part bulk gives the
+# same particles as setting them one by one, and that part bulk print
+# gives the same output as part print.
+source "tests_common.tcl"
+
+puts "----------------------------------------"
+puts "- Testcase part_bulk.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-12
+setmd box_l 10 10 10
+setmd skin 0.3
+setmd time_step 0.01
+thermostat off
+expr srand(42)
+
+proc check_prop {prop ref} {
+    global epsilon
+    upvar $ref R
+    foreach i [array names R] {
+        set res [part $i print $prop]
+        foreach a $res b $R($i) {
+            if { abs($a - $b) > $epsilon } {
+                error "$prop of particle $i is $res instead of $R($i)"
+            }
+        }
+    }
+}
+
+if { [catch {
+    # a few gaps in the identities, and positions all over the box
+    set n 200
+    set ids {}
+    set pos {}
+    set v {}
+    set type {}
+    for { set i 0 } { $i < $n } { incr i } {
+        set id [expr 3*$i + ($i % 2)]
+        lappend ids $id
+        set P($id) [list [expr 10*rand()] [expr 10*rand()] [expr 10*rand()]]
+        set V($id) [list [expr rand()-0.5] [expr rand()-0.5] [expr rand()-0.5]]
+        set T($id) [expr $i % 3]
+        eval lappend pos $P($id)
+        eval lappend v $V($id)
+        lappend type $T($id)
+    }
+
+    part bulk pos $ids $pos
+    if { [setmd n_part] != $n } {
+        error "[setmd n_part] particles instead of $n"
+    }
+    if { [setmd max_part] != [lindex $ids end] } {
+        error "max_part is [setmd max_part] instead of [lindex $ids end]"
+    }
+    check_prop pos P
+
+    part bulk v $ids $v
+    check_prop v V
+    part bulk type $ids $type
+    check_prop type T
+
+    # moving existing particles, and setting only some of them
+    set sub [lrange $ids 10 49]
+    set pos {}
+    foreach id $sub {
+        set P($id) [list [expr 10*rand()] [expr 10*rand()] [expr 10*rand()]]
+        eval lappend pos $P($id)
+    }
+    part bulk pos $sub $pos
+    if { [setmd n_part] != $n } {
+        error "moving created particles, [setmd n_part] instead of $n"
+    }
+    check_prop pos P
+    check_prop v V
+
+    if { [has_feature "ELECTROSTATICS"] } {
+        set q {}
+        foreach id $ids {
+            set Q($id) [expr $id % 2 ? -1.0 : 1.0]
+            lappend q $Q($id)
+        }
+        part bulk q $ids $q
+        check_prop q Q
+    }
+    if { [has_feature "MASS"] } {
+        set m {}
+        foreach id $ids {
+            set M($id) [expr 1 + $id % 5]
+            lappend m $M($id)
+        }
+        part bulk mass $ids $m
+        check_prop mass M
+    }
+
+    # errors leave the particles untouched
+    if { ![catch { part bulk v [list 0 1] {1 2 3 4 5 6} }] } {
+        error "setting a nonexisting particle did not fail"
+    }
+    if { ![catch { part bulk v [list 0] {1 2} }] } {
+        error "wrong number of values did not fail"
+    }
+    check_prop v V
+
+    # the bulk particles integrate like the ones set individually
+    inter 0 0 lennard-jones 0.1 1.0 1.12246 auto 0
+    inter 1 1 lennard-jones 0.1 1.0 1.12246 auto 0
+    inter 0 2 lennard-jones 0.1 1.0 1.12246 auto 0
+    inter forcecap 10
+    integrate 10
+    foreach id $ids {
+        set P2($id) [part $id print pos]
+        set V2($id) [part $id print v]
+    }
+    part deleteall
+    foreach id $ids {
+        part $id pos [lindex $P($id) 0] [lindex $P($id) 1] [lindex $P($id) 2] \
+            v [lindex $V($id) 0] [lindex $V($id) 1] [lindex $V($id) 2] type $T($id)
+        if { [has_feature "ELECTROSTATICS"] } { part $id q $Q($id) }
+        if { [has_feature "MASS"] } { part $id mass $M($id) }
+    }
+    integrate 10
+    set epsilon 1e-8
+    check_prop pos P2
+    check_prop v V2
+
+    # gathering selected properties of many particles
+    set fields "id pos v f type"
+    if { [has_feature "ELECTROSTATICS"] } { lappend fields q }
+    if { [has_feature "MASS"] } { lappend fields mass }
+    set res [eval [list part bulk print all] $fields]
+    if { [llength $res] != $n } {
+        error "part bulk print all returned [llength $res] instead of $n particles"
+    }
+    foreach id $ids r $res {
+        set ref [eval [list part $id print] $fields]
+        if { $r != $ref } {
+            error "part bulk print gives $r instead of $ref"
+        }
+    }
+    # nonexisting particles, duplicates and arbitrary order
+    set sub [list [lindex $ids 5] 2 [lindex $ids 0] [lindex $ids 5] [expr [lindex $ids end] + 1]]
+    set res [part bulk print $sub type pos]
+    foreach id $sub r $res {
+        if { [lsearch $ids $id] == -1 } {
+            if { $r != "na" } { error "nonexisting particle $id gives $r" }
+        } elseif { $r != [part $id print type pos] } {
+            error "part bulk print gives $r instead of [part $id print type pos]"
+        }
+    }
+    if { ![catch { part bulk print all bonds }] } {
+        error "unsupported property did not fail"
+    }
+} res ] } {
+    error_exit $res
+}
+
+exit 0
@@ -0,0 +1,90 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the radial distribution functions histogrammed on the
+# nodes from the domain decomposition cells agree with the ones
+# calculated from the particle configuration on the master, which is
+# used for the N-squared cell system.
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase rdf_dist.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+
+proc check_rdf {ref res what} {
+    global epsilon
+    foreach r [lindex $ref end] s [lindex $res end] {
+	if { abs([lindex $r 1] - [lindex $s 1]) > $epsilon } {
+	    error "$what: g([lindex $r 0]) = [lindex $s 1] instead of [lindex $r 1]"
+	}
+    }
+    puts "$what: ok"
+}
+
+if { [catch {
+    setmd box_l 10 10 10
+    setmd time_step 0.01
+    setmd skin 0.4
+    thermostat off
+
+    expr srand(42)
+    for { set i 0 } { $i < 1000 } { incr i } {
+	part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] type [expr $i % 3]
+    }
+    # the cells have to reach up to r_max
+    inter 0 0 lennard-jones 1.0 1.0 2.5 auto 0
+    inter forcecap 10
+
+    set rdfs {
+	{ {0} {0} 0.5 2.0 15 }
+	{ {0 1} {0 1} 0.0 2.0 20 }
+	{ {0} {1 2} 0.1 2.0 19 }
+	{ {0 0} {1} 0.2 2.0 18 }
+    }
+
+    cellsystem nsquare
+    foreach p $rdfs {
+	lappend ref [eval analyze rdf $p]
+    }
+    set obs_ref [observable [observable new rdf 0 1 0.2 2.0 18] print]
+
+    cellsystem domain_decomposition
+    foreach p $rdfs r $ref {
+	check_rdf $r [eval analyze rdf $p] "rdf $p"
+    }
+    set obs [observable [observable new rdf 0 1 0.2 2.0 18] print]
+    foreach a $obs_ref b $obs {
+	if { abs($a - $b) > $epsilon } {
+	    error "observable rdf: $b instead of $a"
+	}
+    }
+    puts "observable rdf: ok"
+
+    # particles moved since the last resort
+    integrate 5
+    set ref [analyze rdf 0 0 0.5 2.0 15]
+    cellsystem nsquare
+    check_rdf [analyze rdf 0 0 0.5 2.0 15] $ref "rdf after integration"
+} res ] } {
+    error_exit $res
+}
+
+exit 0
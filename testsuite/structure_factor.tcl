@@ -0,0 +1,65 @@
+# Copyright (C) 2010,2011,2012,2013,2014 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks that the structure factor calculated from the density mesh
+# (analyze structurefactor ... mesh) agrees with the direct sum over
+# the wave vectors.
+source "tests_common.tcl"
+
+require_feature "FFTW"
+
+puts "----------------------------------------"
+puts "- Testcase structure_factor.tcl running on [format %02d [setmd n_nodes]] nodes: -"
+puts "----------------------------------------"
+
+proc check_sf {ref res epsilon what} {
+    if { [llength $ref] != [llength $res] } {
+	error "$what: [llength $res] wave vector shells instead of [llength $ref]"
+    }
+    set maxd 0
+    foreach r $ref s $res {
+	set d [expr abs([lindex $r 1] - [lindex $s 1])/[lindex $r 1]]
+	if { $d > $maxd } { set maxd $d }
+	if { abs([lindex $r 0] - [lindex $s 0]) > 1e-6 || $d > $epsilon } {
+	    error "$what: S([lindex $s 0]) = [lindex $s 1] instead of [lindex $r 1]"
+	}
+    }
+    puts "$what: maximal relative deviation $maxd"
+}
+
+if { [catch {
+    setmd box_l 10 10 10
+    setmd skin 0.3
+    expr srand(42)
+    for { set i 0 } { $i < 1000 } { incr i } {
+	part $i pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()] type [expr $i % 2]
+    }
+
+    set ref [analyze structurefactor 0 6]
+    check_sf $ref [analyze structurefactor 0 6 mesh] 1e-3 "default mesh"
+    check_sf $ref [analyze structurefactor 0 6 mesh 16 5] 5e-2 "mesh 16, cao 5"
+
+    # particles outside of the box
+    for { set i 0 } { $i < 1000 } { incr i 2 } {
+	eval part $i pos [vecadd [part $i pr pos] {10 -20 30}]
+    }
+    check_sf $ref [analyze structurefactor 0 6 mesh] 1e-3 "unfolded positions"
+} res ] } {
+    error_exit $res
+}
+
+exit 0